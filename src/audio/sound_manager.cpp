@@ -25,7 +25,20 @@
 #include "audio/dummy_sound_source.hpp"
 #include "audio/sound_file.hpp"
 #include "audio/stream_sound_source.hpp"
+#include "util/command_queue.hpp"
 #include "util/log.hpp"
+#include "util/worker_pool.hpp"
+
+namespace {
+
+/** Files with more samples than this are streamed instead of being
+    loaded into a buffer */
+const size_t MAX_BUFFERED_SIZE = 100000;
+
+/** Default size of the buffer cache */
+const size_t DEFAULT_BUFFER_BUDGET = 32 * 1024 * 1024;
+
+} // namespace
 
 SoundManager::SoundManager() :
   m_device(alcOpenDevice(nullptr)),
@@ -33,12 +46,23 @@ SoundManager::SoundManager() :
   m_sound_enabled(false),
   m_sound_volume(0),
   m_buffers(),
+  m_lru(),
+  m_buffer_bytes(0),
+  m_buffer_budget(DEFAULT_BUFFER_BUDGET),
+  m_pinned(),
+  m_cache_hits(0),
+  m_cache_misses(0),
+  m_cache_evictions(0),
+  m_preloading(),
+  m_decoded(),
+  m_decoded_mutex(),
   m_sources(),
   m_update_list(),
   m_music_source(),
   m_music_enabled(false),
   m_music_volume(0),
-  m_current_music()
+  m_current_music(),
+  m_workers(new WorkerPool(1))
 {
   try {
     if (m_device == nullptr) {
@@ -69,11 +93,12 @@ SoundManager::SoundManager() :
 
 SoundManager::~SoundManager()
 {
+  m_workers.reset();
   m_music_source.reset();
   m_sources.clear();
 
   for (const auto& buffer : m_buffers) {
-    alDeleteBuffers(1, &buffer.second);
+    alDeleteBuffers(1, &buffer.second.buffer);
   }
 
   if (m_context != nullptr) {
@@ -90,20 +115,23 @@ ALuint
 SoundManager::load_file_into_buffer(SoundFile& file)
 {
   ALenum format = get_sample_format(file);
+  std::unique_ptr<char[]> samples(new char[file.m_size]);
+  file.read(samples.get(), file.m_size);
+  return create_buffer(format, samples.get(), file.m_size, static_cast<ALsizei>(file.m_rate));
+}
+
+ALuint
+SoundManager::create_buffer(ALenum format, const char* samples, size_t size, ALsizei rate)
+{
   ALuint buffer;
   alGenBuffers(1, &buffer);
   check_al_error("Couldn't create audio buffer: ");
-  std::unique_ptr<char[]> samples(new char[file.m_size]);
-  file.read(samples.get(), file.m_size);
   log_debug << "buffer: " << buffer << "\n"
             << "format: " << format << "\n"
-            << "samples: " << samples.get() << "\n"
-            << "file size: " << static_cast<ALsizei>(file.m_size) << "\n"
-            << "file rate: " << static_cast<ALsizei>(file.m_rate) << "\n";
+            << "file size: " << static_cast<ALsizei>(size) << "\n"
+            << "file rate: " << rate << "\n";
 
-  alBufferData(buffer, format, samples.get(),
-               static_cast<ALsizei>(file.m_size),
-               static_cast<ALsizei>(file.m_rate));
+  alBufferData(buffer, format, samples, static_cast<ALsizei>(size), rate);
   check_al_error("Couldn't fill audio buffer: ");
 
   return buffer;
@@ -120,18 +148,19 @@ SoundManager::intern_create_sound_source(const std::string& filename)
   ALuint buffer;
 
   // reuse an existing static sound buffer
-  auto it = m_buffers.find(filename);
-  if (it != m_buffers.end()) {
-    buffer = it->second;
+  if (auto cached = find_buffer(filename)) {
+    m_cache_hits += 1;
+    buffer = cached->buffer;
   } else {
     // Load sound file
     std::unique_ptr<SoundFile> file(load_sound_file(filename));
 
-    if (file->m_size < 100000) {
+    if (file->m_size < MAX_BUFFERED_SIZE) {
       log_debug << "Adding \"" << filename <<
         "\" into the buffer, file size: " << file->m_size << std::endl;
+      m_cache_misses += 1;
       buffer = load_file_into_buffer(*file);
-      m_buffers.insert(std::make_pair(filename, buffer));
+      add_buffer(filename, buffer, file->m_size);
     } else {
       log_debug << "Playing \"" << filename <<
         "\" as StreamSoundSource, file size: " << file->m_size << std::endl;
@@ -166,20 +195,124 @@ SoundManager::preload(const std::string& filename)
   if (!m_sound_enabled)
     return;
 
-  auto it = m_buffers.find(filename);
-  // already loaded?
-  if (it != m_buffers.end())
+  // already loaded or on its way?
+  if (m_buffers.count(filename) || m_preloading.count(filename))
     return;
-  try {
-    std::unique_ptr<SoundFile> file (load_sound_file(filename));
-    // only keep small files
-    if (file->m_size >= 100000)
-      return;
 
-    ALuint buffer = load_file_into_buffer(*file);
-    m_buffers.insert(std::make_pair(filename, buffer));
-  } catch(std::exception& e) {
-    log_warning << "Error while preloading sound file: " << e.what() << std::endl;
+  m_preloading.insert(filename);
+  m_workers->add([this, filename]{
+      DecodedSound sound;
+      sound.filename = filename;
+      sound.format = AL_NONE;
+      sound.rate = 0;
+      try {
+        std::unique_ptr<SoundFile> file(load_sound_file(filename));
+        // only keep small files
+        if (file->m_size < MAX_BUFFERED_SIZE) {
+          sound.format = get_sample_format(*file);
+          sound.rate = static_cast<ALsizei>(file->m_rate);
+          sound.samples.resize(file->m_size);
+          file->read(sound.samples.data(), file->m_size);
+        }
+      } catch(std::exception& e) {
+        sound.error = e.what();
+      }
+
+      std::lock_guard<std::mutex> lock(m_decoded_mutex);
+      m_decoded.push_back(std::move(sound));
+    });
+}
+
+void
+SoundManager::pin(const std::string& filename)
+{
+  m_pinned.insert(filename);
+
+  auto it = m_buffers.find(filename);
+  if (it != m_buffers.end()) {
+    it->second.pinned = true;
+  } else {
+    preload(filename);
+  }
+}
+
+void
+SoundManager::set_buffer_budget(size_t bytes)
+{
+  m_buffer_budget = bytes;
+  trim_buffers();
+}
+
+SoundManager::CachedBuffer*
+SoundManager::find_buffer(const std::string& filename)
+{
+  auto it = m_buffers.find(filename);
+  if (it == m_buffers.end())
+    return nullptr;
+
+  m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+  return &it->second;
+}
+
+void
+SoundManager::add_buffer(const std::string& filename, ALuint buffer, size_t size)
+{
+  m_lru.push_front(filename);
+  m_buffers[filename] = CachedBuffer{buffer, size, m_pinned.count(filename) != 0, m_lru.begin()};
+  m_buffer_bytes += size;
+  trim_buffers();
+}
+
+void
+SoundManager::trim_buffers()
+{
+  auto it = m_lru.end();
+  while (m_buffer_bytes > m_buffer_budget && it != m_lru.begin()) {
+    --it;
+    // the most recently used buffer is the one that is about to be played
+    if (it == m_lru.begin())
+      break;
+
+    auto cached = m_buffers.find(*it);
+    if (cached->second.pinned)
+      continue;
+
+    // deleting fails while a source still uses the buffer, it stays
+    // in the cache and gets another chance later
+    alGetError();
+    alDeleteBuffers(1, &cached->second.buffer);
+    if (alGetError() != AL_NO_ERROR)
+      continue;
+
+    m_buffer_bytes -= cached->second.size;
+    m_buffers.erase(cached);
+    it = m_lru.erase(it);
+    m_cache_evictions += 1;
+  }
+}
+
+void
+SoundManager::upload_preloaded()
+{
+  std::vector<DecodedSound> decoded;
+  {
+    std::lock_guard<std::mutex> lock(m_decoded_mutex);
+    decoded.swap(m_decoded);
+  }
+
+  for (const auto& sound : decoded) {
+    m_preloading.erase(sound.filename);
+
+    if (!sound.error.empty()) {
+      log_warning << "Error while preloading sound file: " << sound.error << std::endl;
+    } else if (!sound.samples.empty() && !m_buffers.count(sound.filename)) {
+      try {
+        ALuint buffer = create_buffer(sound.format, sound.samples.data(), sound.samples.size(), sound.rate);
+        add_buffer(sound.filename, buffer, sound.samples.size());
+      } catch(std::exception& e) {
+        log_warning << "Error while preloading sound file: " << e.what() << std::endl;
+      }
+    }
   }
 }
 
@@ -194,6 +327,14 @@ SoundManager::play(const std::string& filename, const Vector& pos,
   // the value is set to min(sound_gain * sound_volume, 1)
   assert(gain >= 0.0f && gain <= 1.0f);
 
+  if (CommandQueue* queue = CommandQueue::current())
+  {
+    // Called from an object that is updated on a worker thread, OpenAL
+    // and the buffer cache are only touched from the main thread
+    queue->push([this, filename, pos, gain]{ play(filename, pos, gain); });
+    return;
+  }
+
   try {
     std::unique_ptr<OpenALSoundSource> source(intern_create_sound_source(filename));
     source->set_gain(gain);
@@ -317,8 +458,9 @@ SoundManager::play_music(const std::string& filename, float fadetime)
 
   try {
     auto newmusic = std::make_unique<StreamSoundSource>();
-    newmusic->set_sound_file(load_sound_file(filename));
+    // looping has to be known before the first fragment is decoded
     newmusic->set_looping(true);
+    newmusic->set_sound_file(load_sound_file(filename));
     newmusic->set_relative(true);
     newmusic->set_volume(static_cast<float>(m_music_volume) / 100.0f);
     if (fadetime > 0)
@@ -442,6 +584,10 @@ SoundManager::update()
     return;
   lasttime = now;
 
+  if (!m_preloading.empty()) {
+    upload_preloaded();
+  }
+
   // update and check for finished sound sources
   for (auto it = m_sources.begin(); it != m_sources.end(); ) {
     auto& source = *it;
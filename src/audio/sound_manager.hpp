@@ -17,8 +17,11 @@
 #ifndef HEADER_SUPERTUX_AUDIO_SOUND_MANAGER_HPP
 #define HEADER_SUPERTUX_AUDIO_SOUND_MANAGER_HPP
 
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -32,14 +35,41 @@ class SoundFile;
 class SoundSource;
 class StreamSoundSource;
 class OpenALSoundSource;
+class WorkerPool;
 
 class SoundManager final : public Currenton<SoundManager>
 {
   friend class OpenALSoundSource;
   friend class StreamSoundSource;
 
+private:
+  /** Decoded samples of a sound file, filled by a worker thread */
+  struct DecodedSound
+  {
+    std::string filename;
+    ALenum format;
+    ALsizei rate;
+    std::vector<char> samples;
+
+    /** empty on success */
+    std::string error;
+  };
+
+  struct CachedBuffer
+  {
+    ALuint buffer;
+    size_t size;
+
+    /** pinned buffers are never evicted */
+    bool pinned;
+
+    /** position in m_lru */
+    std::list<std::string>::iterator lru;
+  };
+
 private:
   static ALuint load_file_into_buffer(SoundFile& file);
+  static ALuint create_buffer(ALenum format, const char* samples, size_t size, ALsizei rate);
   static ALenum get_sample_format(const SoundFile& file);
 
   static void print_openal_version();
@@ -70,9 +100,25 @@ public:
       when it finished playing) */
   void manage_source(std::unique_ptr<SoundSource> source);
 
-  /** preloads a sound, so that you don't get a lag later when playing it */
+  /** preloads a sound, so that you don't get a lag later when playing
+      it. The file is decoded in the background, if it is played before
+      that is done it gets loaded right away. */
   void preload(const std::string& name);
 
+  /** Like preload(), but the sound is never evicted from the buffer
+      cache, use this for sounds that are played all the time */
+  void pin(const std::string& name);
+
+  /** Sets the number of bytes of samples that are kept in the buffer
+      cache, least recently used sounds are evicted when the cache
+      grows beyond it */
+  void set_buffer_budget(size_t bytes);
+
+  int get_cache_hits() const { return m_cache_hits; }
+  int get_cache_misses() const { return m_cache_misses; }
+  int get_cache_evictions() const { return m_cache_evictions; }
+  size_t get_cache_size() const { return m_buffer_bytes; }
+
   void set_listener_position(const Vector& position);
   void set_listener_velocity(const Vector& velocity);
   void set_listener_orientation(const Vector& at, const Vector& up);
@@ -109,13 +155,39 @@ private:
 
   void check_alc_error(const char* message) const;
 
+  /** Returns the cached buffer for filename and marks it as recently
+      used, or nullptr if it isn't cached */
+  CachedBuffer* find_buffer(const std::string& filename);
+  void add_buffer(const std::string& filename, ALuint buffer, size_t size);
+
+  /** Evicts least recently used buffers until the cache fits the budget */
+  void trim_buffers();
+
+  /** Turns the sounds decoded by the workers into buffers */
+  void upload_preloaded();
+
 private:
   ALCdevice* m_device;
   ALCcontext* m_context;
   bool m_sound_enabled;
   int m_sound_volume;
 
-  std::map<std::string, ALuint> m_buffers;
+  std::map<std::string, CachedBuffer> m_buffers;
+
+  /** filenames of the cached buffers, most recently used first */
+  std::list<std::string> m_lru;
+  size_t m_buffer_bytes;
+  size_t m_buffer_budget;
+  std::set<std::string> m_pinned;
+
+  int m_cache_hits;
+  int m_cache_misses;
+  int m_cache_evictions;
+
+  /** sounds handed to the worker thread and not yet uploaded */
+  std::set<std::string> m_preloading;
+  std::vector<DecodedSound> m_decoded;
+  std::mutex m_decoded_mutex;
   std::vector<std::unique_ptr<OpenALSoundSource> > m_sources;
 
   std::vector<StreamSoundSource*> m_update_list;
@@ -126,6 +198,9 @@ private:
   int m_music_volume;
   std::string m_current_music;
 
+  /** destroyed first, so that no job outlives the members above */
+  std::unique_ptr<WorkerPool> m_workers;
+
 private:
   SoundManager(const SoundManager&) = delete;
   SoundManager& operator=(const SoundManager&) = delete;
@@ -14,14 +14,33 @@
 //  You should have received a copy of the GNU General Public License
 //  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include "audio/stream_sound_source.hpp"
+
+#include <chrono>
+
+#include "audio/sound_error.hpp"
 #include "audio/sound_file.hpp"
 #include "audio/sound_manager.hpp"
-#include "audio/stream_sound_source.hpp"
 #include "supertux/globals.hpp"
 #include "util/log.hpp"
 
 StreamSoundSource::StreamSoundSource() :
   m_file(),
+  m_format(),
+  m_rate(),
+  m_free_buffers(),
+  m_fragments([]{
+      std::vector<Fragment> fragments(STREAMFRAGMENTS);
+      for (auto& fragment : fragments) {
+        fragment.data.reset(new char[STREAMFRAGMENTSIZE]);
+        fragment.size = 0;
+        fragment.last = false;
+      }
+      return fragments;
+    }()),
+  m_decoder(),
+  m_quit(false),
+  m_decoder_done(false),
   m_fade_state(NoFading),
   m_fade_start_time(),
   m_fade_time(),
@@ -44,6 +63,7 @@ StreamSoundSource::~StreamSoundSource()
 {
   //don't update me any longer
   SoundManager::current()->remove_from_update( this );
+  stop_decoder();
   m_file.reset();
   stop();
   alDeleteBuffers(STREAMFRAGMENTS, m_buffers);
@@ -61,13 +81,50 @@ StreamSoundSource::~StreamSoundSource()
 void
 StreamSoundSource::set_sound_file(std::unique_ptr<SoundFile> newfile)
 {
+  stop_decoder();
+  stop();
+
   m_file = std::move(newfile);
+  m_format = SoundManager::get_sample_format(*m_file);
+  m_rate = m_file->m_rate;
+  m_decoder_done = false;
 
-  ALint queued;
-  alGetSourcei(m_source, AL_BUFFERS_QUEUED, &queued);
-  for (size_t i = 0; i < STREAMFRAGMENTS - queued; ++i) {
-    if (fillBufferAndQueue(m_buffers[i]) == false)
-      break;
+  m_fragments.clear();
+  m_free_buffers.assign(m_buffers, m_buffers + STREAMFRAGMENTS);
+
+  // decode the first fragment right away, so that the source has
+  // something to play when play() is called next
+  Fragment* fragment = m_fragments.write_slot();
+  decode(*fragment);
+  const bool last = fragment->last;
+  m_fragments.commit_write();
+  queue_fragments();
+
+  if (!last) {
+    start_decoder();
+  }
+}
+
+void
+StreamSoundSource::set_looping(bool looping_)
+{
+  m_looping = looping_;
+
+  // A file that already reached its end doesn't come back by itself,
+  // e.g. when looping got turned on after set_sound_file() decoded a
+  // short file in one go
+  if (m_looping && m_file && (!m_decoder.joinable() || m_decoder_done))
+  {
+    stop_decoder();
+    try
+    {
+      m_file->reset();
+      start_decoder();
+    }
+    catch(const SoundError& e)
+    {
+      log_warning << "Couldn't restart sound stream: " << e.what() << std::endl;
+    }
   }
 }
 
@@ -82,21 +139,21 @@ StreamSoundSource::update()
     try
     {
       SoundManager::check_al_error("Couldn't unqueue audio buffer: ");
+      m_free_buffers.push_back(buffer);
     }
     catch(std::exception& e)
     {
       log_warning << e.what() << std::endl;
     }
-
-    if (fillBufferAndQueue(buffer) == false)
-      break;
   }
 
-  if (!playing()) {
-    if (processed == 0 || !m_looping)
-      return;
+  const bool queued = queue_fragments();
 
-    // we might have to restart the source if we had a buffer underrun
+  ALint state = AL_PLAYING;
+  alGetSourcei(m_source, AL_SOURCE_STATE, &state);
+  if (state == AL_STOPPED && queued) {
+    // the source ran dry before the decoder caught up, a paused or
+    // stopped source is left alone
     log_info << "Restarting audio source because of buffer underrun" << std::endl;
     play();
   }
@@ -131,42 +188,111 @@ StreamSoundSource::set_fading(FadeState state, float fade_time_)
   m_fade_start_time = g_real_time;
 }
 
-bool
-StreamSoundSource::fillBufferAndQueue(ALuint buffer)
+void
+StreamSoundSource::decode(Fragment& fragment)
 {
-  // fill buffer
-  std::unique_ptr<char[]> bufferdata(new char[STREAMFRAGMENTSIZE]);
   size_t bytesread = 0;
-  do {
-    bytesread += m_file->read(bufferdata.get() + bytesread,
-                            STREAMFRAGMENTSIZE - bytesread);
-    // end of sound file
-    if (bytesread < STREAMFRAGMENTSIZE) {
-      if (m_looping)
-        m_file->reset();
-      else
-        break;
-    }
-  } while(bytesread < STREAMFRAGMENTSIZE);
+  try
+  {
+    do {
+      bytesread += m_file->read(fragment.data.get() + bytesread,
+                                STREAMFRAGMENTSIZE - bytesread);
+      // end of sound file
+      if (bytesread < STREAMFRAGMENTSIZE) {
+        if (m_looping)
+          m_file->reset();
+        else
+          break;
+      }
+    } while(bytesread < STREAMFRAGMENTSIZE);
+  }
+  catch(const SoundError& e)
+  {
+    log_warning << "Couldn't decode sound stream, stopping it: " << e.what() << std::endl;
+    m_file.reset();
+    fragment.size = bytesread;
+    fragment.last = true;
+    return;
+  }
 
-  if (bytesread > 0) {
-    ALenum format = SoundManager::get_sample_format(*m_file);
-    try
-    {
-      alBufferData(buffer, format, bufferdata.get(), static_cast<ALsizei>(bytesread), m_file->m_rate);
-      SoundManager::check_al_error("Couldn't refill audio buffer: ");
+  fragment.size = bytesread;
+  fragment.last = bytesread < STREAMFRAGMENTSIZE;
+}
+
+void
+StreamSoundSource::start_decoder()
+{
+  m_decoder_done = false;
+  m_decoder = std::thread(&StreamSoundSource::run_decoder, this);
+}
 
-      alSourceQueueBuffers(m_source, 1, &buffer);
-      SoundManager::check_al_error("Couldn't queue audio buffer: ");
+void
+StreamSoundSource::run_decoder()
+{
+  while (!m_quit)
+  {
+    Fragment* fragment = m_fragments.write_slot();
+    if (!fragment)
+    {
+      // a fragment lasts about half a second, so polling is cheap
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
     }
-    catch(std::exception& e)
+
+    decode(*fragment);
+    const bool last = fragment->last;
+    m_fragments.commit_write();
+    if (last)
     {
-      log_warning << e.what() << std::endl;
+      m_decoder_done = true;
+      return;
     }
   }
+}
+
+void
+StreamSoundSource::stop_decoder()
+{
+  if (m_decoder.joinable())
+  {
+    m_quit = true;
+    m_decoder.join();
+    m_quit = false;
+  }
+}
+
+bool
+StreamSoundSource::queue_fragments()
+{
+  bool queued = false;
+  while (!m_free_buffers.empty())
+  {
+    Fragment* fragment = m_fragments.read_slot();
+    if (!fragment)
+      break;
+
+    if (fragment->size > 0)
+    {
+      const ALuint buffer = m_free_buffers.back();
+      try
+      {
+        alBufferData(buffer, m_format, fragment->data.get(), static_cast<ALsizei>(fragment->size), m_rate);
+        SoundManager::check_al_error("Couldn't refill audio buffer: ");
+
+        alSourceQueueBuffers(m_source, 1, &buffer);
+        SoundManager::check_al_error("Couldn't queue audio buffer: ");
 
-  // return false if there aren't more buffers to fill
-  return bytesread >= STREAMFRAGMENTSIZE;
+        m_free_buffers.pop_back();
+        queued = true;
+      }
+      catch(std::exception& e)
+      {
+        log_warning << e.what() << std::endl;
+      }
+    }
+    m_fragments.commit_read();
+  }
+  return queued;
 }
 
 /* EOF */
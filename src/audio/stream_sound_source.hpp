@@ -17,10 +17,19 @@
 #ifndef HEADER_SUPERTUX_AUDIO_STREAM_SOUND_SOURCE_HPP
 #define HEADER_SUPERTUX_AUDIO_STREAM_SOUND_SOURCE_HPP
 
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include "audio/openal_sound_source.hpp"
+#include "util/spsc_ring.hpp"
 
 class SoundFile;
 
+/** Streams a sound file into OpenAL. Each stream decodes its file on
+    a thread of its own into a ring of PCM fragments, update() only
+    hands finished fragments to OpenAL. */
 class StreamSoundSource final : public OpenALSoundSource
 {
 private:
@@ -28,6 +37,15 @@ private:
   static const size_t STREAMFRAGMENTS = 5;
   static const size_t STREAMFRAGMENTSIZE = STREAMBUFFERSIZE / STREAMFRAGMENTS;
 
+  struct Fragment
+  {
+    std::unique_ptr<char[]> data;
+    size_t size;
+
+    /** true if the end of a non-looping file was reached */
+    bool last;
+  };
+
 public:
   enum FadeState { NoFading, FadingOn, FadingOff, FadingPause, FadingResume };
 
@@ -36,7 +54,7 @@ public:
   virtual ~StreamSoundSource();
 
   virtual void update() override;
-  virtual void set_looping(bool looping_) override { m_looping = looping_; }
+  virtual void set_looping(bool looping_) override;
 
   void set_sound_file(std::unique_ptr<SoundFile> newfile);
 
@@ -45,16 +63,40 @@ public:
   bool get_looping() const { return m_looping; }
 
 private:
-  bool fillBufferAndQueue(ALuint buffer);
+  /** Decodes the next STREAMFRAGMENTSIZE bytes of m_file. A broken
+      file ends the stream: the error is logged, the fragment becomes
+      the last one and m_file is dropped. */
+  void decode(Fragment& fragment);
+  void start_decoder();
+  void run_decoder();
+  void stop_decoder();
+
+  /** Queues decoded fragments into the free buffers, returns true if
+      at least one buffer was queued */
+  bool queue_fragments();
 
 private:
+  /** only touched by the decoder thread while it is running */
   std::unique_ptr<SoundFile> m_file;
+  ALenum m_format;
+  ALsizei m_rate;
+
   ALuint m_buffers[STREAMFRAGMENTS];
 
+  /** buffers that aren't queued on the source */
+  std::vector<ALuint> m_free_buffers;
+
+  SPSCRing<Fragment> m_fragments;
+  std::thread m_decoder;
+  std::atomic<bool> m_quit;
+
+  /** set by the decoder thread once it decoded the last fragment */
+  std::atomic<bool> m_decoder_done;
+
   FadeState m_fade_state;
   float m_fade_start_time;
   float m_fade_time;
-  bool m_looping;
+  std::atomic<bool> m_looping;
 
 private:
   StreamSoundSource(const StreamSoundSource&) = delete;
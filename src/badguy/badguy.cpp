@@ -569,6 +569,9 @@ BadGuy::set_state(State state_)
 
   State laststate = m_state;
   m_state = state_;
+  if (m_state != STATE_INACTIVE)
+    wake_up();
+
   switch (state_) {
     case STATE_BURNING:
       m_state_timer.start(BURN_TIME);
@@ -49,6 +49,10 @@ public:
       state and calls active_update and inactive_update */
   virtual void update(float dt_sec) override;
 
+  /** Inactive badguys far away from the camera only wait for
+      try_activate(), they sleep until set_state() wakes them up */
+  virtual bool can_sleep() const override { return m_state == STATE_INACTIVE; }
+
   virtual std::string get_class() const override { return "badguy"; }
   virtual std::string get_display_name() const override { return _("Badguy"); }
 
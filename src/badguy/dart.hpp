@@ -18,11 +18,13 @@
 #define HEADER_SUPERTUX_BADGUY_DART_HPP
 
 #include "badguy/badguy.hpp"
+#include "util/object_pool.hpp"
 
 class SoundSource;
 
 /** Badguy "Dart" - Your average poison dart */
-class Dart final : public BadGuy
+class Dart final : public BadGuy,
+                   public Pooled<Dart>
 {
 public:
   Dart(const ReaderMapping& reader);
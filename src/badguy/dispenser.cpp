@@ -138,7 +138,7 @@ Dispenser::Dispenser(const ReaderMapping& reader) :
       break;
   }
 
-  m_col.m_bbox.set_size(m_sprite->get_current_hitbox_width(), m_sprite->get_current_hitbox_height());
+  m_col.set_size(m_sprite->get_current_hitbox_width(), m_sprite->get_current_hitbox_height());
   m_countMe = false;
 }
 
@@ -38,7 +38,7 @@ Flame::Flame(const ReaderMapping& reader) :
   reader.get("radius", radius, 100.0f);
   reader.get("speed", speed, 2.0f);
   if (!Editor::is_active()) {
-    m_col.m_bbox.set_pos(Vector(m_start_position.x + cosf(angle) * radius,
+    m_col.set_pos(Vector(m_start_position.x + cosf(angle) * radius,
                                 m_start_position.y + sinf(angle) * radius));
   }
   m_countMe = false;
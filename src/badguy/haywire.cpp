@@ -188,8 +188,8 @@ void
 Haywire::start_exploding()
 {
   set_action ((m_dir == Direction::LEFT) ? "ticking-left" : "ticking-right", /* loops = */ -1);
-  walk_left_action = "ticking-left";
-  walk_right_action = "ticking-right";
+  walk_left_action = ActionId("ticking-left");
+  walk_right_action = ActionId("ticking-right");
   set_walk_speed (EXPLODING_WALK_SPEED);
   time_until_explosion = TIME_EXPLOSION;
   is_exploding = true;
@@ -209,8 +209,8 @@ Haywire::start_exploding()
 void
 Haywire::stop_exploding()
 {
-  walk_left_action = "left";
-  walk_right_action = "right";
+  walk_left_action = ActionId("left");
+  walk_right_action = ActionId("right");
   set_walk_speed(NORMAL_WALK_SPEED);
   time_until_explosion = 0.0f;
   is_exploding = false;
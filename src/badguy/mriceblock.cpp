@@ -242,7 +242,7 @@ MrIceBlock::set_state(IceState state_)
       m_physic.set_velocity_x(m_dir == Direction::LEFT ? -KICKSPEED : KICKSPEED);
       set_action(m_dir == Direction::LEFT ? "flat-left" : "flat-right", /* loops = */ -1);
       // we should slide above 1 block holes now...
-      m_col.m_bbox.set_size(34, 31.8f);
+      m_col.set_size(34, 31.8f);
       break;
     case ICESTATE_GRABBED:
       flat_timer.stop();
@@ -45,17 +45,10 @@ inline void makePlane(const Vector& p1, const Vector& p2, Vector& n, float& c)
   c /= nval;
 }
 
-}
-
-bool rectangle_aatriangle(Constraints* constraints, const Rectf& rect,
-                          const AATriangle& triangle, const Vector& addl_ground_movement)
+/** Returns the part of the triangle's bbox that contains the slope,
+    taking the deform flags into account */
+Rectf get_aatriangle_area(const AATriangle& triangle)
 {
-  if (!intersects(rect, triangle.bbox))
-    return false;
-
-  Vector normal;
-  float c = 0.0;
-  Vector p1;
   Rectf area;
   switch (triangle.dir & AATriangle::DEFORM_MASK) {
     case 0:
@@ -81,6 +74,21 @@ bool rectangle_aatriangle(Constraints* constraints, const Rectf& rect,
     default:
       assert(false);
   }
+  return area;
+}
+
+}
+
+bool rectangle_aatriangle(Constraints* constraints, const Rectf& rect,
+                          const AATriangle& triangle, const Vector& addl_ground_movement)
+{
+  if (!intersects(rect, triangle.bbox))
+    return false;
+
+  Vector normal;
+  float c = 0.0;
+  Vector p1;
+  const Rectf area = get_aatriangle_area(triangle);
 
   switch (triangle.dir & AATriangle::DIRECTION_MASK) {
     case AATriangle::SOUTHWEST:
@@ -224,6 +232,81 @@ bool intersects_line(const Rectf& r, const Vector& line_start, const Vector& lin
   return false;
 }
 
+bool clip_line(const Rectf& rect, Vector& line_start, Vector& line_end)
+{
+  // Liang-Barsky clipping
+  const Vector delta = line_end - line_start;
+  const float p[4] = { -delta.x, delta.x, -delta.y, delta.y };
+  const float q[4] = {
+    line_start.x - rect.get_left(),
+    rect.get_right() - line_start.x,
+    line_start.y - rect.get_top(),
+    rect.get_bottom() - line_start.y
+  };
+
+  float t0 = 0.0f;
+  float t1 = 1.0f;
+  for (int i = 0; i < 4; ++i) {
+    if (p[i] == 0.0f) {
+      if (q[i] < 0.0f)
+        return false;
+    } else {
+      const float t = q[i] / p[i];
+      if (p[i] < 0.0f) {
+        t0 = std::max(t0, t);
+      } else {
+        t1 = std::min(t1, t);
+      }
+    }
+  }
+
+  if (t0 > t1)
+    return false;
+
+  const Vector start = line_start;
+  line_start = start + delta * t0;
+  line_end = start + delta * t1;
+  return true;
+}
+
+bool intersects_line(const AATriangle& triangle, const Vector& line_start, const Vector& line_end)
+{
+  Vector p = line_start;
+  Vector q = line_end;
+  if (!clip_line(triangle.bbox, p, q))
+    return false;
+
+  // the solid part of the tile is the part of the bbox on the inner
+  // side of the slope, same as in rectangle_aatriangle()
+  const Rectf area = get_aatriangle_area(triangle);
+  Vector normal;
+  float c = 0.0f;
+  switch (triangle.dir & AATriangle::DIRECTION_MASK) {
+    case AATriangle::SOUTHWEST:
+      makePlane(area.p1(), area.p2(), normal, c);
+      break;
+    case AATriangle::NORTHEAST:
+      makePlane(area.p2(), area.p1(), normal, c);
+      break;
+    case AATriangle::SOUTHEAST:
+      makePlane(Vector(area.get_left(), area.get_bottom()),
+                Vector(area.get_right(), area.get_top()), normal, c);
+      break;
+    case AATriangle::NORTHWEST:
+      makePlane(Vector(area.get_right(), area.get_top()),
+                Vector(area.get_left(), area.get_bottom()), normal, c);
+      break;
+    default:
+      assert(false);
+  }
+
+  // the empty part of the tile (the bbox on the outer side of the
+  // slope) is convex, so the clipped line stays in it if both end
+  // points do, otherwise an end point lies in the solid part
+  return (-(normal * p) - c >= 0.0f ||
+          -(normal * q) - c >= 0.0f);
+}
+
 }
 
 /* EOF */
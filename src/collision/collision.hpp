@@ -135,6 +135,15 @@ void set_rectangle_rectangle_constraints(Constraints* constraints,
 bool line_intersects_line(const Vector& line1_start, const Vector& line1_end, const Vector& line2_start, const Vector& line2_end);
 bool intersects_line(const Rectf& r, const Vector& line_start, const Vector& line_end);
 
+/** does collision detection between a line segment and the solid part
+    of an axis aligned triangle */
+bool intersects_line(const AATriangle& triangle, const Vector& line_start, const Vector& line_end);
+
+/** Clips the line segment to rect. Returns false if no part of the
+    line is within rect, line_start and line_end are left in an
+    undefined state then. */
+bool clip_line(const Rectf& rect, Vector& line_start, Vector& line_end);
+
 } // namespace collision
 
 #endif
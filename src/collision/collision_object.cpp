@@ -18,10 +18,12 @@
 #include "collision/collision_object.hpp"
 
 #include "collision/collision_listener.hpp"
+#include "collision/collision_system.hpp"
 #include "supertux/game_object.hpp"
 
 CollisionObject::CollisionObject(CollisionGroup group, CollisionListener& listener) :
   m_listener(listener),
+  m_system(nullptr),
   m_bbox(),
   m_movement(),
   m_group(group),
@@ -59,4 +61,12 @@ CollisionObject::is_valid() const
   return m_listener.listener_is_valid();
 }
 
+void
+CollisionObject::bbox_changed()
+{
+  if (m_system) {
+    m_system->update_index(*this);
+  }
+}
+
 /* EOF */
@@ -25,6 +25,7 @@
 #include "math/rectf.hpp"
 
 class CollisionListener;
+class CollisionSystem;
 class GameObject;
 
 class CollisionObject
@@ -66,6 +67,7 @@ public:
   {
     m_dest.move(pos - get_pos());
     m_bbox.set_pos(pos);
+    bbox_changed();
   }
 
   Vector get_pos() const
@@ -88,6 +90,7 @@ public:
   {
     m_dest.set_width(w);
     m_bbox.set_width(w);
+    bbox_changed();
   }
 
   /** sets the moving object's bbox to a specific size. Be careful
@@ -97,6 +100,7 @@ public:
   {
     m_dest.set_size(w, h);
     m_bbox.set_size(w, h);
+    bbox_changed();
   }
 
   CollisionGroup get_group() const
@@ -111,9 +115,17 @@ public:
     return m_listener;
   }
 
+private:
+  /** lets the CollisionSystem know that m_bbox was changed outside of
+      collision detection, so that its spatial index stays in sync */
+  void bbox_changed();
+
 private:
   CollisionListener& m_listener;
 
+  /** the CollisionSystem this object has been added to, if any */
+  CollisionSystem* m_system;
+
 public:
   /** The bounding box of the object (as used for collision detection,
       this isn't necessarily the bounding box for graphics) */
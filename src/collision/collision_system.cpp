@@ -17,15 +17,24 @@
 
 #include "collision/collision_system.hpp"
 
+#include <algorithm>
+#include <assert.h>
+#include <limits>
+#include <math.h>
+
 #include "collision/collision.hpp"
 #include "editor/editor.hpp"
 #include "math/aatriangle.hpp"
 #include "math/rect.hpp"
+#include "math/util.hpp"
 #include "object/player.hpp"
 #include "object/tilemap.hpp"
 #include "supertux/constants.hpp"
+#include "supertux/debug.hpp"
 #include "supertux/sector.hpp"
 #include "supertux/tile.hpp"
+#include "util/log.hpp"
+#include "util/profiler.hpp"
 #include "video/color.hpp"
 #include "video/drawing_context.hpp"
 
@@ -36,11 +45,44 @@ const float MAX_SPEED = 16.0f;
 // a small value... be careful as CD is very sensitive to it
 const float DELTA = .002f;
 
+// cell size of the moving objects broadphase grid
+const float BROADPHASE_CELL_SIZE = 64.0f;
+
+// Objects get pushed apart while the pairs are resolved, so the
+// broadphase has to consider objects a bit further away than their
+// current destination, by at most MAX_SPEED, the furthest an object
+// moves in one step, plus a pixel for the DELTA nudges.
+const float BROADPHASE_MARGIN = MAX_SPEED + 1.0f;
+
+// cell size of the spatial index used for object queries
+const float INDEX_CELL_SIZE = 128.0f;
+
+Rectf get_line_bbox(const Vector& line_start, const Vector& line_end)
+{
+  return Rectf(std::min(line_start.x, line_end.x),
+               std::min(line_start.y, line_end.y),
+               std::max(line_start.x, line_end.x),
+               std::max(line_start.y, line_end.y));
+}
+
+bool is_moving_group(const CollisionObject& object)
+{
+  return (object.get_group() == COLGROUP_MOVING ||
+          object.get_group() == COLGROUP_MOVING_STATIC);
+}
+
 } // namespace
 
 CollisionSystem::CollisionSystem(Sector& sector) :
   m_sector(sector),
-  m_objects()
+  m_objects(),
+  m_moving_grid(BROADPHASE_CELL_SIZE),
+  m_moving_pairs(),
+  m_index(INDEX_CELL_SIZE),
+  m_insertion_order(),
+  m_next_insertion_order(0),
+  m_particle_order(),
+  m_query_buffer()
 {
 }
 
@@ -48,6 +90,10 @@ void
 CollisionSystem::add(CollisionObject* object)
 {
   m_objects.push_back(object);
+
+  object->m_system = this;
+  m_index.add(object, object->get_bbox());
+  m_insertion_order[object] = m_next_insertion_order++;
 }
 
 void
@@ -56,6 +102,16 @@ CollisionSystem::remove(CollisionObject* object)
   m_objects.erase(
     std::find(m_objects.begin(), m_objects.end(),
               object));
+
+  object->m_system = nullptr;
+  m_index.remove(object);
+  m_insertion_order.erase(object);
+}
+
+void
+CollisionSystem::update_index(CollisionObject& object)
+{
+  m_index.update(&object, object.get_bbox());
 }
 
 void
@@ -481,6 +537,8 @@ CollisionSystem::collision_static_constrains(CollisionObject& object)
 void
 CollisionSystem::update()
 {
+  PROFILE_ZONE("CollisionSystem::update");
+
   if (Editor::is_active()) {
     return;
     //Oběcts in editor shouldn't collide.
@@ -558,33 +616,111 @@ CollisionSystem::update()
   }
 
   // part3: COLGROUP_MOVING vs COLGROUP_MOVING
+  if (g_debug.use_collision_broadphase) {
+    collision_moving_broadphase();
+  } else {
+    collision_moving_bruteforce();
+  }
+
+  // apply object movement
+  for (const auto& object : m_objects) {
+    object->m_bbox = object->m_dest;
+    object->m_movement = Vector(0, 0);
+    m_index.update(object, object->m_bbox);
+  }
+}
+
+void
+CollisionSystem::collision_moving_bruteforce()
+{
   for (auto i = m_objects.begin(); i != m_objects.end(); ++i)
   {
     auto object = *i;
 
-    if ((object->get_group() != COLGROUP_MOVING
-        && object->get_group() != COLGROUP_MOVING_STATIC)
-       || !object->is_valid())
+    if (!is_moving_group(*object) || !object->is_valid())
       continue;
 
     for (auto i2 = i+1; i2 != m_objects.end(); ++i2) {
       auto object_2 = *i2;
-      if ((object_2->get_group() != COLGROUP_MOVING
-          && object_2->get_group() != COLGROUP_MOVING_STATIC)
-         || !object_2->is_valid())
+      if (!is_moving_group(*object_2) || !object_2->is_valid())
         continue;
 
       collision_object(object, object_2);
     }
   }
+}
 
-  // apply object movement
-  for (const auto& object : m_objects) {
-    object->m_bbox = object->m_dest;
-    object->m_movement = Vector(0, 0);
+void
+CollisionSystem::collision_moving_broadphase()
+{
+  find_moving_pairs();
+
+  if (!g_debug.verify_collision_broadphase)
+  {
+    for (const auto& pair : m_moving_pairs) {
+      auto object = m_objects[pair.first];
+      auto object_2 = m_objects[pair.second];
+
+      // objects might get removed by an earlier collision
+      if (!object->is_valid() || !object_2->is_valid())
+        continue;
+
+      collision_object(object, object_2);
+    }
+  }
+  else
+  {
+    // Walk all pairs like collision_moving_bruteforce() does and
+    // complain about every colliding pair the broadphase didn't find
+    for (size_t i = 0; i < m_objects.size(); ++i)
+    {
+      auto object = m_objects[i];
+      if (!is_moving_group(*object) || !object->is_valid())
+        continue;
+
+      for (size_t j = i + 1; j < m_objects.size(); ++j)
+      {
+        auto object_2 = m_objects[j];
+        if (!is_moving_group(*object_2) || !object_2->is_valid())
+          continue;
+
+        if (!std::binary_search(m_moving_pairs.begin(), m_moving_pairs.end(), std::make_pair(i, j)) &&
+            collision::intersects(object->m_dest, object_2->m_dest))
+        {
+          log_warning << "collision broadphase missed pair " << i << ", " << j << ": "
+                      << object->m_dest << " " << object_2->m_dest << std::endl;
+        }
+
+        collision_object(object, object_2);
+      }
+    }
   }
 }
 
+void
+CollisionSystem::find_moving_pairs()
+{
+  m_moving_grid.clear();
+  m_moving_pairs.clear();
+
+  for (size_t i = 0; i < m_objects.size(); ++i)
+  {
+    const auto& object = m_objects[i];
+    if (!is_moving_group(*object) || !object->is_valid())
+      continue;
+
+    m_moving_grid.insert(i, object->m_dest.grown(BROADPHASE_MARGIN));
+  }
+
+  m_moving_grid.for_each_pair([this](size_t a, size_t b) {
+      m_moving_pairs.push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+    });
+
+  // collision_object() modifies the destinations, so the results
+  // depend on the order in which pairs are handled
+  std::sort(m_moving_pairs.begin(), m_moving_pairs.end());
+}
+
 bool
 CollisionSystem::is_free_of_tiles(const Rectf& rect, const bool ignoreUnisolid) const
 {
@@ -626,7 +762,7 @@ CollisionSystem::is_free_of_statics(const Rectf& rect, const CollisionObject* ig
 
   if (!is_free_of_tiles(rect, ignoreUnisolid)) return false;
 
-  for (const auto& object : m_objects) {
+  for (const auto& object : get_candidates(rect, m_query_buffer)) {
     if (object == ignore_object) continue;
     if (!object->is_valid()) continue;
     if (object->get_group() == COLGROUP_STATIC) {
@@ -644,7 +780,7 @@ CollisionSystem::is_free_of_movingstatics(const Rectf& rect, const CollisionObje
 
   if (!is_free_of_tiles(rect)) return false;
 
-  for (const auto& object : m_objects) {
+  for (const auto& object : get_candidates(rect, m_query_buffer)) {
     if (object == ignore_object) continue;
     if (!object->is_valid()) continue;
     if ((object->get_group() == COLGROUP_MOVING)
@@ -660,31 +796,248 @@ CollisionSystem::is_free_of_movingstatics(const Rectf& rect, const CollisionObje
 bool
 CollisionSystem::free_line_of_sight(const Vector& line_start, const Vector& line_end, const CollisionObject* ignore_object) const
 {
-  using namespace collision;
+  if (!free_line_of_sight_tiles(line_start, line_end))
+    return false;
+
+  return free_line_of_sight_objects(line_start, line_end, ignore_object,
+                                    get_candidates(get_line_bbox(line_start, line_end), m_query_buffer));
+}
+
+size_t
+CollisionSystem::free_lines_of_sight(const std::vector<std::pair<Vector, Vector> >& lines,
+                                     const CollisionObject* ignore_object,
+                                     std::vector<bool>& results,
+                                     bool stop_at_first_free) const
+{
+  results.assign(lines.size(), false);
+
+  // the tile walk stops at the first blocking tile, the objects are
+  // only looked up (once for all lines) when a line gets past the tiles
+  const std::vector<CollisionObject*>* candidates = nullptr;
+
+  size_t free_count = 0;
+  for (size_t i = 0; i < lines.size(); ++i)
+  {
+    const Vector& line_start = lines[i].first;
+    const Vector& line_end = lines[i].second;
+    if (!free_line_of_sight_tiles(line_start, line_end))
+      continue;
+
+    if (!candidates)
+    {
+      Rectf bbox = get_line_bbox(line_start, line_end);
+      for (size_t j = i + 1; j < lines.size(); ++j) {
+        const Rectf line_bbox = get_line_bbox(lines[j].first, lines[j].second);
+        bbox = Rectf(std::min(bbox.get_left(), line_bbox.get_left()),
+                     std::min(bbox.get_top(), line_bbox.get_top()),
+                     std::max(bbox.get_right(), line_bbox.get_right()),
+                     std::max(bbox.get_bottom(), line_bbox.get_bottom()));
+      }
+      candidates = &get_candidates(bbox, m_query_buffer);
+    }
+
+    if (free_line_of_sight_objects(line_start, line_end, ignore_object, *candidates))
+    {
+      results[i] = true;
+      free_count += 1;
+      if (stop_at_first_free)
+        break;
+    }
+  }
+
+  return free_count;
+}
+
+size_t
+CollisionSystem::collide_particles(const std::vector<float>& x, const std::vector<float>& y,
+                                   const std::vector<float>& speed, const Vector& direction,
+                                   std::vector<ParticleHit>& hits) const
+{
+  PROFILE_ZONE("CollisionSystem::collide_particles");
 
-  // check if no tile is in the way
-  const float lsx = std::min(line_start.x, line_end.x);
-  const float lex = std::max(line_start.x, line_end.x);
-  const float lsy = std::min(line_start.y, line_end.y);
-  const float ley = std::max(line_start.y, line_end.y);
-
-  for (float test_x = lsx; test_x <= lex; test_x += 16) { // NOLINT
-    for (float test_y = lsy; test_y <= ley; test_y += 16) { // NOLINT
-      for (const auto& solids : m_sector.get_solid_tilemaps()) {
-        const Tile& tile = solids->get_tile_at(Vector(test_x, test_y));
-        // FIXME: check collision with slope tiles
-        if ((tile.get_attributes() & Tile::SOLID)) return false;
+  assert(y.size() == x.size() && speed.size() == x.size());
+
+  // visit the particles column by column, so that consecutive
+  // particles look at the same words of the solidity masks
+  m_particle_order.clear();
+  for (size_t i = 0; i < x.size(); ++i) {
+    m_particle_order.push_back(std::make_pair(static_cast<int>(floorf(x[i] / 32.0f)), i));
+  }
+  std::sort(m_particle_order.begin(), m_particle_order.end());
+
+  const auto& solid_tilemaps = m_sector.get_solid_tilemaps();
+  const size_t first_hit = hits.size();
+
+  for (const auto& entry : m_particle_order)
+  {
+    const size_t i = entry.second;
+    const Vector movement = direction * speed[i];
+
+    // calculate rectangle where the particle will move
+    const float x1 = std::min(x[i], x[i] + 32.0f + movement.x);
+    const float x2 = std::max(x[i], x[i] + 32.0f + movement.x);
+    const float y1 = std::min(y[i], y[i] + 32.0f + movement.y);
+    const float y2 = std::max(y[i], y[i] + 32.0f + movement.y);
+
+    Rectf dest(x1, y1, x2, y2);
+    dest.move(movement);
+
+    collision::Constraints constraints;
+    bool water = false;
+
+    for (const auto& solids : solid_tilemaps)
+    {
+      const int width = solids->get_width();
+      const int height = solids->get_height();
+      if (width <= 0 || height <= 0)
+        continue;
+
+      const std::vector<uint64_t>& mask = solids->get_solidity_mask();
+      const int stride = solids->get_solidity_mask_stride();
+      const Vector& offset = solids->get_offset();
+
+      const int start_x = std::max(0, static_cast<int>(floorf((x1 - 1.0f - offset.x) / 32.0f)));
+      const int end_x = std::min(width - 1, static_cast<int>(ceilf((x2 + 1.0f - offset.x) / 32.0f)) - 1);
+      const int start_y = std::max(0, static_cast<int>(floorf((y1 - 1.0f - offset.y) / 32.0f)));
+      const int end_y = std::min(height - 1, static_cast<int>(ceilf((y2 + 1.0f - offset.y) / 32.0f)) - 1);
+
+      for (int tx = start_x; tx <= end_x; ++tx)
+      {
+        const uint64_t* column = mask.data() + tx * stride;
+        for (int ty = start_y; ty <= end_y; ++ty)
+        {
+          // skip tiles that are neither solid nor water
+          if (!(column[ty / 64] & (uint64_t(1) << (ty % 64))))
+            continue;
+
+          const Tile& tile = solids->get_tile(tx, ty);
+          const Rectf tile_bbox = solids->get_tile_bbox(tx, ty);
+
+          if (tile.is_slope()) {
+            int slope_data = tile.get_data();
+            if (solids->get_flip() & VERTICAL_FLIP)
+              slope_data = AATriangle::vertical_flip(slope_data);
+
+            if (collision::rectangle_aatriangle(&constraints, dest, AATriangle(tile_bbox, slope_data))) {
+              water |= (tile.get_attributes() & Tile::WATER) != 0;
+            }
+          } else if (collision::intersects(dest, tile_bbox)) {
+            water |= (tile.get_attributes() & Tile::WATER) != 0;
+            collision::set_rectangle_rectangle_constraints(&constraints, dest, tile_bbox);
+          }
+        }
       }
     }
+
+    if (!constraints.has_constraints())
+      continue;
+
+    ParticleHit hit;
+    hit.index = i;
+    hit.pos = Vector(x[i], (floorf(y[i] / 32.0f) + 1.0f) * 32.0f);
+    hit.water = water;
+    hit.side = constraints.hit.left || constraints.hit.right;
+    hits.push_back(hit);
   }
 
-  // check if no object is in the way
-  for (const auto& object : m_objects) {
+  std::sort(hits.begin() + first_hit, hits.end(),
+            [](const ParticleHit& lhs, const ParticleHit& rhs) {
+              return lhs.index < rhs.index;
+            });
+
+  return hits.size() - first_hit;
+}
+
+bool
+CollisionSystem::free_line_of_sight_tiles(const Vector& line_start, const Vector& line_end) const
+{
+  for (const auto& solids : m_sector.get_solid_tilemaps())
+  {
+    const int width = solids->get_width();
+    const int height = solids->get_height();
+    if (width <= 0 || height <= 0)
+      continue;
+
+    Vector start = line_start;
+    Vector end = line_end;
+    if (!collision::clip_line(solids->get_bbox(), start, end))
+      continue;
+
+    // walk through the tiles along the line, see Amanatides & Woo, "A
+    // Fast Voxel Traversal Algorithm for Ray Tracing"
+    const Vector tile_start = (start - solids->get_offset()) / 32.0f;
+    const Vector tile_end = (end - solids->get_offset()) / 32.0f;
+    const Vector delta = tile_end - tile_start;
+
+    int x = math::clamp(static_cast<int>(floorf(tile_start.x)), 0, width - 1);
+    int y = math::clamp(static_cast<int>(floorf(tile_start.y)), 0, height - 1);
+    const int end_x = math::clamp(static_cast<int>(floorf(tile_end.x)), 0, width - 1);
+    const int end_y = math::clamp(static_cast<int>(floorf(tile_end.y)), 0, height - 1);
+
+    const float infinity = std::numeric_limits<float>::infinity();
+    const int step_x = (delta.x > 0.0f) ? 1 : ((delta.x < 0.0f) ? -1 : 0);
+    const int step_y = (delta.y > 0.0f) ? 1 : ((delta.y < 0.0f) ? -1 : 0);
+    const float t_delta_x = (step_x != 0) ? 1.0f / fabsf(delta.x) : infinity;
+    const float t_delta_y = (step_y != 0) ? 1.0f / fabsf(delta.y) : infinity;
+    float t_max_x = (step_x != 0) ? (static_cast<float>(x + (step_x > 0 ? 1 : 0)) - tile_start.x) / delta.x : infinity;
+    float t_max_y = (step_y != 0) ? (static_cast<float>(y + (step_y > 0 ? 1 : 0)) - tile_start.y) / delta.y : infinity;
+
+    // the loop visits each tile on the line once, the bound only
+    // protects against rounding trouble
+    const int max_steps = abs(end_x - x) + abs(end_y - y) + 1;
+    for (int i = 0; i < max_steps; ++i)
+    {
+      const Tile& tile = solids->get_tile(x, y);
+      if (tile.get_attributes() & Tile::SOLID)
+      {
+        if (!tile.is_slope()) {
+          return false;
+        }
+
+        int slope_data = tile.get_data();
+        if (solids->get_flip() & VERTICAL_FLIP)
+          slope_data = AATriangle::vertical_flip(slope_data);
+
+        if (collision::intersects_line(AATriangle(solids->get_tile_bbox(x, y), slope_data),
+                                       start, end)) {
+          return false;
+        }
+      }
+
+      if (x == end_x && y == end_y)
+        break;
+
+      if (t_max_x < t_max_y) {
+        x += step_x;
+        t_max_x += t_delta_x;
+      } else {
+        y += step_y;
+        t_max_y += t_delta_y;
+      }
+
+      if (x < 0 || x >= width || y < 0 || y >= height)
+        break;
+    }
+  }
+
+  return true;
+}
+
+bool
+CollisionSystem::free_line_of_sight_objects(const Vector& line_start, const Vector& line_end,
+                                            const CollisionObject* ignore_object,
+                                            const std::vector<CollisionObject*>& candidates) const
+{
+  using namespace collision;
+
+  const Rectf line_bbox = get_line_bbox(line_start, line_end);
+  for (const auto& object : candidates) {
     if (object == ignore_object) continue;
     if (!object->is_valid()) continue;
     if ((object->get_group() == COLGROUP_MOVING)
         || (object->get_group() == COLGROUP_MOVING_STATIC)
         || (object->get_group() == COLGROUP_STATIC)) {
+      if (!intersects(line_bbox, object->get_bbox())) continue;
       if (intersects_line(object->get_bbox(), line_start, line_end)) return false;
     }
   }
@@ -697,13 +1050,50 @@ CollisionSystem::get_nearby_objects (const Vector& center, float max_distance) c
 {
   std::vector<CollisionObject*> ret;
 
-  for (const auto& object : m_objects) {
+  if (max_distance < 0.0f)
+    return ret;
+
+  const Rectf rect(center.x - max_distance, center.y - max_distance,
+                   center.x + max_distance, center.y + max_distance);
+  for (const auto& object : get_candidates(rect, m_query_buffer)) {
     float distance = object->get_bbox().distance(center);
     if (distance <= max_distance)
       ret.push_back(object);
   }
 
+  // keep the order of m_objects
+  std::sort(ret.begin(), ret.end(),
+            [this](const CollisionObject* lhs, const CollisionObject* rhs) {
+              return m_insertion_order.find(lhs)->second < m_insertion_order.find(rhs)->second;
+            });
+
   return ret;
 }
 
+const std::vector<CollisionObject*>&
+CollisionSystem::get_candidates(const Rectf& rect, std::vector<CollisionObject*>& buffer) const
+{
+  if (!g_debug.use_collision_broadphase)
+    return m_objects;
+
+  buffer.clear();
+  m_index.query(rect, buffer);
+
+  if (g_debug.verify_collision_broadphase)
+  {
+    for (const auto& object : m_objects)
+    {
+      const Rectf& bbox = object->get_bbox();
+      if (bbox.get_left() <= rect.get_right() && rect.get_left() <= bbox.get_right() &&
+          bbox.get_top() <= rect.get_bottom() && rect.get_top() <= bbox.get_bottom() &&
+          std::find(buffer.begin(), buffer.end(), object) == buffer.end())
+      {
+        log_warning << "collision index is out of sync for object at " << bbox << std::endl;
+      }
+    }
+  }
+
+  return buffer;
+}
+
 /* EOF */
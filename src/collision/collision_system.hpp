@@ -18,16 +18,35 @@
 #ifndef HEADER_SUPERTUX_COLLISION_COLLISION_SYSTEM_HPP
 #define HEADER_SUPERTUX_COLLISION_COLLISION_SYSTEM_HPP
 
+#include <unordered_map>
 #include <vector>
 #include <stdint.h>
 
 #include "collision/collision.hpp"
+#include "collision/spatial_hash.hpp"
+#include "math/vector.hpp"
 
 class CollisionObject;
 class DrawingContext;
 class Rectf;
 class Sector;
-class Vector;
+
+/** A particle that hit a tile, see CollisionSystem::collide_particles() */
+struct ParticleHit
+{
+  /** Index of the particle in the arrays passed in */
+  size_t index;
+
+  /** Where a splash would appear, on top of the 32px row below the
+      particle */
+  Vector pos;
+
+  /** true if a water tile was hit */
+  bool water;
+
+  /** true if a tile was hit from the left or right */
+  bool side;
+};
 
 class CollisionSystem final
 {
@@ -50,8 +69,34 @@ public:
   bool is_free_of_movingstatics(const Rectf& rect, const CollisionObject* ignore_object) const;
   bool free_line_of_sight(const Vector& line_start, const Vector& line_end, const CollisionObject* ignore_object) const;
 
+  /** Tests many lines at once, the object lookup is shared between
+      all of them. results[i] is set to
+      whether lines[i] is free, returns the number of free lines. With
+      stop_at_first_free the remaining lines are skipped (and left
+      false) once a free line is found. */
+  size_t free_lines_of_sight(const std::vector<std::pair<Vector, Vector> >& lines,
+                             const CollisionObject* ignore_object,
+                             std::vector<bool>& results,
+                             bool stop_at_first_free = false) const;
+
+  /** Tests a batch of particles against the solid tilemaps. Particle
+      i is a 32x32 box at (x[i], y[i]) that moves by speed[i] *
+      direction. Particles are processed sorted by tile column and
+      only tiles set in the solidity mask of a tilemap are looked at.
+      Appends one hit per colliding particle to hits, ordered by
+      index, and returns the number of hits. */
+  size_t collide_particles(const std::vector<float>& x, const std::vector<float>& y,
+                           const std::vector<float>& speed, const Vector& direction,
+                           std::vector<ParticleHit>& hits) const;
+
   std::vector<CollisionObject*> get_nearby_objects(const Vector& center, float max_distance) const;
 
+  /** Moves the object to its current bbox in the spatial index used
+      by the queries above. The index is refreshed automatically in
+      update() and by the CollisionObject setters, only call this when
+      the bbox has been modified directly. */
+  void update_index(CollisionObject& object);
+
 private:
   /** Does collision detection of an object against all other static
       objects (and the tilemap) in the level. Collision response is
@@ -75,10 +120,57 @@ private:
 
   void collision_static_constrains(CollisionObject& object);
 
+  /** COLGROUP_MOVING vs COLGROUP_MOVING, testing every pair */
+  void collision_moving_bruteforce();
+
+  /** COLGROUP_MOVING vs COLGROUP_MOVING, testing only pairs that
+      share a cell of the broadphase grid */
+  void collision_moving_broadphase();
+
+  /** Fills m_moving_pairs with the index pairs (into m_objects) of
+      moving objects that are close enough to possibly collide, sorted
+      in the order the brute-force loop would visit them */
+  void find_moving_pairs();
+
+  /** Walks along the line through the tiles of the solid tilemaps,
+      slopes are tested against their triangle */
+  bool free_line_of_sight_tiles(const Vector& line_start, const Vector& line_end) const;
+
+  bool free_line_of_sight_objects(const Vector& line_start, const Vector& line_end,
+                                  const CollisionObject* ignore_object,
+                                  const std::vector<CollisionObject*>& candidates) const;
+
+  /** Returns the objects that might overlap rect, this is either the
+      result of a spatial index lookup, stored in the caller's buffer,
+      or all objects */
+  const std::vector<CollisionObject*>& get_candidates(const Rectf& rect,
+                                                      std::vector<CollisionObject*>& buffer) const;
+
 private:
   Sector& m_sector;
   std::vector<CollisionObject*>  m_objects;
 
+  /** Broadphase grid of moving objects, rebuilt every update() */
+  SpatialHash<size_t> m_moving_grid;
+  std::vector<std::pair<size_t, size_t> > m_moving_pairs;
+
+  /** Spatial index of the bboxes of all objects, used by the
+      is_free_of_*(), free_line_of_sight() and get_nearby_objects()
+      queries */
+  SpatialHash<CollisionObject*> m_index;
+
+  /** Position of each object in m_objects, to return index lookups in
+      the same order as a scan over m_objects would */
+  std::unordered_map<const CollisionObject*, uint64_t> m_insertion_order;
+  uint64_t m_next_insertion_order;
+
+  /** Scratch buffer for collide_particles(), (tile column, index) */
+  mutable std::vector<std::pair<int, size_t> > m_particle_order;
+
+  /** Scratch buffer for the index lookups of the queries, see
+      get_candidates() */
+  mutable std::vector<CollisionObject*> m_query_buffer;
+
 private:
   CollisionSystem(const CollisionSystem&) = delete;
   CollisionSystem& operator=(const CollisionSystem&) = delete;
@@ -0,0 +1,243 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_COLLISION_SPATIAL_HASH_HPP
+#define HEADER_SUPERTUX_COLLISION_SPATIAL_HASH_HPP
+
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+#include "math/rectf.hpp"
+
+/** Uniform grid that buckets values by the cells their rectangle
+    overlaps. Cells are stored sparsely in a hash map, so the grid has
+    no fixed extent and negative coordinates are fine. */
+template<typename T>
+class SpatialHash final
+{
+private:
+  struct CellRange
+  {
+    int left;
+    int top;
+    int right; // inclusive
+    int bottom; // inclusive
+  };
+
+  struct Entry
+  {
+    T value;
+    CellRange range;
+  };
+
+  struct Cell
+  {
+    std::vector<Entry> entries;
+
+    /** true if the cell is in m_occupied */
+    bool listed;
+  };
+
+public:
+  SpatialHash(float cell_size) :
+    m_cell_size(cell_size),
+    m_cells(),
+    m_occupied(),
+    m_ranges()
+  {
+  }
+
+  /** Removes all values, but keeps the cell storage around so that a
+      grid that is rebuilt every frame doesn't reallocate. */
+  void clear()
+  {
+    for (const auto& key : m_occupied) {
+      auto& cell = m_cells[key];
+      cell.entries.clear();
+      cell.listed = false;
+    }
+    m_occupied.clear();
+    m_ranges.clear();
+  }
+
+  /** Inserts value without remembering where it went, use this for
+      grids that are rebuilt from scratch with clear() */
+  void insert(const T& value, const Rectf& rect)
+  {
+    insert(Entry{value, get_range(rect)});
+  }
+
+  /** Inserts value so that it can later be moved with update() or
+      removed with remove() */
+  void add(const T& value, const Rectf& rect)
+  {
+    const Entry entry{value, get_range(rect)};
+    m_ranges[value] = entry.range;
+    insert(entry);
+  }
+
+  void remove(const T& value)
+  {
+    const auto it = m_ranges.find(value);
+    if (it == m_ranges.end())
+      return;
+
+    erase(Entry{value, it->second});
+    m_ranges.erase(it);
+  }
+
+  /** Moves a value previously inserted with add() to rect, this is
+      cheap when the value stays within the same cells. */
+  void update(const T& value, const Rectf& rect)
+  {
+    const auto it = m_ranges.find(value);
+    if (it == m_ranges.end())
+      return;
+
+    const CellRange range = get_range(rect);
+    if (range.left == it->second.left && range.top == it->second.top &&
+        range.right == it->second.right && range.bottom == it->second.bottom)
+      return;
+
+    erase(Entry{value, it->second});
+    it->second = range;
+    insert(Entry{value, range});
+  }
+
+  /** Calls func(a, b) exactly once for every pair of values whose
+      rectangles share at least one cell. The order of a and b within
+      a pair is unspecified. */
+  template<typename F>
+  void for_each_pair(F func) const
+  {
+    for (const auto& key : m_occupied) {
+      const auto it = m_cells.find(key);
+      const auto& cell = it->second.entries;
+      const int cx = get_key_x(key);
+      const int cy = get_key_y(key);
+
+      for (size_t i = 0; i < cell.size(); ++i) {
+        for (size_t j = i + 1; j < cell.size(); ++j) {
+          // Only report the pair in the first cell both share, so
+          // that large objects don't produce duplicates
+          if (std::max(cell[i].range.left, cell[j].range.left) == cx &&
+              std::max(cell[i].range.top, cell[j].range.top) == cy) {
+            func(cell[i].value, cell[j].value);
+          }
+        }
+      }
+    }
+  }
+
+  /** Appends every value whose cells overlap rect to out, each value
+      at most once. */
+  void query(const Rectf& rect, std::vector<T>& out) const
+  {
+    const CellRange range = get_range(rect);
+    for (int y = range.top; y <= range.bottom; ++y) {
+      for (int x = range.left; x <= range.right; ++x) {
+        const auto it = m_cells.find(make_key(x, y));
+        if (it == m_cells.end())
+          continue;
+
+        for (const auto& entry : it->second.entries) {
+          // Report the value only in the first cell of the query
+          // range that it overlaps
+          if (std::max(entry.range.left, range.left) == x &&
+              std::max(entry.range.top, range.top) == y) {
+            out.push_back(entry.value);
+          }
+        }
+      }
+    }
+  }
+
+  float get_cell_size() const { return m_cell_size; }
+
+private:
+  void insert(const Entry& entry)
+  {
+    for (int y = entry.range.top; y <= entry.range.bottom; ++y) {
+      for (int x = entry.range.left; x <= entry.range.right; ++x) {
+        const uint64_t key = make_key(x, y);
+        auto& cell = m_cells[key];
+        if (!cell.listed) {
+          cell.listed = true;
+          m_occupied.push_back(key);
+        }
+        cell.entries.push_back(entry);
+      }
+    }
+  }
+
+  void erase(const Entry& entry)
+  {
+    for (int y = entry.range.top; y <= entry.range.bottom; ++y) {
+      for (int x = entry.range.left; x <= entry.range.right; ++x) {
+        auto& entries = m_cells[make_key(x, y)].entries;
+        const auto it = std::find_if(entries.begin(), entries.end(),
+                                     [&entry](const Entry& other) {
+                                       return other.value == entry.value;
+                                     });
+        if (it != entries.end()) {
+          *it = entries.back();
+          entries.pop_back();
+        }
+      }
+    }
+  }
+
+  CellRange get_range(const Rectf& rect) const
+  {
+    return CellRange{
+      static_cast<int>(floorf(rect.get_left() / m_cell_size)),
+      static_cast<int>(floorf(rect.get_top() / m_cell_size)),
+      static_cast<int>(floorf(rect.get_right() / m_cell_size)),
+      static_cast<int>(floorf(rect.get_bottom() / m_cell_size))
+    };
+  }
+
+  static uint64_t make_key(int x, int y)
+  {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+      static_cast<uint64_t>(static_cast<uint32_t>(y));
+  }
+
+  static int get_key_x(uint64_t key) { return static_cast<int>(static_cast<uint32_t>(key >> 32)); }
+  static int get_key_y(uint64_t key) { return static_cast<int>(static_cast<uint32_t>(key & 0xffffffff)); }
+
+private:
+  float m_cell_size;
+  std::unordered_map<uint64_t, Cell> m_cells;
+
+  /** Keys of the cells that received a value since the last clear(),
+      cells emptied by remove() stay listed */
+  std::vector<uint64_t> m_occupied;
+
+  /** Cell ranges of the values inserted with add() */
+  std::unordered_map<T, CellRange> m_ranges;
+
+private:
+  SpatialHash(const SpatialHash&) = delete;
+  SpatialHash& operator=(const SpatialHash&) = delete;
+};
+
+#endif
+
+/* EOF */
@@ -16,6 +16,7 @@
 
 #include "editor/editor.hpp"
 
+#include <algorithm>
 #include <limits>
 #include <physfs.h>
 
@@ -392,7 +393,6 @@ Editor::delete_current_sector()
 void
 Editor::set_level(std::unique_ptr<Level> level, bool reset)
 {
-  m_undo_manager->reset_index();
   std::string sector_name = "main";
   Vector translation;
 
@@ -433,6 +433,8 @@ Editor::set_level(std::unique_ptr<Level> level, bool reset)
   m_layers_widget->refresh_sector_text();
   m_toolbox_widget->update_mouse_icon();
   m_overlay_widget->on_level_change();
+
+  m_undo_manager->reset(*m_level);
 }
 
 void
@@ -751,26 +753,60 @@ void
 Editor::undo()
 {
   log_info << "attempting undo" << std::endl;
-  auto level = m_undo_manager->undo();
-  if (level) {
-    set_level(std::move(level), false);
-    m_ignore_sector_change = true;
-  } else {
+  if (!m_level) return;
+
+  const auto sector_index = get_sector_index();
+  const Vector translation = m_sector->get_camera().get_translation();
+  m_overlay_widget->delete_markers();
+
+  if (!m_undo_manager->undo(*m_level)) {
     log_info << "undo failed" << std::endl;
   }
+
+  // a failed step might have changed the level halfway as well
+  after_undo_redo(sector_index, translation);
 }
 
 void
 Editor::redo()
 {
   log_info << "attempting redo" << std::endl;
-  auto level = m_undo_manager->redo();
-  if (level) {
-    set_level(std::move(level), false);
-    m_ignore_sector_change = true;
-  } else {
+  if (!m_level) return;
+
+  const auto sector_index = get_sector_index();
+  const Vector translation = m_sector->get_camera().get_translation();
+  m_overlay_widget->delete_markers();
+
+  if (!m_undo_manager->redo(*m_level)) {
     log_info << "redo failed" << std::endl;
   }
+
+  // a failed step might have changed the level halfway as well
+  after_undo_redo(sector_index, translation);
+}
+
+size_t
+Editor::get_sector_index() const
+{
+  for (size_t i = 0; i < m_level->m_sectors.size(); ++i) {
+    if (m_level->m_sectors[i].get() == m_sector) {
+      return i;
+    }
+  }
+  return 0;
+}
+
+void
+Editor::after_undo_redo(size_t sector_index, const Vector& translation)
+{
+  // the undo manager recreates the objects it touches and might have
+  // replaced whole sectors, so the sector gets set up again
+  m_overlay_widget->on_level_change();
+  set_sector(m_level->get_sector(std::min(sector_index, m_level->get_sector_count() - 1)));
+  m_sector->get_camera().set_mode(Camera::Mode::MANUAL);
+  m_sector->get_camera().set_translation(translation);
+  m_layers_widget->refresh_sector_text();
+  m_ignore_sector_change = true;
 }
 
 /* EOF */
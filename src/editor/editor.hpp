@@ -131,6 +131,10 @@ public:
   void undo();
   void redo();
 
+  /** Edits that change the level have to be recorded here, see
+      UndoManager::record_object() */
+  UndoManager& get_undo_manager() { return *m_undo_manager; }
+
 private:
   void set_sector(Sector* sector);
   void set_level(std::unique_ptr<Level> level, bool reset = true);
@@ -138,6 +142,8 @@ private:
   void quit_editor();
   void save_level();
   void test_level();
+  size_t get_sector_index() const;
+  void after_undo_redo(size_t sector_index, const Vector& translation);
   void update_keyboard(const Controller& controller);
 
 protected:
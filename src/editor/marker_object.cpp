@@ -25,14 +25,14 @@
 
 MarkerObject::MarkerObject (const Vector& pos)
 {
-  m_col.m_bbox.set_p1(pos);
-  m_col.m_bbox.set_size(16, 16);
+  m_col.set_pos(pos);
+  m_col.set_size(16, 16);
 }
 
 MarkerObject::MarkerObject ()
 {
-  m_col.m_bbox.set_p1(Vector(0, 0));
-  m_col.m_bbox.set_p2(Vector(16, 16));
+  m_col.set_pos(Vector(0, 0));
+  m_col.set_size(16, 16);
 }
 
 void
@@ -17,6 +17,7 @@
 #include "editor/object_menu.hpp"
 
 #include "editor/editor.hpp"
+#include "editor/undo_manager.hpp"
 #include "gui/menu_item.hpp"
 #include "gui/menu_manager.hpp"
 #include "supertux/d_scope.hpp"
@@ -28,6 +29,8 @@ ObjectMenu::ObjectMenu(Editor& editor, GameObject* go) :
   m_editor(editor),
   m_object(go)
 {
+  m_editor.get_undo_manager().record_object(*m_object);
+
   ObjectSettings os = m_object->get_settings();
   add_label(os.get_name());
   add_hl();
@@ -26,6 +26,7 @@
 #include "editor/object_info.hpp"
 #include "editor/tile_selection.hpp"
 #include "editor/tip.hpp"
+#include "editor/undo_manager.hpp"
 #include "editor/util.hpp"
 #include "editor/worldmap_objects.hpp"
 #include "gui/menu.hpp"
@@ -155,6 +156,7 @@ EditorOverlayWidget::input_tile(const Vector& pos, uint32_t tile)
     return;
   }
 
+  m_editor.get_undo_manager().record_tile(*tilemap, static_cast<int>(pos.x), static_cast<int>(pos.y));
   tilemap->change(static_cast<int>(pos.x), static_cast<int>(pos.y), tile);
 }
 
@@ -436,6 +438,7 @@ EditorOverlayWidget::move_object()
         new_pos -= pm->get_offset();
       }
     }
+    record_change(*m_dragged_object);
     m_dragged_object->move_to(new_pos);
   }
 }
@@ -447,6 +450,7 @@ EditorOverlayWidget::rubber_object()
     delete_markers();
   }
   if (m_dragged_object) {
+    record_change(*m_dragged_object);
     m_dragged_object->editor_delete();
   }
   m_last_node_marker = nullptr;
@@ -487,6 +491,7 @@ EditorOverlayWidget::add_path_node()
   Path::Node new_node;
   new_node.position = m_sector_pos;
   new_node.time = 1;
+  record_change(*m_last_node_marker);
   m_edited_path->m_nodes.insert(m_last_node_marker->m_node + 1, new_node);
   Sector::get().add<NodeMarker>(m_edited_path, m_edited_path->m_nodes.end() - 1, m_edited_path->m_nodes.size() - 1);
   //last_node_marker = dynamic_cast<NodeMarker*>(marker.get());
@@ -495,6 +500,15 @@ EditorOverlayWidget::add_path_node()
   grab_object();
 }
 
+void
+EditorOverlayWidget::record_change(GameObject& object)
+{
+  GameObject* changed = dynamic_cast<MarkerObject*>(&object) ? m_selected_object : &object;
+  if (changed && changed->is_valid()) {
+    m_editor.get_undo_manager().record_object(*changed);
+  }
+}
+
 void
 EditorOverlayWidget::put_object()
 {
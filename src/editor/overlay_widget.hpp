@@ -81,6 +81,10 @@ private:
   void select_object();
   void add_path_node();
 
+  /** Tells the UndoManager that object gets changed, for markers
+      that is the selected object they belong to */
+  void record_change(GameObject& object);
+
   void draw_tile_tip(DrawingContext&);
   void draw_tile_grid(DrawingContext&, const Color& line_color, int tile_size = 32);
   void draw_tilemap_border(DrawingContext&);
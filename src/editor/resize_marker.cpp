@@ -18,8 +18,10 @@
 
 #include "editor/resize_marker.hpp"
 
-ResizeMarker::ResizeMarker(Rectf* rect, Side vert, Side horz) :
-  m_rect(rect),
+#include "collision/collision_object.hpp"
+
+ResizeMarker::ResizeMarker(CollisionObject* object, Side vert, Side horz) :
+  m_object(object),
   m_vert(vert),
   m_horz(horz)
 {
@@ -35,35 +37,36 @@ ResizeMarker::editor_update()
 void
 ResizeMarker::refresh_pos()
 {
+  const Rectf& rect = m_object->get_bbox();
   Vector new_pos;
 
   switch (m_vert)
   {
     case Side::NONE:
-      new_pos.y = (m_rect->get_top() + m_rect->get_bottom())/2 - 8;
+      new_pos.y = (rect.get_top() + rect.get_bottom())/2 - 8;
       break;
 
     case Side::LEFT_UP:
-      new_pos.y = m_rect->get_top() - 16;
+      new_pos.y = rect.get_top() - 16;
       break;
 
     case Side::RIGHT_DOWN:
-      new_pos.y = m_rect->get_bottom();
+      new_pos.y = rect.get_bottom();
       break;
   }
 
   switch (m_horz)
   {
     case Side::NONE:
-      new_pos.x = (m_rect->get_left() + m_rect->get_right())/2 - 8;
+      new_pos.x = (rect.get_left() + rect.get_right())/2 - 8;
       break;
 
     case Side::LEFT_UP:
-      new_pos.x = m_rect->get_left() - 16;
+      new_pos.x = rect.get_left() - 16;
       break;
 
     case Side::RIGHT_DOWN:
-      new_pos.x = m_rect->get_right();
+      new_pos.x = rect.get_right();
       break;
   }
 
@@ -73,14 +76,16 @@ ResizeMarker::refresh_pos()
 void
 ResizeMarker::move_to(const Vector& pos)
 {
+  Rectf rect = m_object->get_bbox();
+
   switch (m_vert) {
     case Side::NONE:
       break;
     case Side::LEFT_UP:
-      m_rect->set_top(std::min(pos.y + 16, m_rect->get_bottom() - 2));
+      rect.set_top(std::min(pos.y + 16, rect.get_bottom() - 2));
       break;
     case Side::RIGHT_DOWN:
-      m_rect->set_bottom(std::max(pos.y, m_rect->get_top() + 2));
+      rect.set_bottom(std::max(pos.y, rect.get_top() + 2));
       break;
   }
 
@@ -88,13 +93,16 @@ ResizeMarker::move_to(const Vector& pos)
     case Side::NONE:
       break;
     case Side::LEFT_UP:
-      m_rect->set_left(std::min(pos.x + 16, m_rect->get_right() - 2));
+      rect.set_left(std::min(pos.x + 16, rect.get_right() - 2));
       break;
     case Side::RIGHT_DOWN:
-      m_rect->set_right(std::max(pos.x, m_rect->get_left() + 2));
+      rect.set_right(std::max(pos.x, rect.get_left() + 2));
       break;
   }
 
+  m_object->set_pos(rect.p1());
+  m_object->set_size(rect.get_width(), rect.get_height());
+
   refresh_pos();
 }
 
@@ -20,6 +20,8 @@
 
 #include "editor/marker_object.hpp"
 
+class CollisionObject;
+
 class ResizeMarker : public MarkerObject
 {
 public:
@@ -30,7 +32,7 @@ public:
   };
 
 public:
-  ResizeMarker(Rectf* rect, Side vert, Side horz);
+  ResizeMarker(CollisionObject* object, Side vert, Side horz);
 
   virtual void move_to(const Vector& pos) override;
   virtual Vector get_point_vector() const override;
@@ -42,7 +44,7 @@ private:
   void refresh_pos();
 
 private:
-  Rectf* m_rect;
+  CollisionObject* m_object;
   Side m_vert;
   Side m_horz;
 
@@ -0,0 +1,62 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "editor/tile_diff.hpp"
+
+#include <assert.h>
+#include <stddef.h>
+
+TileDiff::TileDiff(int width) :
+  m_width(width),
+  m_recorded(),
+  m_cells(),
+  m_old_tiles(),
+  m_new_tiles()
+{
+}
+
+void
+TileDiff::record(int x, int y, uint32_t old_tile)
+{
+  // emplace() keeps the tile of an earlier write
+  m_recorded.emplace(static_cast<uint32_t>(y * m_width + x), old_tile);
+}
+
+void
+TileDiff::finish(const std::vector<uint32_t>& tiles)
+{
+  for (const auto& it : m_recorded)
+  {
+    assert(it.first < tiles.size());
+    if (it.second != tiles[it.first]) {
+      m_cells.push_back(it.first);
+      m_old_tiles.push_back(it.second);
+      m_new_tiles.push_back(tiles[it.first]);
+    }
+  }
+  m_recorded.clear();
+}
+
+void
+TileDiff::apply(std::vector<uint32_t>& tiles, bool forward) const
+{
+  const auto& values = get_tiles(forward);
+  for (size_t i = 0; i < m_cells.size(); ++i) {
+    tiles[m_cells[i]] = values[i];
+  }
+}
+
+/* EOF */
@@ -0,0 +1,61 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_EDITOR_TILE_DIFF_HPP
+#define HEADER_SUPERTUX_EDITOR_TILE_DIFF_HPP
+
+#include <map>
+#include <stdint.h>
+#include <vector>
+
+/** Changed cells of a tilemap in one undo step, cells are
+    y * width + x. The editor records the old tile of a cell before
+    it writes to it, finish() then picks up the new tiles. */
+class TileDiff final
+{
+public:
+  TileDiff(int width);
+
+  /** Remembers the tile of a cell before it gets written to, only the
+      first write to a cell within a step counts */
+  void record(int x, int y, uint32_t old_tile);
+
+  /** Takes the new tiles of the recorded cells from tiles and drops
+      the cells that ended up unchanged */
+  void finish(const std::vector<uint32_t>& tiles);
+
+  /** Writes the new (forward) or the old tiles into tiles */
+  void apply(std::vector<uint32_t>& tiles, bool forward) const;
+
+  bool empty() const { return m_cells.empty(); }
+  int get_width() const { return m_width; }
+  const std::vector<uint32_t>& get_cells() const { return m_cells; }
+  const std::vector<uint32_t>& get_tiles(bool forward) const { return forward ? m_new_tiles : m_old_tiles; }
+
+private:
+  int m_width;
+
+  /** cell -> old tile, while the step is recorded */
+  std::map<uint32_t, uint32_t> m_recorded;
+
+  std::vector<uint32_t> m_cells;
+  std::vector<uint32_t> m_old_tiles;
+  std::vector<uint32_t> m_new_tiles;
+};
+
+#endif
+
+/* EOF */
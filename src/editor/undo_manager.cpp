@@ -16,42 +16,141 @@
 
 #include "editor/undo_manager.hpp"
 
-#include <sstream>
+#include <algorithm>
 #include <iostream>
+#include <sstream>
 
-#include "editor/editor.hpp"
+#include "editor/object_option.hpp"
+#include "editor/object_settings.hpp"
+#include "object/tilemap.hpp"
+#include "supertux/game_object_factory.hpp"
 #include "supertux/level.hpp"
-#include "supertux/level_parser.hpp"
+#include "supertux/sector.hpp"
+#include "supertux/sector_parser.hpp"
 #include "util/log.hpp"
+#include "util/reader_document.hpp"
 #include "util/reader_mapping.hpp"
+#include "util/writer.hpp"
+
+namespace {
+
+bool is_saved(const GameObject& object)
+{
+  return object.is_saveable() && object.is_valid();
+}
+
+} // namespace
+
+bool
+UndoManager::LevelProperties::operator!=(const LevelProperties& other) const
+{
+  return (name != other.name ||
+          author != other.author ||
+          contact != other.contact ||
+          license != other.license ||
+          tileset != other.tileset ||
+          target_time != other.target_time ||
+          suppress_pause_menu != other.suppress_pause_menu);
+}
+
+bool
+UndoManager::ObjectState::operator!=(const ObjectState& other) const
+{
+  return (sector != other.sector ||
+          type != other.type ||
+          body != other.body ||
+          width != other.width ||
+          height != other.height);
+}
 
 UndoManager::UndoManager() :
   m_max_snapshots(100),
   m_index_pos(),
   m_undo_stack(),
-  m_redo_stack()
+  m_redo_stack(),
+  m_state(),
+  m_has_state(false),
+  m_recorded_objects(),
+  m_recorded_tiles()
 {
 }
 
 void
-UndoManager::try_snapshot(Level& level)
+UndoManager::reset(Level& level)
 {
-  std::ostringstream out;
-  level.save(out);
-  std::string level_snapshot = out.str();
+  m_undo_stack.clear();
+  m_redo_stack.clear();
+  m_index_pos = 0;
+
+  capture(level, m_state);
+  m_has_state = true;
+  clear_records();
+}
 
-  if (m_undo_stack.empty())
+void
+UndoManager::try_snapshot(Level& level)
+{
+  if (!m_has_state)
   {
-    push_undo_stack(std::move(level_snapshot));
+    capture(level, m_state);
+    m_has_state = true;
+    clear_records();
+    return;
   }
-  else if (level_snapshot == m_undo_stack.back())
+
+  Step step = make_step(level);
+  if (!step.structural &&
+      !(step.properties_before != step.properties_after) &&
+      step.sectors.empty() &&
+      step.objects.empty() &&
+      step.tiles.empty())
   {
     log_debug << "skipping snapshot as nothing has changed" << std::endl;
+    return;
   }
-  else // level_snapshot changed
-  {
-    push_undo_stack(std::move(level_snapshot));
+
+  log_info << "doing snapshot" << std::endl;
+
+  m_redo_stack.clear();
+  m_undo_stack.push_back(std::move(step));
+  m_index_pos += 1;
+
+  cleanup();
+
+  debug_print("snapshot");
+}
+
+void
+UndoManager::record_object(const GameObject& object)
+{
+  m_recorded_objects.insert(object.get_uid());
+}
+
+void
+UndoManager::record_sector(Sector& sector)
+{
+  for (const auto& object : sector.get_objects()) {
+    if (is_saved(*object)) {
+      m_recorded_objects.insert(object->get_uid());
+    }
+  }
+}
+
+void
+UndoManager::record_tile(const TileMap& tilemap, int x, int y)
+{
+  auto it = m_recorded_tiles.find(tilemap.get_uid());
+  if (it == m_recorded_tiles.end()) {
+    it = m_recorded_tiles.emplace(tilemap.get_uid(), TileDiff(tilemap.get_width())).first;
   }
+  it->second.record(x, y, tilemap.get_tile_id(x, y));
+}
+
+void
+UndoManager::clear_records()
+{
+  m_recorded_objects.clear();
+  m_recorded_tiles.clear();
 }
 
 void
@@ -59,82 +158,540 @@ UndoManager::debug_print(const char* action)
 {
 #if 0
   std::cout << action << std::endl;
-  std::cout << "undo_stack: ";
-  for(size_t i = 0; i < m_undo_stack.size(); ++i) {
-    std::cout << static_cast<const void*>(m_undo_stack[i].data()) << " ";
-  }
-  std::cout << std::endl;
-
-  std::cout << "redo_stack: ";
-  for(size_t i = 0; i < m_redo_stack.size(); ++i) {
-    std::cout << static_cast<const void*>(m_redo_stack[i].data()) << " ";
-  }
-  std::cout << std::endl;
+  std::cout << "undo_stack: " << m_undo_stack.size() << " steps" << std::endl;
+  std::cout << "redo_stack: " << m_redo_stack.size() << " steps" << std::endl;
   std::cout << std::endl;
 #endif
 }
 
 void
-UndoManager::push_undo_stack(std::string&& level_snapshot)
+UndoManager::cleanup()
 {
-  log_info << "doing snapshot" << std::endl;
+  if (m_undo_stack.size() > m_max_snapshots) {
+    m_undo_stack.erase(m_undo_stack.begin(),
+                       m_undo_stack.end() - m_max_snapshots);
+  }
+}
 
-  m_redo_stack.clear();
-  m_undo_stack.push_back(std::move(level_snapshot));
+bool
+UndoManager::undo(Level& level)
+{
+  // edits that weren't snapshotted yet are undone first
+  try_snapshot(level);
+
+  if (m_undo_stack.empty()) return false;
+
+  if (!apply(level, m_undo_stack.back(), false)) {
+    log_warning << "undo failed, clearing undo history" << std::endl;
+    m_undo_stack.clear();
+    m_redo_stack.clear();
+    capture(level, m_state);
+    return false;
+  }
+
+  m_redo_stack.push_back(std::move(m_undo_stack.back()));
+  m_undo_stack.pop_back();
+  m_index_pos -= 1;
+
+  debug_print("undo");
+
+  return true;
+}
+
+bool
+UndoManager::redo(Level& level)
+{
+  try_snapshot(level);
+
+  if (m_redo_stack.empty()) return false;
+
+  if (!apply(level, m_redo_stack.back(), true)) {
+    log_warning << "redo failed, clearing undo history" << std::endl;
+    m_undo_stack.clear();
+    m_redo_stack.clear();
+    capture(level, m_state);
+    return false;
+  }
+
+  m_undo_stack.push_back(std::move(m_redo_stack.back()));
+  m_redo_stack.pop_back();
   m_index_pos += 1;
 
-  cleanup();
+  debug_print("redo");
 
-  debug_print("snapshot");
+  return true;
 }
 
 void
-UndoManager::cleanup()
+UndoManager::capture_properties(const Level& level, LevelProperties& properties)
 {
-  while (m_undo_stack.size() > m_max_snapshots) {
-    m_undo_stack.erase(m_undo_stack.end() - m_max_snapshots,
-                       m_undo_stack.end());
+  properties.name = level.m_name;
+  properties.author = level.m_author;
+  properties.contact = level.m_contact;
+  properties.license = level.m_license;
+  properties.tileset = level.m_tileset;
+  properties.target_time = level.m_target_time;
+  properties.suppress_pause_menu = level.m_suppress_pause_menu;
+}
+
+UndoManager::ObjectState
+UndoManager::capture_object(GameObject& object, size_t sector)
+{
+  auto tilemap = dynamic_cast<TileMap*>(&object);
+
+  ObjectState state;
+  state.sector = sector;
+  state.type = object.get_class();
+  state.body = save_body(object, tilemap != nullptr);
+  state.tilemap = (tilemap != nullptr);
+  state.width = tilemap ? tilemap->get_width() : 0;
+  state.height = tilemap ? tilemap->get_height() : 0;
+  if (tilemap) {
+    state.tiles = tilemap->get_tiles();
   }
+  return state;
 }
 
-std::unique_ptr<Level>
-UndoManager::undo()
+void
+UndoManager::capture(Level& level, LevelState& state) const
 {
-  if (m_undo_stack.size() < 2) return {};
+  capture_properties(level, state.properties);
 
-  m_redo_stack.push_back(std::move(m_undo_stack.back()));
-  m_undo_stack.pop_back();
+  state.sectors.clear();
+  state.objects.clear();
 
-  std::istringstream in(m_undo_stack.back());
-  ReaderMapping::s_translations_enabled = false;
-  auto level = LevelParser::from_stream(in, "<undo_stack>", Editor::current()->get_level()->is_worldmap(), true);
-  ReaderMapping::s_translations_enabled = true;
+  for (size_t i = 0; i < level.get_sector_count(); ++i)
+  {
+    Sector& sector = *level.get_sector(i);
+    BIND_SECTOR(sector);
 
-  m_index_pos -= 1;
+    SectorState sector_state;
+    sector_state.sector = &sector;
+    sector_state.name = sector.get_name();
+    sector_state.gravity = sector.get_gravity();
+    sector_state.init_script = sector.get_init_script();
 
-  debug_print("undo");
+    for (const auto& object : sector.get_objects())
+    {
+      if (!is_saved(*object))
+        continue;
 
-  return level;
+      sector_state.objects.push_back(object->get_uid());
+      state.objects[object->get_uid()] = capture_object(*object, i);
+    }
+
+    state.sectors.push_back(std::move(sector_state));
+  }
 }
 
-std::unique_ptr<Level>
-UndoManager::redo()
+bool
+UndoManager::is_structural(const Level& level) const
 {
-  if (m_redo_stack.empty()) return {};
+  if (level.get_sector_count() != m_state.sectors.size())
+    return true;
 
-  m_undo_stack.push_back(std::move(m_redo_stack.back()));
-  m_redo_stack.pop_back();
+  for (size_t i = 0; i < m_state.sectors.size(); ++i) {
+    if (level.get_sector(i) != m_state.sectors[i].sector)
+      return true;
+  }
 
-  m_index_pos += 1;
+  return false;
+}
+
+UndoManager::Step
+UndoManager::make_step(Level& level)
+{
+  Step step;
+  step.properties_before = m_state.properties;
+  capture_properties(level, step.properties_after);
+  m_state.properties = step.properties_after;
+  step.structural = is_structural(level);
+
+  if (step.structural)
+  {
+    // sectors were added, removed or replaced, this is rare enough to
+    // store the complete sectors
+    for (size_t i = 0; i < m_state.sectors.size(); ++i) {
+      step.sectors_before.push_back(write_sector(m_state, i));
+      const auto uids = saved_order(m_state, i);
+      step.uids_before.insert(step.uids_before.end(), uids.begin(), uids.end());
+    }
+
+    capture(level, m_state);
+
+    for (size_t i = 0; i < m_state.sectors.size(); ++i) {
+      step.sectors_after.push_back(write_sector(m_state, i));
+      const auto uids = saved_order(m_state, i);
+      step.uids_after.insert(step.uids_after.end(), uids.begin(), uids.end());
+    }
+
+    clear_records();
+    return step;
+  }
+
+  // objects that are saved as a whole in this step
+  std::unordered_set<UID> replaced;
+
+  for (size_t i = 0; i < m_state.sectors.size(); ++i)
+  {
+    Sector& sector = *level.get_sector(i);
+    BIND_SECTOR(sector);
+
+    SectorState& sector_state = m_state.sectors[i];
+    if (sector_state.name != sector.get_name() ||
+        sector_state.gravity != sector.get_gravity() ||
+        sector_state.init_script != sector.get_init_script())
+    {
+      SectorDiff diff{i, sector_state, sector_state};
+      diff.after.name = sector.get_name();
+      diff.after.gravity = sector.get_gravity();
+      diff.after.init_script = sector.get_init_script();
+      sector_state = diff.after;
+      step.sectors.push_back(std::move(diff));
+    }
+
+    // diffs follow the order of the objects in the sector, so undo
+    // recreates them in the order they were created in
+    std::vector<UID> objects;
+    for (const auto& object : sector.get_objects())
+    {
+      if (!is_saved(*object))
+        continue;
+
+      const UID uid = object->get_uid();
+      objects.push_back(uid);
+
+      auto it = m_state.objects.find(uid);
+      if (it == m_state.objects.end())
+      {
+        ObjectState after = capture_object(*object, i);
+        step.objects.push_back(ObjectDiff{uid, boost::none, after});
+        m_state.objects.emplace(uid, std::move(after));
+        replaced.insert(uid);
+      }
+      else if (m_recorded_objects.count(uid))
+      {
+        ObjectState after = capture_object(*object, i);
+        if (it->second != after) {
+          step.objects.push_back(ObjectDiff{uid, it->second, after});
+          it->second = std::move(after);
+          replaced.insert(uid);
+        }
+      }
+    }
+
+    if (objects != sector_state.objects)
+    {
+      const std::unordered_set<UID> present(objects.begin(), objects.end());
+      for (const UID& uid : sector_state.objects)
+      {
+        if (present.count(uid))
+          continue;
+
+        auto it = m_state.objects.find(uid);
+        step.objects.push_back(ObjectDiff{uid, std::move(it->second), boost::none});
+        m_state.objects.erase(it);
+        replaced.insert(uid);
+      }
+      sector_state.objects = std::move(objects);
+    }
+  }
+
+  for (auto& it : m_recorded_tiles)
+  {
+    const UID& uid = it.first;
+    TileDiff& tiles = it.second;
+    if (replaced.count(uid))
+      continue;
+
+    auto state = m_state.objects.find(uid);
+    if (state == m_state.objects.end())
+      continue;
+
+    auto tilemap = level.get_sector(state->second.sector)->get_object_by_uid<TileMap>(uid);
+    if (!tilemap)
+      continue;
+
+    if (tilemap->get_width() != state->second.width ||
+        tilemap->get_height() != state->second.height)
+    {
+      // resized without record_sector()
+      ObjectState after = capture_object(*tilemap, state->second.sector);
+      step.objects.push_back(ObjectDiff{uid, state->second, after});
+      state->second = std::move(after);
+      continue;
+    }
+
+    tiles.finish(tilemap->get_tiles());
+    if (!tiles.empty()) {
+      tiles.apply(state->second.tiles, true);
+      step.tiles.push_back(TilemapDiff{uid, state->second.sector, std::move(tiles)});
+    }
+  }
+
+  clear_records();
+  return step;
+}
+
+bool
+UndoManager::apply(Level& level, const Step& step, bool forward)
+{
+  const LevelProperties& properties = forward ? step.properties_after : step.properties_before;
+  level.m_name = properties.name;
+  level.m_author = properties.author;
+  level.m_contact = properties.contact;
+  level.m_license = properties.license;
+  level.m_tileset = properties.tileset;
+  level.m_target_time = properties.target_time;
+  level.m_suppress_pause_menu = properties.suppress_pause_menu;
+  m_state.properties = properties;
+
+  std::unordered_map<UID, UID> remap;
+  bool success = true;
 
-  std::istringstream in(m_undo_stack.back());
   ReaderMapping::s_translations_enabled = false;
-  auto level = LevelParser::from_stream(in, "<redo_stack>", Editor::current()->get_level()->is_worldmap(), true);
+
+  if (step.structural)
+  {
+    const auto& sectors = forward ? step.sectors_after : step.sectors_before;
+    const auto& uids = forward ? step.uids_after : step.uids_before;
+
+    level.m_sectors.clear();
+    for (const auto& text : sectors)
+    {
+      std::istringstream in(text);
+      auto doc = ReaderDocument::from_stream(in, "<undo_stack>");
+      auto root = doc.get_root();
+      level.m_sectors.push_back(SectorParser::from_reader(level, root.get_mapping(), true));
+    }
+
+    // the reparsed objects got new UIDs, they come back in the same
+    // save order though
+    capture(level, m_state);
+    std::vector<UID> new_uids;
+    for (size_t i = 0; i < m_state.sectors.size(); ++i) {
+      const auto sector_uids = saved_order(m_state, i);
+      new_uids.insert(new_uids.end(), sector_uids.begin(), sector_uids.end());
+    }
+
+    if (new_uids.size() == uids.size()) {
+      for (size_t i = 0; i < uids.size(); ++i) {
+        remap[uids[i]] = new_uids[i];
+      }
+    } else {
+      log_warning << "objects got lost while restoring sectors" << std::endl;
+      success = false;
+    }
+  }
+  else
+  {
+    for (const auto& diff : step.sectors)
+    {
+      const SectorState& sector_state = forward ? diff.after : diff.before;
+      Sector& sector = *level.get_sector(diff.index);
+      sector.set_name(sector_state.name);
+      sector.set_gravity(sector_state.gravity);
+      sector.set_init_script(sector_state.init_script);
+
+      m_state.sectors[diff.index].name = sector_state.name;
+      m_state.sectors[diff.index].gravity = sector_state.gravity;
+      m_state.sectors[diff.index].init_script = sector_state.init_script;
+    }
+
+    for (const auto& diff : step.objects)
+    {
+      const auto& current = forward ? diff.before : diff.after;
+      if (current) {
+        Sector& sector = *level.get_sector(current->sector);
+        if (auto object = sector.get_object_by_uid<GameObject>(diff.uid)) {
+          object->remove_me();
+        } else {
+          success = false;
+        }
+        m_state.objects.erase(diff.uid);
+      }
+    }
+
+    for (const auto& diff : step.objects)
+    {
+      const auto& target = forward ? diff.after : diff.before;
+      if (!target)
+        continue;
+
+      Sector& sector = *level.get_sector(target->sector);
+      BIND_SECTOR(sector);
+
+      std::stringstream stream;
+      {
+        Writer writer(stream);
+        write_object(writer, stream, *target);
+      }
+
+      try
+      {
+        auto doc = ReaderDocument::from_stream(stream, "<undo_stack>");
+        auto object_sx = doc.get_root();
+        GameObject& object = sector.add_object(GameObjectFactory::instance().create(object_sx.get_name(),
+                                                                                    object_sx.get_mapping()));
+        object.after_editor_set();
+        remap[diff.uid] = object.get_uid();
+        m_state.objects[object.get_uid()] = *target;
+      }
+      catch(const std::exception& err)
+      {
+        log_warning << "failed to restore '" << target->type << "': " << err.what() << std::endl;
+        success = false;
+      }
+    }
+
+    for (const auto& diff : step.tiles)
+    {
+      auto tilemap = level.get_sector(diff.sector)->get_object_by_uid<TileMap>(diff.uid);
+      auto state = m_state.objects.find(diff.uid);
+      if (!tilemap || state == m_state.objects.end()) {
+        success = false;
+        continue;
+      }
+
+      const auto& cells = diff.tiles.get_cells();
+      const auto& tiles = diff.tiles.get_tiles(forward);
+      const int width = diff.tiles.get_width();
+      for (size_t i = 0; i < cells.size(); ++i) {
+        tilemap->change(static_cast<int>(cells[i]) % width,
+                        static_cast<int>(cells[i]) / width,
+                        tiles[i]);
+      }
+      diff.tiles.apply(state->second.tiles, forward);
+    }
+  }
+
   ReaderMapping::s_translations_enabled = true;
 
-  debug_print("redo");
+  for (size_t i = 0; i < level.m_sectors.size(); ++i)
+  {
+    Sector& sector = *level.m_sectors[i];
+    sector.flush_game_objects();
+
+    if (!step.structural)
+    {
+      auto& objects = m_state.sectors[i].objects;
+      objects.clear();
+      for (const auto& object : sector.get_objects()) {
+        if (is_saved(*object)) {
+          objects.push_back(object->get_uid());
+        }
+      }
+    }
+  }
+
+  remap_uids(remap);
+
+  return success;
+}
+
+void
+UndoManager::remap_uids(const std::unordered_map<UID, UID>& remap)
+{
+  if (remap.empty())
+    return;
+
+  auto map_uid = [&remap](UID& uid) {
+    const auto it = remap.find(uid);
+    if (it != remap.end()) {
+      uid = it->second;
+    }
+  };
+
+  for (auto stack : {&m_undo_stack, &m_redo_stack})
+  {
+    for (auto& step : *stack)
+    {
+      for (auto& diff : step.objects) {
+        map_uid(diff.uid);
+      }
+      for (auto& diff : step.tiles) {
+        map_uid(diff.uid);
+      }
+      for (auto& diff : step.sectors) {
+        std::for_each(diff.before.objects.begin(), diff.before.objects.end(), map_uid);
+        std::for_each(diff.after.objects.begin(), diff.after.objects.end(), map_uid);
+      }
+      std::for_each(step.uids_before.begin(), step.uids_before.end(), map_uid);
+      std::for_each(step.uids_after.begin(), step.uids_after.end(), map_uid);
+    }
+  }
+}
+
+std::string
+UndoManager::save_body(GameObject& object, bool skip_tiles)
+{
+  std::ostringstream out;
+  Writer writer(out);
+  writer.start_list(object.get_class());
+  const auto start = static_cast<size_t>(out.tellp());
+
+  auto settings = object.get_settings();
+  for (const auto& option : settings.get_options())
+  {
+    // tiles are diffed separately
+    if (skip_tiles && option->get_key() == "tiles")
+      continue;
+
+    option->save(writer);
+  }
+
+  std::string body = out.str().substr(start);
+  writer.end_list(object.get_class());
+  return body;
+}
+
+void
+UndoManager::write_object(Writer& writer, std::ostream& out, const ObjectState& object)
+{
+  writer.start_list(object.type);
+  out << object.body;
+  if (object.tilemap) {
+    writer.write("width", object.width);
+    writer.write("height", object.height);
+    writer.write("tiles", object.tiles, object.width);
+  }
+  writer.end_list(object.type);
+}
+
+std::vector<UID>
+UndoManager::saved_order(const LevelState& state, size_t index)
+{
+  std::vector<UID> uids = state.sectors[index].objects;
+  std::stable_sort(uids.begin(), uids.end(),
+                   [&state](const UID& lhs, const UID& rhs) {
+                     return state.objects.find(lhs)->second.type < state.objects.find(rhs)->second.type;
+                   });
+  return uids;
+}
+
+std::string
+UndoManager::write_sector(const LevelState& state, size_t index)
+{
+  const SectorState& sector = state.sectors[index];
+
+  std::ostringstream out;
+  Writer writer(out);
+  writer.start_list("sector", false);
+  writer.write("name", sector.name, false);
+  if (sector.gravity != 10.0f) {
+    writer.write("gravity", sector.gravity);
+  }
+  if (!sector.init_script.empty()) {
+    writer.write("init-script", sector.init_script, false);
+  }
+
+  // same order as Sector::save(), so the objects come back in it
+  for (const auto& uid : saved_order(state, index)) {
+    write_object(writer, out, state.objects.find(uid)->second);
+  }
 
-  return level;
+  writer.end_list("sector");
+  return out.str();
 }
 
 /* EOF */
@@ -17,43 +17,201 @@
 #ifndef HEADER_SUPERTUX_EDITOR_UNDO_MANAGER_HPP
 #define HEADER_SUPERTUX_EDITOR_UNDO_MANAGER_HPP
 
-#include <vector>
+#include <boost/optional.hpp>
+#include <ostream>
+#include <stdint.h>
 #include <string>
-#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "editor/tile_diff.hpp"
+#include "util/uid.hpp"
 
+class GameObject;
 class Level;
+class Sector;
+class TileMap;
+class Writer;
 
-class UndoManager
+/** Editing history of a level. Instead of copies of the whole level
+    each step only holds what changed: sparse cell diffs for tilemaps,
+    the old and new state of objects that were added, removed or
+    modified and changed sector and level properties. The editor
+    records tile writes and the objects it changes while it edits, so
+    a snapshot doesn't need to save the whole level. Steps are applied
+    to the live level in place. */
+class UndoManager final
 {
 private:
+  struct LevelProperties
+  {
+    std::string name;
+    std::string author;
+    std::string contact;
+    std::string license;
+    std::string tileset;
+    float target_time;
+    bool suppress_pause_menu;
+
+    bool operator!=(const LevelProperties& other) const;
+  };
+
+  struct SectorState
+  {
+    /** only used to notice sectors that got replaced */
+    const Sector* sector;
+    std::string name;
+    float gravity;
+    std::string init_script;
+
+    /** saveable objects in the order of the sector, write_sector()
+        sorts them like Sector::save() does */
+    std::vector<UID> objects;
+  };
+
+  struct ObjectState
+  {
+    /** index of the sector in Level::m_sectors */
+    size_t sector;
+    std::string type;
+
+    /** the saved options of the object, for tilemaps without the tiles */
+    std::string body;
+
+    bool tilemap;
+    int width;
+    int height;
+    std::vector<uint32_t> tiles;
+
+    /** compares everything but the tiles */
+    bool operator!=(const ObjectState& other) const;
+  };
+
+  struct LevelState
+  {
+    LevelProperties properties;
+    std::vector<SectorState> sectors;
+    std::unordered_map<UID, ObjectState> objects;
+  };
+
+  struct SectorDiff
+  {
+    size_t index;
+    SectorState before;
+    SectorState after;
+  };
+
+  /** An object that was added (no before), removed (no after) or
+      modified, objects are replaced as a whole */
+  struct ObjectDiff
+  {
+    UID uid;
+    boost::optional<ObjectState> before;
+    boost::optional<ObjectState> after;
+  };
+
+  struct TilemapDiff
+  {
+    UID uid;
+    size_t sector;
+    TileDiff tiles;
+  };
+
+  struct Step
+  {
+    LevelProperties properties_before;
+    LevelProperties properties_after;
+    std::vector<SectorDiff> sectors;
+    std::vector<ObjectDiff> objects;
+    std::vector<TilemapDiff> tiles;
+
+    /** Sectors were added, removed or replaced. Such steps store the
+        complete sectors and the UIDs of their objects in save order
+        instead of diffs. */
+    bool structural;
+    std::vector<std::string> sectors_before;
+    std::vector<std::string> sectors_after;
+    std::vector<UID> uids_before;
+    std::vector<UID> uids_after;
+  };
+
 public:
   UndoManager();
 
+  /** Records the changes made to the level since the last call as a
+      new step, the first call only remembers the state. Only objects
+      passed to record_object() are saved to look for modifications,
+      added and removed objects are found by their UIDs. */
   void try_snapshot(Level& level);
 
-  std::unique_ptr<Level> undo();
-  std::unique_ptr<Level> redo();
+  /** Marks an object the editor changes, e.g. by moving it or in its
+      ObjectMenu */
+  void record_object(const GameObject& object);
+
+  /** Marks all saveable objects of sector, e.g. when it gets resized */
+  void record_sector(Sector& sector);
+
+  /** Remembers the tile at x, y, call this before the editor writes
+      to the tilemap */
+  void record_tile(const TileMap& tilemap, int x, int y);
+
+  /** Reverts or reapplies the last step on level. Returns false if
+      there is nothing to undo or redo, or if the step couldn't be
+      applied, which clears the history. Objects touched by the step
+      are recreated, so pointers to them become invalid. */
+  bool undo(Level& level);
+  bool redo(Level& level);
+
+  /** Forgets the history and remembers the state of level, call
+      this when a different level got loaded. */
+  void reset(Level& level);
 
   bool has_unsaved_changes() const
   {
-    return m_index_pos != 1;
+    return m_index_pos != 0;
   }
 
   void reset_index()
   {
-    m_index_pos = 1;
+    m_index_pos = 0;
   }
 
 private:
-  void push_undo_stack(std::string&& level_snapshot);
+  void capture(Level& level, LevelState& state) const;
+
+  /** Builds the step from m_state to level and moves m_state along */
+  Step make_step(Level& level);
+  bool is_structural(const Level& level) const;
+
+  /** Applies step to level and m_state, returns false if level ended
+      up in a different state than the step expects */
+  bool apply(Level& level, const Step& step, bool forward);
+  void remap_uids(const std::unordered_map<UID, UID>& remap);
+  void clear_records();
   void cleanup();
   void debug_print(const char* action);
 
+  static void capture_properties(const Level& level, LevelProperties& properties);
+  static ObjectState capture_object(GameObject& object, size_t sector);
+  static std::string save_body(GameObject& object, bool skip_tiles);
+  static void write_object(Writer& writer, std::ostream& out, const ObjectState& object);
+  static std::vector<UID> saved_order(const LevelState& state, size_t index);
+  static std::string write_sector(const LevelState& state, size_t index);
+
 private:
   size_t m_max_snapshots;
   int m_index_pos;
-  std::vector<std::string> m_undo_stack;
-  std::vector<std::string> m_redo_stack;
+  std::vector<Step> m_undo_stack;
+  std::vector<Step> m_redo_stack;
+
+  /** State of the level after the last recorded step */
+  LevelState m_state;
+  bool m_has_state;
+
+  /** Edits since the last step */
+  std::unordered_set<UID> m_recorded_objects;
+  std::unordered_map<UID, TileDiff> m_recorded_tiles;
 
 private:
   UndoManager(const UndoManager&) = delete;
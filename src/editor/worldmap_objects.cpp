@@ -34,9 +34,8 @@ WorldmapObject::WorldmapObject (const ReaderMapping& mapping, const std::string&
   m_tile_x(),
   m_tile_y()
 {
-  m_col.m_bbox = Rectf(Vector(32 * m_col.m_bbox.get_left(),
-                              32 * m_col.m_bbox.get_top()),
-                       Sizef(32.0f, 32.0f));
+  m_col.set_pos(get_pos() * 32.0f);
+  m_col.set_size(32.0f, 32.0f);
 }
 
 WorldmapObject::WorldmapObject (const ReaderMapping& mapping) :
@@ -44,9 +43,8 @@ WorldmapObject::WorldmapObject (const ReaderMapping& mapping) :
   m_tile_x(),
   m_tile_y()
 {
-  m_col.m_bbox.set_left(32 * m_col.m_bbox.get_left());
-  m_col.m_bbox.set_top(32 * m_col.m_bbox.get_top());
-  m_col.m_bbox.set_size(32, 32);
+  m_col.set_pos(get_pos() * 32.0f);
+  m_col.set_size(32, 32);
 }
 
 WorldmapObject::WorldmapObject (const Vector& pos, const std::string& default_sprite) :
@@ -54,9 +52,8 @@ WorldmapObject::WorldmapObject (const Vector& pos, const std::string& default_sp
   m_tile_x(),
   m_tile_y()
 {
-  m_col.m_bbox.set_left(32 * m_col.m_bbox.get_left());
-  m_col.m_bbox.set_top(32 * m_col.m_bbox.get_top());
-  m_col.m_bbox.set_size(32, 32);
+  m_col.set_pos(get_pos() * 32.0f);
+  m_col.set_size(32, 32);
 }
 
 ObjectSettings
@@ -18,7 +18,7 @@
 
 #include <limits>
 
-Random graphicsRandom;
+thread_local Random graphicsRandom;
 Random gameRandom;
 
 Random::Random() :
@@ -50,8 +50,9 @@ private:
   Random& operator=(const Random&) = delete;
 };
 
-/** Use for random particle fx or whatever */
-extern Random graphicsRandom;
+/** Use for random particle fx or whatever, every thread has its own
+    generator so that objects updated in parallel can use it */
+extern thread_local Random graphicsRandom;
 
 /** Use for game-changing random numbers */
 extern Random gameRandom;
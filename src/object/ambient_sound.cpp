@@ -46,7 +46,7 @@ AmbientSound::AmbientSound(const ReaderMapping& mapping) :
   mapping.get("y", m_col.m_bbox.get_top(), 0.0f);
   mapping.get("width" , w, 32.0f);
   mapping.get("height", h, 32.0f);
-  m_col.m_bbox.set_size(w, h);
+  m_col.set_size(w, h);
 
   mapping.get("distance_factor",distance_factor, 0.0f);
   mapping.get("distance_bias"  ,distance_bias  , 0.0f);
@@ -90,8 +90,8 @@ AmbientSound::AmbientSound(const Vector& pos, float factor, float bias, float vo
 {
   m_col.m_group = COLGROUP_DISABLED;
 
-  m_col.m_bbox.set_pos(pos);
-  m_col.m_bbox.set_size(32, 32);
+  m_col.set_pos(pos);
+  m_col.set_size(32, 32);
 
   // set default silence_distance
 
@@ -227,7 +227,7 @@ AmbientSound::set_pos(const Vector& pos)
 void
 AmbientSound::set_pos(float x, float y)
 {
-  m_col.m_bbox.set_pos(Vector(x, y));
+  m_col.set_pos(Vector(x, y));
 }
 
 float
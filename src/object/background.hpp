@@ -36,6 +36,7 @@ public:
   virtual ~Background();
 
   virtual void update(float dt_sec) override;
+  virtual bool is_update_thread_safe() const override { return true; }
   virtual void draw(DrawingContext& context) override;
 
   virtual std::string get_class() const override { return "background"; }
@@ -47,7 +47,7 @@ Block::Block(SpritePtr newsprite) :
   m_bounce_offset(0),
   m_original_y(-1)
 {
-  m_col.m_bbox.set_size(32, 32.1f);
+  m_col.set_size(32, 32.1f);
   set_group(COLGROUP_STATIC);
   SoundManager::current()->preload("sounds/upgrade.wav");
   SoundManager::current()->preload("sounds/brick.wav");
@@ -75,7 +75,7 @@ Block::Block(const ReaderMapping& mapping, const std::string& sprite_file) :
   m_sprite_name = sf;
   m_default_sprite_name = m_sprite_name;
 
-  m_col.m_bbox.set_size(32, 32.1f);
+  m_col.set_size(32, 32.1f);
   set_group(COLGROUP_STATIC);
   SoundManager::current()->preload("sounds/upgrade.wav");
   SoundManager::current()->preload("sounds/brick.wav");
@@ -68,7 +68,7 @@ BonusBlock::BonusBlock(const Vector& pos, int tile_data) :
 {
   m_default_sprite_name = "images/objects/bonus_block/bonusblock.sprite";
 
-  m_col.m_bbox.set_pos(pos);
+  m_col.set_pos(pos);
   m_sprite->set_action("normal");
   m_contents = get_content_by_data(tile_data);
   preload_contents(tile_data);
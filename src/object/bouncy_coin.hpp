@@ -21,8 +21,10 @@
 #include "sprite/sprite_ptr.hpp"
 #include "supertux/game_object.hpp"
 #include "supertux/timer.hpp"
+#include "util/object_pool.hpp"
 
-class BouncyCoin final : public GameObject
+class BouncyCoin final : public GameObject,
+                         public Pooled<BouncyCoin>
 {
 public:
   BouncyCoin(const Vector& pos, bool emerge = false,
@@ -34,7 +34,7 @@ Brick::Brick(const Vector& pos, int data, const std::string& spriteName) :
   m_breakable(false),
   m_coin_counter(0)
 {
-  m_col.m_bbox.set_pos(pos);
+  m_col.set_pos(pos);
   if (data == 1) {
     m_coin_counter = 5;
   } else {
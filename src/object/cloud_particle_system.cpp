@@ -20,15 +20,13 @@
 #include "video/surface.hpp"
 
 CloudParticleSystem::CloudParticleSystem() :
-  ParticleSystem(128),
-  cloudimage(Surface::from_file("images/objects/particles/cloud.png"))
+  ParticleSystem(128)
 {
   init();
 }
 
 CloudParticleSystem::CloudParticleSystem(const ReaderMapping& reader) :
-  ParticleSystem(reader, 128),
-  cloudimage(Surface::from_file("images/objects/particles/cloud.png"))
+  ParticleSystem(reader, 128)
 {
   init();
 }
@@ -39,17 +37,18 @@ CloudParticleSystem::~CloudParticleSystem()
 
 void CloudParticleSystem::init()
 {
+  textures.push_back(Surface::from_file("images/objects/particles/cloud.png"));
+
   virtual_width = 2000.0;
 
   // create some random clouds
   for (size_t i=0; i<15; ++i) {
-    auto particle = std::make_unique<CloudParticle>();
-    particle->pos.x = graphicsRandom.randf(virtual_width);
-    particle->pos.y = graphicsRandom.randf(virtual_height);
-    particle->texture = cloudimage;
-    particle->speed = -graphicsRandom.randf(25.0, 54.0);
+    Vector pos;
+    pos.x = graphicsRandom.randf(virtual_width);
+    pos.y = graphicsRandom.randf(virtual_height);
+    float speed = -graphicsRandom.randf(25.0, 54.0);
 
-    particles.push_back(std::move(particle));
+    particles.add(pos, 0.0f, speed, 0);
   }
 }
 
@@ -58,12 +57,7 @@ void CloudParticleSystem::update(float dt_sec)
   if (!enabled)
     return;
 
-  for (auto& particle : particles) {
-    auto cloudParticle = dynamic_cast<CloudParticle*>(particle.get());
-    if (!cloudParticle)
-      continue;
-    cloudParticle->pos.x += cloudParticle->speed * dt_sec;
-  }
+  particles.move(dt_sec, 0.0f);
 }
 
 /* EOF */
@@ -31,6 +31,7 @@ public:
 
   void init();
   virtual void update(float dt_sec) override;
+  virtual bool is_update_thread_safe() const override { return true; }
 
   virtual std::string get_class() const override { return "particles-clouds"; }
   virtual std::string get_display_name() const override { return _("Cloud Particles"); }
@@ -39,19 +40,6 @@ public:
     return "images/engine/editor/clouds.png";
   }
 
-private:
-  class CloudParticle : public Particle
-  {
-  public:
-    float speed;
-
-    CloudParticle() :
-      speed()
-    {}
-  };
-
-  SurfacePtr cloudimage;
-
 private:
   CloudParticleSystem(const CloudParticleSystem&) = delete;
   CloudParticleSystem& operator=(const CloudParticleSystem&) = delete;
@@ -49,7 +49,7 @@ Firefly::Firefly(const ReaderMapping& mapping) :
   }
   //Replace sprite
   m_sprite = SpriteManager::current()->create( m_sprite_name );
-  m_col.m_bbox.set_size(m_sprite->get_current_hitbox_width(), m_sprite->get_current_hitbox_height());
+  m_col.set_size(m_sprite->get_current_hitbox_width(), m_sprite->get_current_hitbox_height());
 
   if (m_sprite_name.find("torch", 0) != std::string::npos) {
     m_sprite_light = SpriteManager::current()->create("images/objects/lightmap_light/lightmap_light-small.sprite");
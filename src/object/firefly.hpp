@@ -30,6 +30,7 @@ public:
   Firefly(const ReaderMapping& mapping);
 
   virtual void draw(DrawingContext& context) override;
+  virtual bool is_update_thread_safe() const override { return true; }
 
   virtual HitResponse collision(GameObject& other, const CollisionHit& hit) override;
   virtual std::string get_class() const override { return "firefly"; }
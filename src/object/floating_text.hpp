@@ -20,9 +20,11 @@
 #include "math/vector.hpp"
 #include "supertux/game_object.hpp"
 #include "supertux/timer.hpp"
+#include "util/object_pool.hpp"
 #include "video/color.hpp"
 
-class FloatingText final : public GameObject
+class FloatingText final : public GameObject,
+                           public Pooled<FloatingText>
 {
   static Color text_color;
 public:
@@ -27,7 +27,7 @@ Flower::Flower(BonusType _type) :
   flip(NO_FLIP),
   lightsprite(SpriteManager::current()->create("images/objects/lightmap_light/lightmap_light-small.sprite"))
 {
-  m_col.m_bbox.set_size(32, 32);
+  m_col.set_size(32, 32);
   lightsprite->set_blend(Blend::ADD);
 
   if (type == FIRE_BONUS) {
@@ -45,22 +45,21 @@ GhostParticleSystem::~GhostParticleSystem()
 void
 GhostParticleSystem::init()
 {
-  ghosts[0] = Surface::from_file("images/objects/particles/ghost0.png");
-  ghosts[1] = Surface::from_file("images/objects/particles/ghost1.png");
+  textures.push_back(Surface::from_file("images/objects/particles/ghost0.png"));
+  textures.push_back(Surface::from_file("images/objects/particles/ghost1.png"));
 
   virtual_width = static_cast<float>(SCREEN_WIDTH) * 2.0f;
 
   // create two ghosts
   size_t ghostcount = 2;
   for (size_t i=0; i<ghostcount; ++i) {
-    auto particle = std::make_unique<GhostParticle>();
-    particle->pos.x = graphicsRandom.randf(virtual_width);
-    particle->pos.y = graphicsRandom.randf(static_cast<float>(SCREEN_HEIGHT));
+    Vector pos;
+    pos.x = graphicsRandom.randf(virtual_width);
+    pos.y = graphicsRandom.randf(static_cast<float>(SCREEN_HEIGHT));
     int size = graphicsRandom.rand(2);
-    particle->texture = ghosts[size];
-    particle->speed = graphicsRandom.randf(std::max(50.0f, static_cast<float>(size) * 10.0f),
-                                           180.0f + static_cast<float>(size) * 10.0f);
-    particles.push_back(std::move(particle));
+    float speed = graphicsRandom.randf(std::max(50.0f, static_cast<float>(size) * 10.0f),
+                                       180.0f + static_cast<float>(size) * 10.0f);
+    particles.add(pos, 0.0f, speed, size);
   }
 }
 
@@ -70,13 +69,12 @@ GhostParticleSystem::update(float dt_sec)
   if (!enabled)
     return;
 
-  for (const auto& part : particles) {
-    const auto& particle = dynamic_cast<GhostParticle*>(part.get());
-    particle->pos.y -= particle->speed * dt_sec;
-    particle->pos.x -= particle->speed * dt_sec;
-    if (particle->pos.y > static_cast<float>(SCREEN_HEIGHT)) {
-      particle->pos.y = fmodf(particle->pos.y , virtual_height);
-      particle->pos.x = graphicsRandom.randf(virtual_width);
+  particles.move(-dt_sec, -dt_sec);
+
+  for (size_t i = 0; i < particles.size(); ++i) {
+    if (particles.y[i] > static_cast<float>(SCREEN_HEIGHT)) {
+      particles.y[i] = fmodf(particles.y[i], virtual_height);
+      particles.x[i] = graphicsRandom.randf(virtual_width);
     }
   }
 }
@@ -31,6 +31,7 @@ public:
 
   void init();
   virtual void update(float dt_sec) override;
+  virtual bool is_update_thread_safe() const override { return true; }
 
   virtual std::string get_class() const override { return "particles-ghosts"; }
   virtual std::string get_display_name() const override { return _("Ghost Particles"); }
@@ -39,19 +40,6 @@ public:
     return "images/engine/editor/ghostparticles.png";
   }
 
-private:
-  class GhostParticle : public Particle
-  {
-  public:
-    float speed;
-
-    GhostParticle() :
-      speed()
-    {}
-  };
-
-  SurfacePtr ghosts[2];
-
 private:
   GhostParticleSystem(const GhostParticleSystem&) = delete;
   GhostParticleSystem& operator=(const GhostParticleSystem&) = delete;
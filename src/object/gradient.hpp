@@ -34,6 +34,7 @@ public:
   virtual ~Gradient();
 
   virtual void update(float dt_sec) override;
+  virtual bool is_update_thread_safe() const override { return true; }
   virtual void draw(DrawingContext& context) override;
 
   virtual bool is_saveable() const override;
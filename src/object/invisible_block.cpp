@@ -27,7 +27,7 @@ InvisibleBlock::InvisibleBlock(const Vector& pos) :
    Block(SpriteManager::current()->create("images/objects/bonus_block/invisibleblock.sprite")),
    visible(false)
 {
-  m_col.m_bbox.set_pos(pos);
+  m_col.set_pos(pos);
   SoundManager::current()->preload("sounds/brick.wav");
   m_sprite->set_action("default-editor");
 }
@@ -29,7 +29,9 @@
 Lantern::Lantern(const ReaderMapping& reader) :
   Rock(reader, "images/objects/lantern/lantern.sprite"),
   lightcolor(1.0f, 1.0f, 1.0f),
-  lightsprite(SpriteManager::current()->create("images/objects/lightmap_light/lightmap_light.sprite"))
+  lightsprite(SpriteManager::current()->create("images/objects/lightmap_light/lightmap_light.sprite")),
+  static_light(),
+  light_pos()
 {
   std::vector<float> vColor;
   if (reader.get("color", vColor)) {
@@ -47,7 +49,9 @@ Lantern::Lantern(const ReaderMapping& reader) :
 Lantern::Lantern(const Vector& pos) :
   Rock(pos, "images/objects/lantern/lantern.sprite"),
   lightcolor(0.0f, 0.0f, 0.0f),
-  lightsprite(SpriteManager::current()->create("images/objects/lightmap_light/lightmap_light.sprite"))
+  lightsprite(SpriteManager::current()->create("images/objects/lightmap_light/lightmap_light.sprite")),
+  static_light(),
+  light_pos()
 {
   lightsprite->set_blend(Blend::ADD);
   updateColor();
@@ -90,7 +94,16 @@ Lantern::draw(DrawingContext& context){
   //Draw the Sprite.
   MovingSprite::draw(context);
   //Let there be light.
-  lightsprite->draw(context.light(), m_col.m_bbox.get_middle(), 0);
+  const Vector pos = m_col.m_bbox.get_middle() - lightsprite->get_current_offset();
+  if (is_grabbed() || pos != light_pos) {
+    // Moving lanterns would re-render the static light layer every
+    // frame, so they are drawn directly until they come to rest
+    static_light.reset();
+    light_pos = pos;
+    lightsprite->draw(context.light(), m_col.m_bbox.get_middle(), 0);
+  } else {
+    static_light.draw(context, lightsprite->get_current_surface(), pos, lightcolor);
+  }
 }
 
 HitResponse Lantern::collision(GameObject& other, const CollisionHit& hit) {
@@ -18,6 +18,7 @@
 #define HEADER_SUPERTUX_OBJECT_LANTERN_HPP
 
 #include "object/rock.hpp"
+#include "supertux/static_light_layer.hpp"
 
 /** Lantern. A portable Light Source. */
 class Lantern final : public Rock
@@ -49,6 +50,12 @@ public:
 private:
   Color lightcolor;
   SpritePtr lightsprite;
+
+  /** Used while the lantern lies still, light_pos is where the light
+      was drawn last frame */
+  StaticLight static_light;
+  Vector light_pos;
+
   void updateColor();
 
 private:
@@ -22,7 +22,8 @@
 Light::Light(const Vector& center, const Color& color_) :
   position(center),
   color(color_),
-  sprite(SpriteManager::current()->create("images/objects/lightmap_light/lightmap_light.sprite"))
+  sprite(SpriteManager::current()->create("images/objects/lightmap_light/lightmap_light.sprite")),
+  static_light()
 {
 }
 
@@ -38,9 +39,8 @@ Light::update(float )
 void
 Light::draw(DrawingContext& context)
 {
-  sprite->set_color(color);
-  sprite->set_blend(Blend::ADD);
-  sprite->draw(context.light(), position, 0);
+  static_light.draw(context, sprite->get_current_surface(),
+                    position - sprite->get_current_offset(), color);
 }
 
 /* EOF */
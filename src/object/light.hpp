@@ -20,6 +20,7 @@
 #include "math/vector.hpp"
 #include "sprite/sprite_ptr.hpp"
 #include "supertux/game_object.hpp"
+#include "supertux/static_light_layer.hpp"
 #include "video/color.hpp"
 
 class Light : public GameObject
@@ -32,12 +33,16 @@ public:
   }
 
   virtual void update(float dt_sec) override;
+  virtual bool is_update_thread_safe() const override { return true; }
   virtual void draw(DrawingContext& context) override;
 
 protected:
   Vector position;
   Color color;
   SpritePtr sprite;
+
+private:
+  StaticLight static_light;
 };
 
 #endif
@@ -33,6 +33,7 @@ ParticleSystem::ParticleSystem(const ReaderMapping& reader, float max_particle_s
   max_particle_size(max_particle_size_),
   z_pos(LAYER_BACKGROUND1),
   particles(),
+  textures(),
   virtual_width(static_cast<float>(SCREEN_WIDTH) + max_particle_size * 2.0f),
   virtual_height(static_cast<float>(SCREEN_HEIGHT) + max_particle_size * 2.0f),
   enabled(true)
@@ -47,12 +48,33 @@ ParticleSystem::ParticleSystem(float max_particle_size_) :
   max_particle_size(max_particle_size_),
   z_pos(LAYER_BACKGROUND1),
   particles(),
+  textures(),
   virtual_width(static_cast<float>(SCREEN_WIDTH) + max_particle_size * 2.0f),
   virtual_height(static_cast<float>(SCREEN_HEIGHT) + max_particle_size * 2.0f),
   enabled(true)
 {
 }
 
+void
+ParticleSystem::Particles::move(float dx, float dy)
+{
+  // plain loops over raw arrays, so that the compiler can vectorize them
+  const size_t count = size();
+  float* __restrict px = x.data();
+  float* __restrict py = y.data();
+  const float* __restrict pspeed = speed.data();
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    px[i] += pspeed[i] * dx;
+  }
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    py[i] += pspeed[i] * dy;
+  }
+}
+
 ObjectSettings
 ParticleSystem::get_settings()
 {
@@ -84,34 +106,32 @@ ParticleSystem::draw(DrawingContext& context)
   context.push_transform();
   context.set_translation(Vector(max_particle_size,max_particle_size));
 
-  std::unordered_map<SurfacePtr, SurfaceBatch> batches;
-  for (const auto& particle : particles)
+  std::vector<SurfaceBatch> batches;
+  batches.reserve(textures.size());
+  for (const auto& texture : textures) {
+    batches.emplace_back(texture);
+  }
+
+  for (size_t i = 0; i < particles.size(); ++i)
   {
     // remap x,y coordinates onto screencoordinates
     Vector pos;
 
-    pos.x = fmodf(particle->pos.x - scrollx, virtual_width);
+    pos.x = fmodf(particles.x[i] - scrollx, virtual_width);
     if (pos.x < 0) pos.x += virtual_width;
 
-    pos.y = fmodf(particle->pos.y - scrolly, virtual_height);
+    pos.y = fmodf(particles.y[i] - scrolly, virtual_height);
     if (pos.y < 0) pos.y += virtual_height;
 
     //if(pos.x > virtual_width) pos.x -= virtual_width;
     //if(pos.y > virtual_height) pos.y -= virtual_height;
 
-    auto it = batches.find(particle->texture);
-    if (it == batches.end()) {
-      const auto& batch_it = batches.emplace(particle->texture, SurfaceBatch(particle->texture));
-      batch_it.first->second.draw(pos, particle->angle);
-    } else {
-      it->second.draw(pos, particle->angle);
-    }
+    batches[particles.texture[i]].draw(pos, particles.angle[i]);
   }
 
-  for(auto& it : batches) {
-    auto& surface = it.first;
-    auto& batch = it.second;
-    context.color().draw_surface_batch(surface,
+  for (size_t i = 0; i < textures.size(); ++i) {
+    auto& batch = batches[i];
+    context.color().draw_surface_batch(textures[i],
                                        batch.move_srcrects(),
                                        batch.move_dstrects(),
                                        batch.move_angles(),
@@ -41,7 +41,8 @@ class ReaderMapping;
 
   Classes that implement a particle system should subclass from this
   class, initialize particles in the constructor and move them in the
-  simulate function.
+  simulate function. Particles are stored as parallel arrays, extra
+  per-particle state of a subclass should be kept the same way.
  */
 class ParticleSystem : public GameObject,
                        public ExposedObject<ParticleSystem, scripting::ParticleSystem>
@@ -63,32 +64,53 @@ public:
   int get_layer() const { return z_pos; }
 
 protected:
-  class Particle
+  /** Particle state as structure of arrays, index i of every array
+      belongs to the same particle */
+  class Particles final
   {
   public:
-    Particle() :
-      pos(),
+    Particles() :
+      x(),
+      y(),
       angle(),
+      speed(),
       texture()
     {}
 
-    virtual ~Particle()
-    {}
+    size_t size() const { return x.size(); }
+
+    void add(const Vector& pos, float angle_, float speed_, int texture_)
+    {
+      x.push_back(pos.x);
+      y.push_back(pos.y);
+      angle.push_back(angle_);
+      speed.push_back(speed_);
+      texture.push_back(texture_);
+    }
+
+    /** Moves every particle by (dx, dy) times its speed */
+    void move(float dx, float dy);
+
+    std::vector<float> x;
+    std::vector<float> y;
 
-    Vector pos;
     // angle at which to draw particle
-    float angle;
-    SurfacePtr texture;
+    std::vector<float> angle;
+    std::vector<float> speed;
+
+    // index into ParticleSystem::textures
+    std::vector<int> texture;
 
   private:
-    Particle(const Particle&) = delete;
-    Particle& operator=(const Particle&) = delete;
+    Particles(const Particles&) = delete;
+    Particles& operator=(const Particles&) = delete;
   };
 
 protected:
   float max_particle_size;
   int z_pos;
-  std::vector<std::unique_ptr<Particle> > particles;
+  Particles particles;
+  std::vector<SurfacePtr> textures;
   float virtual_width;
   float virtual_height;
   bool enabled;
@@ -16,13 +16,8 @@
 
 #include "object/particlesystem_interactive.hpp"
 
-#include "collision/collision.hpp"
 #include "editor/editor.hpp"
-#include "math/aatriangle.hpp"
-#include "object/tilemap.hpp"
 #include "supertux/globals.hpp"
-#include "supertux/sector.hpp"
-#include "supertux/tile.hpp"
 #include "video/drawing_context.hpp"
 #include "video/surface_batch.hpp"
 #include "video/video_system.hpp"
@@ -63,108 +58,24 @@ ParticleSystem_Interactive::draw(DrawingContext& context)
 
   context.push_transform();
 
-  std::unordered_map<SurfacePtr, SurfaceBatch> batches;
-  for (const auto& particle : particles) {
-    auto it = batches.find(particle->texture);
-    if (it == batches.end()) {
-      const auto& batch_it = batches.emplace(particle->texture,
-        SurfaceBatch(particle->texture));
-      batch_it.first->second.draw(particle->pos);
-    } else {
-      it->second.draw(particle->pos);
-    }
+  std::vector<SurfaceBatch> batches;
+  batches.reserve(textures.size());
+  for (const auto& texture : textures) {
+    batches.emplace_back(texture);
   }
 
-  for(auto& it : batches) {
-    auto& surface = it.first;
-    auto& batch = it.second;
+  for (size_t i = 0; i < particles.size(); ++i) {
+    batches[particles.texture[i]].draw(Vector(particles.x[i], particles.y[i]));
+  }
+
+  for (size_t i = 0; i < textures.size(); ++i) {
+    auto& batch = batches[i];
     // FIXME: What is the colour used for?
-    context.color().draw_surface_batch(surface, batch.move_srcrects(),
+    context.color().draw_surface_batch(textures[i], batch.move_srcrects(),
       batch.move_dstrects(), Color::WHITE, z_pos);
   }
 
   context.pop_transform();
 }
 
-int
-ParticleSystem_Interactive::collision(Particle* object, const Vector& movement)
-{
-  using namespace collision;
-
-  // calculate rectangle where the object will move
-  float x1, x2;
-  float y1, y2;
-
-  x1 = object->pos.x;
-  x2 = x1 + 32 + movement.x;
-  if (x2 < x1) {
-    x1 = x2;
-    x2 = object->pos.x;
-  }
-
-  y1 = object->pos.y;
-  y2 = y1 + 32 + movement.y;
-  if (y2 < y1) {
-    y1 = y2;
-    y2 = object->pos.y;
-  }
-  bool water = false;
-
-  // test with all tiles in this rectangle
-  int starttilex = int(x1-1) / 32;
-  int starttiley = int(y1-1) / 32;
-  int max_x = int(x2+1);
-  int max_y = int(y2+1);
-
-  Rectf dest(x1, y1, x2, y2);
-  dest.move(movement);
-  Constraints constraints;
-
-  for (const auto& solids : Sector::get().get_solid_tilemaps()) {
-    // FIXME Handle a nonzero tilemap offset
-    for (int x = starttilex; x*32 < max_x; ++x) {
-      for (int y = starttiley; y*32 < max_y; ++y) {
-        const Tile& tile = solids->get_tile(x, y);
-
-        // skip non-solid tiles, except water
-        if (! (tile.get_attributes() & (Tile::WATER | Tile::SOLID)))
-          continue;
-
-        Rectf rect = solids->get_tile_bbox(x, y);
-        if (tile.is_slope ()) { // slope tile
-          AATriangle triangle = AATriangle(rect, tile.get_data());
-
-          if (rectangle_aatriangle(&constraints, dest, triangle)) {
-            if (tile.get_attributes() & Tile::WATER)
-              water = true;
-          }
-        } else { // normal rectangular tile
-          if (intersects(dest, rect)) {
-            if (tile.get_attributes() & Tile::WATER)
-              water = true;
-            set_rectangle_rectangle_constraints(&constraints, dest, rect);
-          }
-        }
-      }
-    }
-  }
-
-  // TODO don't use magic numbers here...
-
-  // did we collide at all?
-  if (!constraints.has_constraints())
-    return -1;
-
-  const CollisionHit& hit = constraints.hit;
-  if (water) {
-    return 0; //collision with water tile - don't draw splash
-  } else {
-    if (hit.right || hit.left) {
-      return 2; //collision from right
-    } else {
-      return 1; //collision from above
-    }
-  }
-}
-
 /* EOF */
@@ -19,8 +19,6 @@
 
 #include "object/particlesystem.hpp"
 
-class Vector;
-
 /**
    This is an alternative class for particle systems. It is
    responsible for storing a set of particles with each having an x-
@@ -48,9 +46,6 @@ public:
     return _("Interactive particle system");
   }
 
-protected:
-  int collision(Particle* particle, const Vector& movement);
-
 private:
   ParticleSystem_Interactive(const ParticleSystem_Interactive&) = delete;
   ParticleSystem_Interactive& operator=(const ParticleSystem_Interactive&) = delete;
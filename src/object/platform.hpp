@@ -39,6 +39,10 @@ public:
   virtual HitResponse collision(GameObject& other, const CollisionHit& hit) override;
   virtual void update(float dt_sec) override;
 
+  /** Only reads the players, which are updated after the parallel
+      phase, the movement is applied by the collision system */
+  virtual bool is_update_thread_safe() const override { return true; }
+
   virtual void move_to(const Vector& pos) override;
 
   virtual std::string get_class() const override { return "platform"; }
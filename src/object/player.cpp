@@ -64,13 +64,49 @@ const unsigned int IDLE_STAGE_COUNT = 5;
  * animation
  */
 const int IDLE_TIME[] = { 5000, 0, 2500, 0, 2500 };
+
+/** Bonus prefixes of Tux's actions */
+enum TuxBonus {
+  TUX_SMALL, TUX_BIG, TUX_FIRE, TUX_SANTA, TUX_ICE, TUX_AIR, TUX_EARTH, TUX_BONUS_COUNT
+};
+const char* const TUX_BONUS_NAMES[] =
+{ "small", "big", "fire", "santa", "ice", "air", "earth" };
+
+/** Tux's actions without bonus prefix and direction postfix */
+enum TuxAction {
+  TUX_STAND, TUX_IDLE, TUX_CLIMBING, TUX_BACKFLIP, TUX_DUCK, TUX_SKID,
+  TUX_KICK, TUX_BUTTJUMP, TUX_JUMP, TUX_RUN, TUX_WALK, TUX_ACTION_COUNT
+};
+const char* const TUX_ACTION_NAMES[] =
+{ "stand", "idle", "climbing", "backflip", "duck", "skid",
+  "kick", "buttjump", "jump", "run", "walk" };
+
 /** idle stages */
-const std::string IDLE_STAGES[] =
-{ "stand",
-  "idle",
-  "stand",
-  "idle",
-  "stand" };
+const TuxAction IDLE_STAGES[] =
+{ TUX_STAND,
+  TUX_IDLE,
+  TUX_STAND,
+  TUX_IDLE,
+  TUX_STAND };
+
+std::vector<ActionId> make_tux_actions()
+{
+  std::vector<ActionId> actions;
+  for (int bonus = 0; bonus < TUX_BONUS_COUNT; ++bonus) {
+    for (int action = 0; action < TUX_ACTION_COUNT; ++action) {
+      actions.push_back(ActionId(std::string(TUX_BONUS_NAMES[bonus]) + "-" + TUX_ACTION_NAMES[action]));
+    }
+  }
+  return actions;
+}
+
+/** Returns the interned "<bonus>-<action>" id, the sprite picks the
+    direction variant */
+ActionId get_tux_action(TuxBonus bonus, TuxAction action)
+{
+  static const std::vector<ActionId> actions = make_tux_actions();
+  return actions[bonus * TUX_ACTION_COUNT + action];
+}
 
 /** acceleration in horizontal direction when walking
  * (all accelerations are in  pixel/s^2) */
@@ -188,12 +224,12 @@ Player::Player(PlayerStatus& player_status, const std::string& name_) :
   m_name = name_;
   m_idle_timer.start(static_cast<float>(IDLE_TIME[0]) / 1000.0f);
 
-  SoundManager::current()->preload("sounds/bigjump.wav");
-  SoundManager::current()->preload("sounds/jump.wav");
-  SoundManager::current()->preload("sounds/hurt.wav");
-  SoundManager::current()->preload("sounds/kill.wav");
-  SoundManager::current()->preload("sounds/skid.wav");
-  SoundManager::current()->preload("sounds/flip.wav");
+  SoundManager::current()->pin("sounds/bigjump.wav");
+  SoundManager::current()->pin("sounds/jump.wav");
+  SoundManager::current()->pin("sounds/hurt.wav");
+  SoundManager::current()->pin("sounds/kill.wav");
+  SoundManager::current()->pin("sounds/skid.wav");
+  SoundManager::current()->pin("sounds/flip.wav");
   SoundManager::current()->preload("sounds/invincible_start.ogg");
   SoundManager::current()->preload("sounds/splash.wav");
   SoundManager::current()->preload("sounds/grow.wav");
@@ -1174,29 +1210,28 @@ Player::draw(DrawingContext& context)
     context.color().draw_surface(m_airarrow, Vector(px, py), LAYER_HUD - 1);
   }
 
-  std::string sa_prefix = "";
-  std::string sa_postfix = "";
+  static const ActionId grow_action("grow");
+  static const ActionId grow_ladder_action("grow-ladder");
+
+  TuxBonus sa_bonus;
 
   if (m_player_status.bonus == GROWUP_BONUS)
-    sa_prefix = "big";
+    sa_bonus = TUX_BIG;
   else if (m_player_status.bonus == FIRE_BONUS)
     if (g_config->christmas_mode)
-      sa_prefix = "santa";
+      sa_bonus = TUX_SANTA;
     else
-      sa_prefix = "fire";
+      sa_bonus = TUX_FIRE;
   else if (m_player_status.bonus == ICE_BONUS)
-    sa_prefix = "ice";
+    sa_bonus = TUX_ICE;
   else if (m_player_status.bonus == AIR_BONUS)
-    sa_prefix = "air";
+    sa_bonus = TUX_AIR;
   else if (m_player_status.bonus == EARTH_BONUS)
-    sa_prefix = "earth";
+    sa_bonus = TUX_EARTH;
   else
-    sa_prefix = "small";
+    sa_bonus = TUX_SMALL;
 
-  if (m_dir == Direction::LEFT)
-    sa_postfix = "-left";
-  else
-    sa_postfix = "-right";
+  const Direction sa_dir = (m_dir == Direction::LEFT) ? Direction::LEFT : Direction::RIGHT;
 
   /* Set Tux sprite action */
   if (m_dying) {
@@ -1204,10 +1239,10 @@ Player::draw(DrawingContext& context)
   }
   else if (m_growing) {
     if (m_climbing) {
-      m_sprite->set_action_continued("grow-ladder"+sa_postfix);
+      m_sprite->set_action_continued(grow_ladder_action, sa_dir);
     }
     else {
-      m_sprite->set_action_continued("grow"+sa_postfix);
+      m_sprite->set_action_continued(grow_action, sa_dir);
     }
     // while growing, do not change action
     // do_duck() will take care of cancelling growing manually
@@ -1217,30 +1252,30 @@ Player::draw(DrawingContext& context)
     m_sprite->set_action(m_sprite->get_action()+"-stone");
   }
   else if (m_climbing) {
-    m_sprite->set_action(sa_prefix+"-climbing"+sa_postfix);
+    m_sprite->set_action(get_tux_action(sa_bonus, TUX_CLIMBING), sa_dir);
 
     // Avoid flickering briefly after growing on ladder
     if ((m_physic.get_velocity_x()==0)&&(m_physic.get_velocity_y()==0))
       m_sprite->stop_animation();
   }
   else if (m_backflipping) {
-    m_sprite->set_action(sa_prefix+"-backflip"+sa_postfix);
+    m_sprite->set_action(get_tux_action(sa_bonus, TUX_BACKFLIP), sa_dir);
   }
   else if (m_duck && is_big()) {
-    m_sprite->set_action(sa_prefix+"-duck"+sa_postfix);
+    m_sprite->set_action(get_tux_action(sa_bonus, TUX_DUCK), sa_dir);
   }
   else if (m_skidding_timer.started() && !m_skidding_timer.check()) {
-    m_sprite->set_action(sa_prefix+"-skid"+sa_postfix);
+    m_sprite->set_action(get_tux_action(sa_bonus, TUX_SKID), sa_dir);
   }
   else if (m_kick_timer.started() && !m_kick_timer.check()) {
-    m_sprite->set_action(sa_prefix+"-kick"+sa_postfix);
+    m_sprite->set_action(get_tux_action(sa_bonus, TUX_KICK), sa_dir);
   }
   else if ((m_wants_buttjump || m_does_buttjump) && is_big()) {
-    m_sprite->set_action(sa_prefix+"-buttjump"+sa_postfix, 1);
+    m_sprite->set_action(get_tux_action(sa_bonus, TUX_BUTTJUMP), sa_dir, 1);
   }
   else if (!on_ground() || m_fall_mode != ON_GROUND) {
     if (m_physic.get_velocity_x() != 0 || m_fall_mode != ON_GROUND) {
-        m_sprite->set_action(sa_prefix+"-jump"+sa_postfix);
+        m_sprite->set_action(get_tux_action(sa_bonus, TUX_JUMP), sa_dir);
     }
   }
   else {
@@ -1250,7 +1285,7 @@ Player::draw(DrawingContext& context)
         m_idle_stage = 0;
         m_idle_timer.start(static_cast<float>(IDLE_TIME[m_idle_stage]) / 1000.0f);
 
-        m_sprite->set_action_continued(sa_prefix+("-" + IDLE_STAGES[m_idle_stage])+sa_postfix);
+        m_sprite->set_action_continued(get_tux_action(sa_bonus, IDLE_STAGES[m_idle_stage]), sa_dir);
       }
       else if (m_idle_timer.check() || (IDLE_TIME[m_idle_stage] == 0 && m_sprite->animation_done())) {
         m_idle_stage++;
@@ -1260,28 +1295,28 @@ Player::draw(DrawingContext& context)
         m_idle_timer.start(static_cast<float>(IDLE_TIME[m_idle_stage]) / 1000.0f);
 
         if (IDLE_TIME[m_idle_stage] == 0)
-          m_sprite->set_action(sa_prefix+("-" + IDLE_STAGES[m_idle_stage])+sa_postfix, 1);
+          m_sprite->set_action(get_tux_action(sa_bonus, IDLE_STAGES[m_idle_stage]), sa_dir, 1);
         else
-          m_sprite->set_action(sa_prefix+("-" + IDLE_STAGES[m_idle_stage])+sa_postfix);
+          m_sprite->set_action(get_tux_action(sa_bonus, IDLE_STAGES[m_idle_stage]), sa_dir);
       }
       else {
-        m_sprite->set_action_continued(sa_prefix+("-" + IDLE_STAGES[m_idle_stage])+sa_postfix);
+        m_sprite->set_action_continued(get_tux_action(sa_bonus, IDLE_STAGES[m_idle_stage]), sa_dir);
       }
     }
     else {
       if (fabsf(m_physic.get_velocity_x()) > MAX_WALK_XM && !is_big()) {
-        m_sprite->set_action(sa_prefix+"-run"+sa_postfix);
+        m_sprite->set_action(get_tux_action(sa_bonus, TUX_RUN), sa_dir);
       } else {
-        m_sprite->set_action(sa_prefix+"-walk"+sa_postfix);
+        m_sprite->set_action(get_tux_action(sa_bonus, TUX_WALK), sa_dir);
       }
     }
   }
 
   /* Set Tux powerup sprite action */
   if (m_player_status.has_hat_sprite()) {
-    m_powersprite->set_action(m_sprite->get_action());
+    m_powersprite->set_action(m_sprite->get_action_id());
     if (m_player_status.bonus == EARTH_BONUS)
-      m_lightsprite->set_action(m_sprite->get_action());
+      m_lightsprite->set_action(m_sprite->get_action_id());
   }
 
   /*
@@ -21,6 +21,7 @@
 
 #include "math/random.hpp"
 #include "math/util.hpp"
+#include "sprite/sprite.hpp"
 
 PulsingLight::PulsingLight(const Vector& center, float cycle_len_, float min_alpha_, float max_alpha_, const Color& color_) :
   Light(center, color_),
@@ -51,12 +52,14 @@ PulsingLight::update(float dt_sec)
 void
 PulsingLight::draw(DrawingContext& context)
 {
-  Color old_color = color;
+  // The light changes every frame, so it is drawn directly instead of
+  // going through the static light layer
+  Color pulse_color = color;
+  pulse_color.alpha *= min_alpha + ((max_alpha - min_alpha) * cosf(math::TAU * t / cycle_len));
 
-  color.alpha *= min_alpha + ((max_alpha - min_alpha) * cosf(math::TAU * t / cycle_len));
-  Light::draw(context);
-
-  color = old_color;
+  sprite->set_color(pulse_color);
+  sprite->set_blend(Blend::ADD);
+  sprite->draw(context.light(), position, 0);
 }
 
 /* EOF */
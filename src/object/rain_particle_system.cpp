@@ -16,7 +16,7 @@
 
 #include "object/rain_particle_system.hpp"
 
-#include <assert.h>
+#include <math.h>
 
 #include "math/random.hpp"
 #include "object/camera.hpp"
@@ -26,13 +26,15 @@
 #include "video/video_system.hpp"
 #include "video/viewport.hpp"
 
-RainParticleSystem::RainParticleSystem()
+RainParticleSystem::RainParticleSystem() :
+  hits()
 {
   init();
 }
 
 RainParticleSystem::RainParticleSystem(const ReaderMapping& reader) :
-  ParticleSystem_Interactive(reader)
+  ParticleSystem_Interactive(reader),
+  hits()
 {
   init();
 }
@@ -43,24 +45,24 @@ RainParticleSystem::~RainParticleSystem()
 
 void RainParticleSystem::init()
 {
-  rainimages[0] = Surface::from_file("images/objects/particles/rain0.png");
-  rainimages[1] = Surface::from_file("images/objects/particles/rain1.png");
+  textures.push_back(Surface::from_file("images/objects/particles/rain0.png"));
+  textures.push_back(Surface::from_file("images/objects/particles/rain1.png"));
 
   virtual_width = static_cast<float>(SCREEN_WIDTH) * 2.0f;
 
   // create some random raindrops
   size_t raindropcount = size_t(virtual_width/6.0f);
   for (size_t i=0; i<raindropcount; ++i) {
-    auto particle = std::make_unique<RainParticle>();
-    particle->pos.x = static_cast<float>(graphicsRandom.rand(int(virtual_width)));
-    particle->pos.y = static_cast<float>(graphicsRandom.rand(int(virtual_height)));
+    Vector pos;
+    pos.x = static_cast<float>(graphicsRandom.rand(int(virtual_width)));
+    pos.y = static_cast<float>(graphicsRandom.rand(int(virtual_height)));
     int rainsize = graphicsRandom.rand(2);
-    particle->texture = rainimages[rainsize];
+    float speed;
     do {
-      particle->speed = (static_cast<float>(rainsize) + 1.0f) * 45.0f + graphicsRandom.randf(3.6f);
-    } while(particle->speed < 1);
+      speed = (static_cast<float>(rainsize) + 1.0f) * 45.0f + graphicsRandom.randf(3.6f);
+    } while(speed < 1);
 
-    particles.push_back(std::move(particle));
+    particles.add(pos, 0.0f, speed, rainsize);
   }
 }
 
@@ -69,41 +71,43 @@ void RainParticleSystem::update(float dt_sec)
   if (!enabled)
     return;
 
-  for (auto& it : particles) {
-    auto particle = dynamic_cast<RainParticle*>(it.get());
-    assert(particle);
-
-    float movement = particle->speed * dt_sec * Sector::get().get_gravity();
-    float abs_x = Sector::get().get_camera().get_translation().x;
-    float abs_y = Sector::get().get_camera().get_translation().y;
-    particle->pos.y += movement;
-    particle->pos.x -= movement;
-    int col = collision(particle, Vector(-movement, movement));
-    if ((particle->pos.y > static_cast<float>(SCREEN_HEIGHT) + abs_y) || (col >= 0)) {
-      //Create rainsplash
-      if ((particle->pos.y <= static_cast<float>(SCREEN_HEIGHT) + abs_y) && (col >= 1)){
-        bool vertical = (col == 2);
-        if (!vertical) { //check if collision happened from above
-          int splash_x, splash_y; // move outside if statement when
-                                  // uncommenting the else statement below.
-          splash_x = int(particle->pos.x);
-          splash_y = int(particle->pos.y) - (int(particle->pos.y) % 32) + 32;
-          Sector::get().add<RainSplash>(Vector(static_cast<float>(splash_x), static_cast<float>(splash_y)),
-                                             vertical);
+  const float gravity = Sector::get().get_gravity();
+  const float abs_x = Sector::get().get_camera().get_translation().x;
+  const float abs_y = Sector::get().get_camera().get_translation().y;
+
+  const Vector direction(-dt_sec * gravity, dt_sec * gravity);
+  particles.move(direction.x, direction.y);
+
+  hits.clear();
+  Sector::get().collide_particles(particles.x, particles.y, particles.speed, direction, hits);
+
+  // hits are sorted by particle index
+  auto hit = hits.begin();
+  for (size_t i = 0; i < particles.size(); ++i) {
+    float& x = particles.x[i];
+    float& y = particles.y[i];
+    const bool collided = (hit != hits.end() && hit->index == i);
+    if ((y > static_cast<float>(SCREEN_HEIGHT) + abs_y) || collided) {
+      //Create rainsplash, but not for water tiles
+      if ((y <= static_cast<float>(SCREEN_HEIGHT) + abs_y) && collided && !hit->water) {
+        if (!hit->side) { //check if collision happened from above
+          Sector::get().add<RainSplash>(hit->pos, false);
         }
         // Uncomment the following to display vertical splashes, too
         /* else {
-           splash_x = int(particle->pos.x) - (int(particle->pos.x) % 32) + 32;
-           splash_y = int(particle->pos.y);
-           Sector::get().add<RainSplash>(Vector(splash_x, splash_y),vertical);
+           Vector splash_pos(floorf(x / 32.0f) * 32.0f + 32.0f, y);
+           Sector::get().add<RainSplash>(splash_pos, true);
            } */
       }
       int new_x = graphicsRandom.rand(int(virtual_width)) + int(abs_x);
       int new_y = 0;
       //FIXME: Don't move particles over solid tiles
-      particle->pos.x = static_cast<float>(new_x);
-      particle->pos.y = static_cast<float>(new_y);
+      x = static_cast<float>(new_x);
+      y = static_cast<float>(new_y);
     }
+
+    if (collided)
+      ++hit;
   }
 }
 
@@ -17,6 +17,7 @@
 #ifndef HEADER_SUPERTUX_OBJECT_RAIN_PARTICLE_SYSTEM_HPP
 #define HEADER_SUPERTUX_OBJECT_RAIN_PARTICLE_SYSTEM_HPP
 
+#include "collision/collision_system.hpp"
 #include "object/particlesystem_interactive.hpp"
 #include "video/surface_ptr.hpp"
 
@@ -38,17 +39,8 @@ public:
   }
 
 private:
-  class RainParticle : public Particle
-  {
-  public:
-    float speed;
-
-    RainParticle() :
-      speed()
-    {}
-  };
-
-  SurfacePtr rainimages[2];
+  /** Scratch buffer for the tile collisions of a frame */
+  std::vector<ParticleHit> hits;
 
 private:
   RainParticleSystem(const RainParticleSystem&) = delete;
@@ -21,8 +21,10 @@
 #include "sprite/sprite_ptr.hpp"
 #include "supertux/game_object.hpp"
 #include "supertux/timer.hpp"
+#include "util/object_pool.hpp"
 
-class SmokeCloud final : public GameObject
+class SmokeCloud final : public GameObject,
+                         public Pooled<SmokeCloud>
 {
 public:
   SmokeCloud(const Vector& pos);
@@ -30,6 +30,7 @@ public:
   virtual ~SnowParticleSystem();
 
   virtual void update(float dt_sec) override;
+  virtual bool is_update_thread_safe() const override { return true; }
 
   virtual std::string get_class() const override { return "particles-snow"; }
   virtual std::string get_display_name() const override { return _("Snow Particles"); }
@@ -41,30 +42,6 @@ public:
   void init();
 
 private:
-  class SnowParticle : public Particle
-  {
-  public:
-    float speed;
-    float wobble;
-    float anchorx;
-    float drift_speed;
-
-    // Turning speed
-    float spin_speed;
-
-    // for inertia
-    unsigned int flake_size;
-
-    SnowParticle() :
-      speed(),
-      wobble(),
-      anchorx(),
-      drift_speed(),
-      spin_speed(),
-      flake_size()
-    {}
-  };
-
   // Wind is simulated in discrete "gusts"
 
   // Gust state
@@ -78,6 +55,17 @@ private:
   };
 
 private:
+  // Per-particle state, parallel to ParticleSystem::particles
+  std::vector<float> wobble;
+  std::vector<float> anchorx;
+  std::vector<float> drift_speed;
+
+  // Turning speed
+  std::vector<float> spin_speed;
+
+  // for inertia
+  std::vector<float> flake_size;
+
   State state;
 
   // Gust state delay timer
@@ -89,8 +77,6 @@ private:
   // Current blowing velocity of gust
   float gust_current_velocity;
 
-  SurfacePtr snowimages[3];
-
 private:
   SnowParticleSystem(const SnowParticleSystem&) = delete;
   SnowParticleSystem& operator=(const SnowParticleSystem&) = delete;
@@ -26,8 +26,8 @@ SpawnPointMarker::SpawnPointMarker(const std::string& name, const Vector& pos) :
   m_surface(Surface::from_file("images/engine/editor/spawnpoint.png"))
 {
   m_name = name;
-  m_col.m_bbox.set_p1(pos);
-  m_col.m_bbox.set_size(32, 32);
+  m_col.set_pos(pos);
+  m_col.set_size(32, 32);
 
   if (!Editor::is_active()) {
     set_group(COLGROUP_DISABLED);
@@ -41,7 +41,7 @@ SpawnPointMarker::SpawnPointMarker(const ReaderMapping& mapping) :
   mapping.get("x", m_col.m_bbox.get_left(), 0.0f);
   mapping.get("y", m_col.m_bbox.get_top(), 0.0f);
 
-  m_col.m_bbox.set_size(32, 32);
+  m_col.set_size(32, 32);
   set_group(COLGROUP_DISABLED);
 }
 
@@ -27,7 +27,7 @@ SpecialRiser::SpecialRiser(const Vector& pos, std::unique_ptr<MovingObject> chil
   m_start_pos = pos;
   m_child->set_pos(pos - Vector(0,32));
   set_pos(m_start_pos);
-  m_col.m_bbox.set_size(m_child->get_bbox().get_width(), 32);
+  m_col.set_size(m_child->get_bbox().get_width(), 32);
   if (is_solid)
     set_group(COLGROUP_STATIC);
   else
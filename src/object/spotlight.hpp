@@ -30,6 +30,7 @@ public:
   virtual ~Spotlight();
 
   virtual void update(float dt_sec) override;
+  virtual bool is_update_thread_safe() const override { return true; }
   virtual void draw(DrawingContext& context) override;
 
   virtual HitResponse collision(GameObject& other, const CollisionHit& hit_) override;
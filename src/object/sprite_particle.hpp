@@ -21,11 +21,13 @@
 #include "math/anchor_point.hpp"
 #include "sprite/sprite_ptr.hpp"
 #include "supertux/game_object.hpp"
+#include "util/object_pool.hpp"
 #include "video/drawing_context.hpp"
 
 class Player;
 
-class SpriteParticle final : public GameObject
+class SpriteParticle final : public GameObject,
+                             public Pooled<SpriteParticle>
 {
 public:
   SpriteParticle(SpritePtr sprite, const std::string& action,
@@ -16,8 +16,6 @@
 
 #include "object/tilemap.hpp"
 
-#include <tuple>
-
 #include "editor/editor.hpp"
 #include "supertux/debug.hpp"
 #include "supertux/globals.hpp"
@@ -60,7 +58,10 @@ TileMap::TileMap(const TileSet *new_tileset) :
   m_new_size_y(0),
   m_new_offset_x(0),
   m_new_offset_y(0),
-  m_add_path(false)
+  m_add_path(false),
+  m_chunk_cache(),
+  m_solidity_mask(),
+  m_solidity_mask_valid(false)
 {
 }
 
@@ -93,7 +94,10 @@ TileMap::TileMap(const TileSet *tileset_, const ReaderMapping& reader) :
   m_new_size_y(0),
   m_new_offset_x(0),
   m_new_offset_y(0),
-  m_add_path(false)
+  m_add_path(false),
+  m_chunk_cache(),
+  m_solidity_mask(),
+  m_solidity_mask_valid(false)
 {
   assert(m_tileset);
 
@@ -359,48 +363,26 @@ TileMap::draw(DrawingContext& context)
   Rect t_draw_rect = get_tiles_overlapping(draw_rect);
   Vector start = get_tile_position(t_draw_rect.left, t_draw_rect.top);
 
-  Vector pos;
-  int tx, ty;
-
-  std::unordered_map<SurfacePtr,
-                     std::tuple<std::vector<Rectf>,
-                                std::vector<Rectf>>> batches;
-
-  for (pos.x = start.x, tx = t_draw_rect.left; tx < t_draw_rect.right; pos.x += 32, ++tx) {
-    for (pos.y = start.y, ty = t_draw_rect.top; ty < t_draw_rect.bottom; pos.y += 32, ++ty) {
-      int index = ty*m_width + tx;
-      assert (index >= 0);
-      assert (index < (m_width * m_height));
-
-      if (m_tiles[index] == 0) continue;
-      const Tile& tile = m_tileset->get(m_tiles[index]);
-
-      if (g_debug.show_collision_rects) {
-        tile.draw_debug(context.color(), pos, LAYER_FOREGROUND1);
-      }
-
-      const SurfacePtr& surface = Editor::is_active() ? tile.get_current_editor_surface() : tile.get_current_surface();
-      if (surface) {
-        std::get<0>(batches[surface]).emplace_back(surface->get_region());
-        std::get<1>(batches[surface]).emplace_back(pos,
-                                                   Sizef(static_cast<float>(surface->get_width()),
-                                                         static_cast<float>(surface->get_height())));
+  if (g_debug.show_collision_rects) {
+    Vector pos;
+    int tx, ty;
+    for (pos.x = start.x, tx = t_draw_rect.left; tx < t_draw_rect.right; pos.x += 32, ++tx) {
+      for (pos.y = start.y, ty = t_draw_rect.top; ty < t_draw_rect.bottom; pos.y += 32, ++ty) {
+        int index = ty*m_width + tx;
+        assert (index >= 0);
+        assert (index < (m_width * m_height));
+
+        if (m_tiles[index] == 0) continue;
+        m_tileset->get(m_tiles[index]).draw_debug(context.color(), pos, LAYER_FOREGROUND1);
       }
     }
   }
 
-  Canvas& canvas = context.get_canvas(m_draw_target);
-
-  for (auto& it : batches)
-  {
-    const SurfacePtr& surface = it.first;
-    if (surface) {
-      canvas.draw_surface_batch(surface,
-                                std::move(std::get<0>(it.second)),
-                                std::move(std::get<1>(it.second)),
-                                m_current_tint, m_z_pos);
-    }
-  }
+  // the cached geometry is relative to the tilemap origin, so moving
+  // tilemaps can reuse it
+  context.set_translation(context.get_translation() - m_offset);
+  m_chunk_cache.draw(context.get_canvas(m_draw_target), *this, t_draw_rect,
+                     m_current_tint, m_z_pos);
 
   context.pop_transform();
 }
@@ -449,6 +431,9 @@ TileMap::set(int newwidth, int newheight, const std::vector<unsigned int>&newt,
   // make sure all tiles are loaded
   for (const auto& tile : m_tiles)
     m_tileset->get(tile);
+
+  m_chunk_cache.invalidate();
+  m_solidity_mask_valid = false;
 }
 
 void
@@ -498,6 +483,9 @@ TileMap::resize(int new_width, int new_height, int fill_id,
       }
     }
   }
+
+  m_chunk_cache.invalidate();
+  m_solidity_mask_valid = false;
 }
 
 void TileMap::resize(const Size& newsize, const Size& resize_offset) {
@@ -542,6 +530,26 @@ TileMap::get_tile(int x, int y) const
   return m_tileset->get(id);
 }
 
+const std::vector<uint64_t>&
+TileMap::get_solidity_mask() const
+{
+  if (!m_solidity_mask_valid)
+  {
+    const int stride = get_solidity_mask_stride();
+    m_solidity_mask.assign(std::max(0, m_width) * stride, 0);
+    for (int x = 0; x < m_width; ++x) {
+      for (int y = 0; y < m_height; ++y) {
+        if (m_tileset->get(m_tiles[y * m_width + x]).get_attributes() & (Tile::SOLID | Tile::WATER)) {
+          m_solidity_mask[x * stride + y / 64] |= uint64_t(1) << (y % 64);
+        }
+      }
+    }
+    m_solidity_mask_valid = true;
+  }
+
+  return m_solidity_mask;
+}
+
 uint32_t
 TileMap::get_tile_id_at(const Vector& pos) const
 {
@@ -561,6 +569,17 @@ TileMap::change(int x, int y, uint32_t newtile)
 {
   assert(x >= 0 && x < m_width && y >= 0 && y < m_height);
   m_tiles[y*m_width + x] = newtile;
+  m_chunk_cache.invalidate(x, y);
+
+  if (m_solidity_mask_valid) {
+    uint64_t& word = m_solidity_mask[x * get_solidity_mask_stride() + y / 64];
+    const uint64_t bit = uint64_t(1) << (y % 64);
+    if (m_tileset->get(newtile).get_attributes() & (Tile::SOLID | Tile::WATER)) {
+      word |= bit;
+    } else {
+      word &= ~bit;
+    }
+  }
 }
 
 void
@@ -646,6 +665,8 @@ void
 TileMap::set_tileset(const TileSet* new_tileset)
 {
   m_tileset = new_tileset;
+  m_chunk_cache.invalidate();
+  m_solidity_mask_valid = false;
 }
 
 /* EOF */
@@ -18,12 +18,14 @@
 #define HEADER_SUPERTUX_OBJECT_TILEMAP_HPP
 
 #include <algorithm>
+#include <stdint.h>
 
 #include "math/rect.hpp"
 #include "math/rectf.hpp"
 #include "math/size.hpp"
 #include "object/path_object.hpp"
 #include "object/path_walker.hpp"
+#include "object/tilemap_chunk_cache.hpp"
 #include "squirrel/exposed_object.hpp"
 #include "scripting/tilemap.hpp"
 #include "supertux/game_object.hpp"
@@ -130,6 +132,14 @@ public:
 
   const Tile& get_tile(int x, int y) const;
   const Tile& get_tile_at(const Vector& pos) const;
+
+  /** Bitmask with one bit per tile, set for solid and water tiles.
+      The bits are stored column by column, tile (x, y) is bit y % 64
+      of word x * get_solidity_mask_stride() + y / 64. The mask is
+      rebuilt on demand after the tiles changed. */
+  const std::vector<uint64_t>& get_solidity_mask() const;
+  int get_solidity_mask_stride() const { return (m_height + 63) / 64; }
+
   uint32_t get_tile_id(int x, int y) const;
   uint32_t get_tile_id_at(const Vector& pos) const;
 
@@ -161,6 +171,7 @@ public:
   float get_alpha() const;
 
   void set_tileset(const TileSet* new_tileset);
+  const TileSet& get_tileset() const { return *m_tileset; }
 
   const std::vector<uint32_t>& get_tiles() const { return m_tiles; }
   
@@ -215,6 +226,12 @@ private:
   int m_new_offset_y;
   bool m_add_path;
 
+  TileMapChunkCache m_chunk_cache;
+
+  /** Cache for get_solidity_mask() */
+  mutable std::vector<uint64_t> m_solidity_mask;
+  mutable bool m_solidity_mask_valid;
+
 private:
   TileMap(const TileMap&) = delete;
   TileMap& operator=(const TileMap&) = delete;
@@ -0,0 +1,270 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "object/tilemap_chunk_cache.hpp"
+
+#include <algorithm>
+
+#include "editor/editor.hpp"
+#include "object/tilemap.hpp"
+#include "supertux/tile.hpp"
+#include "supertux/tile_set.hpp"
+#include "video/canvas.hpp"
+#include "video/surface.hpp"
+
+namespace {
+
+Rectf get_tile_dstrect(const Surface& surface, const Vector& pos)
+{
+  return Rectf(pos, Sizef(static_cast<float>(surface.get_width()),
+                          static_cast<float>(surface.get_height())));
+}
+
+} // namespace
+
+TileMapChunkCache::TileMapChunkCache() :
+  m_width(0),
+  m_height(0),
+  m_chunks_x(0),
+  m_chunks(),
+  m_editor(false),
+  m_surfaces(),
+  m_surface_ids(),
+  m_frame_batches(),
+  m_frame_surfaces(),
+  m_frame_animated(),
+  m_frame_rect(),
+  m_frame_valid(false)
+{
+}
+
+void
+TileMapChunkCache::invalidate()
+{
+  m_chunks.clear();
+  m_surfaces.clear();
+  m_surface_ids.clear();
+  m_frame_batches.clear();
+  m_frame_surfaces.clear();
+  m_frame_animated.clear();
+  m_frame_valid = false;
+}
+
+void
+TileMapChunkCache::invalidate(int x, int y)
+{
+  if (x < 0 || x >= m_width || y < 0 || y >= m_height)
+    return;
+
+  const size_t index = (y / CHUNK_SIZE) * m_chunks_x + (x / CHUNK_SIZE);
+  if (index < m_chunks.size()) {
+    m_chunks[index].valid = false;
+    m_frame_valid = false;
+  }
+}
+
+void
+TileMapChunkCache::draw(Canvas& canvas, const TileMap& tilemap, const Rect& tile_rect,
+                        const Color& color, int layer)
+{
+  const bool editor = Editor::is_active();
+  if (m_chunks.empty() ||
+      tilemap.get_width() != m_width ||
+      tilemap.get_height() != m_height ||
+      editor != m_editor)
+  {
+    invalidate();
+    m_width = tilemap.get_width();
+    m_height = tilemap.get_height();
+    m_editor = editor;
+    m_chunks_x = (m_width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    const int chunks_y = (m_height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    m_chunks.resize(m_chunks_x * chunks_y, Chunk{false, {}, {}});
+  }
+
+  if (tile_rect.left >= tile_rect.right || tile_rect.top >= tile_rect.bottom)
+    return;
+
+  if (!m_frame_valid || !(tile_rect == m_frame_rect)) {
+    rebuild_frame(tilemap, tile_rect);
+  } else {
+    drop_animated();
+  }
+
+  const TileSet& tileset = tilemap.get_tileset();
+  const auto& tiles = tilemap.get_tiles();
+  for (const int index : m_frame_animated) {
+    const SurfacePtr& surface = tileset.get_current_surface(tiles[index], m_editor);
+    if (surface) {
+      append(get_surface_id(surface), surface->get_region(),
+             get_tile_dstrect(*surface, Vector(static_cast<float>(index % m_width),
+                                               static_cast<float>(index / m_width)) * 32.0f));
+    }
+  }
+
+  for (const int surface_id : m_frame_surfaces) {
+    const FrameBatch& frame = m_frame_batches[surface_id];
+    canvas.draw_surface_batch_ref(m_surfaces[surface_id], frame.srcrects, frame.dstrects, color, layer);
+  }
+}
+
+void
+TileMapChunkCache::drop_animated()
+{
+  for (const int surface_id : m_frame_surfaces) {
+    FrameBatch& frame = m_frame_batches[surface_id];
+    frame.srcrects.resize(frame.static_size);
+    frame.dstrects.resize(frame.static_size);
+  }
+
+  // drop the surfaces that only had animated tiles
+  m_frame_surfaces.erase(std::remove_if(m_frame_surfaces.begin(), m_frame_surfaces.end(),
+                                        [this](int surface_id) {
+                                          return m_frame_batches[surface_id].static_size == 0;
+                                        }),
+                         m_frame_surfaces.end());
+}
+
+void
+TileMapChunkCache::rebuild_frame(const TileMap& tilemap, const Rect& tile_rect)
+{
+  for (const int surface_id : m_frame_surfaces) {
+    FrameBatch& frame = m_frame_batches[surface_id];
+    frame.static_size = 0;
+    frame.srcrects.clear();
+    frame.dstrects.clear();
+  }
+  m_frame_surfaces.clear();
+  m_frame_animated.clear();
+
+  for (int cy = tile_rect.top / CHUNK_SIZE; cy <= (tile_rect.bottom - 1) / CHUNK_SIZE; ++cy) {
+    for (int cx = tile_rect.left / CHUNK_SIZE; cx <= (tile_rect.right - 1) / CHUNK_SIZE; ++cx) {
+      Chunk& chunk = m_chunks[cy * m_chunks_x + cx];
+      if (!chunk.valid) {
+        rebuild(chunk, tilemap, cx, cy);
+      }
+
+      // chunks fully within view skip the per-tile visibility test
+      const bool contained =
+        tile_rect.left <= cx * CHUNK_SIZE &&
+        tile_rect.top <= cy * CHUNK_SIZE &&
+        std::min(m_width, (cx + 1) * CHUNK_SIZE) <= tile_rect.right &&
+        std::min(m_height, (cy + 1) * CHUNK_SIZE) <= tile_rect.bottom;
+
+      for (const auto& batch : chunk.batches) {
+        for (size_t i = 0; i < batch.dstrects.size(); ++i) {
+          const Rectf& dstrect = batch.dstrects[i];
+          if (!contained) {
+            const int tx = static_cast<int>(dstrect.get_left()) / 32;
+            const int ty = static_cast<int>(dstrect.get_top()) / 32;
+            if (!tile_rect.contains(tx, ty))
+              continue;
+          }
+          append(batch.surface_id, batch.srcrects[i], dstrect);
+        }
+      }
+
+      for (const int index : chunk.animated) {
+        if (contained || tile_rect.contains(index % m_width, index / m_width)) {
+          m_frame_animated.push_back(index);
+        }
+      }
+    }
+  }
+
+  for (const int surface_id : m_frame_surfaces) {
+    FrameBatch& frame = m_frame_batches[surface_id];
+    frame.static_size = frame.dstrects.size();
+  }
+
+  m_frame_rect = tile_rect;
+  m_frame_valid = true;
+}
+
+void
+TileMapChunkCache::rebuild(Chunk& chunk, const TileMap& tilemap, int chunk_x, int chunk_y)
+{
+  chunk.batches.clear();
+  chunk.animated.clear();
+
+  const auto& tiles = tilemap.get_tiles();
+  const int right = std::min(m_width, (chunk_x + 1) * CHUNK_SIZE);
+  const int bottom = std::min(m_height, (chunk_y + 1) * CHUNK_SIZE);
+
+  for (int ty = chunk_y * CHUNK_SIZE; ty < bottom; ++ty) {
+    for (int tx = chunk_x * CHUNK_SIZE; tx < right; ++tx) {
+      const int index = ty * m_width + tx;
+      if (tiles[index] == 0)
+        continue;
+
+      const Tile& tile = tilemap.get_tile(tx, ty);
+      if (tile.is_animated()) {
+        chunk.animated.push_back(index);
+        continue;
+      }
+
+      const SurfacePtr surface = m_editor ? tile.get_current_editor_surface() : tile.get_current_surface();
+      if (!surface)
+        continue;
+
+      const int surface_id = get_surface_id(surface);
+      auto it = std::find_if(chunk.batches.begin(), chunk.batches.end(),
+                             [surface_id](const Batch& batch) {
+                               return batch.surface_id == surface_id;
+                             });
+      if (it == chunk.batches.end()) {
+        chunk.batches.push_back(Batch{surface_id, {}, {}});
+        it = chunk.batches.end() - 1;
+      }
+
+      it->srcrects.emplace_back(surface->get_region());
+      it->dstrects.push_back(get_tile_dstrect(*surface, Vector(static_cast<float>(tx),
+                                                               static_cast<float>(ty)) * 32.0f));
+    }
+  }
+
+  chunk.valid = true;
+}
+
+int
+TileMapChunkCache::get_surface_id(const SurfacePtr& surface)
+{
+  const auto it = m_surface_ids.find(surface.get());
+  if (it != m_surface_ids.end())
+    return it->second;
+
+  const int surface_id = static_cast<int>(m_surfaces.size());
+  m_surfaces.push_back(surface);
+  m_surface_ids[surface.get()] = surface_id;
+  return surface_id;
+}
+
+void
+TileMapChunkCache::append(int surface_id, const Rectf& srcrect, const Rectf& dstrect)
+{
+  if (surface_id >= static_cast<int>(m_frame_batches.size())) {
+    m_frame_batches.resize(surface_id + 1);
+  }
+
+  FrameBatch& frame = m_frame_batches[surface_id];
+  if (frame.dstrects.empty()) {
+    m_frame_surfaces.push_back(surface_id);
+  }
+  frame.srcrects.push_back(srcrect);
+  frame.dstrects.push_back(dstrect);
+}
+
+/* EOF */
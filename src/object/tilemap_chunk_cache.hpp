@@ -0,0 +1,134 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_OBJECT_TILEMAP_CHUNK_CACHE_HPP
+#define HEADER_SUPERTUX_OBJECT_TILEMAP_CHUNK_CACHE_HPP
+
+#include <unordered_map>
+#include <vector>
+
+#include "math/rect.hpp"
+#include "math/rectf.hpp"
+#include "video/color.hpp"
+#include "video/surface_ptr.hpp"
+
+class Canvas;
+class Surface;
+class TileMap;
+
+/** Keeps the draw geometry of a TileMap around between frames. The
+    map is split into CHUNK_SIZE x CHUNK_SIZE chunks, each holding
+    prebuilt source and destination rectangles per surface. A chunk is
+    only rebuilt after it was invalidated, animated tiles are kept in
+    a separate list and looked up in the frame table of the TileSet
+    on every draw. The batches handed to the Canvas are kept as well
+    and only reassembled when the visible tiles change, the requests
+    refer to them instead of copying. */
+class TileMapChunkCache final
+{
+public:
+  static const int CHUNK_SIZE = 16;
+
+public:
+  TileMapChunkCache();
+
+  /** Marks all chunks as outdated, needed after the size or the
+      tileset of the tilemap changed */
+  void invalidate();
+
+  /** Marks the chunk containing the tile at (x, y) as outdated */
+  void invalidate(int x, int y);
+
+  /** Submits the tiles within tile_rect (as returned by
+      TileMap::get_tiles_overlapping()) to canvas, one batch per
+      surface. The tiles are placed relative to the tilemap origin,
+      the caller translates the canvas by TileMap::get_offset(). The
+      requests refer to the cache, so it must not be drawn again or
+      changed before the canvas was rendered. */
+  void draw(Canvas& canvas, const TileMap& tilemap, const Rect& tile_rect,
+            const Color& color, int layer);
+
+private:
+  struct Batch
+  {
+    int surface_id;
+
+    /** dstrects are relative to the tilemap origin */
+    std::vector<Rectf> srcrects;
+    std::vector<Rectf> dstrects;
+  };
+
+  struct Chunk
+  {
+    bool valid;
+    std::vector<Batch> batches;
+
+    /** Tile indices of the animated tiles in this chunk */
+    std::vector<int> animated;
+  };
+
+  struct FrameBatch
+  {
+    /** the static tiles come first, animated tiles are appended
+        behind them for a single draw */
+    size_t static_size;
+    std::vector<Rectf> srcrects;
+    std::vector<Rectf> dstrects;
+  };
+
+private:
+  void rebuild(Chunk& chunk, const TileMap& tilemap, int chunk_x, int chunk_y);
+
+  /** Collects the static tiles and the animated tile indices within
+      tile_rect into the frame batches */
+  void rebuild_frame(const TileMap& tilemap, const Rect& tile_rect);
+
+  /** Removes the animated tiles of the previous draw from the frame
+      batches, they were kept alive for its requests */
+  void drop_animated();
+
+  int get_surface_id(const SurfacePtr& surface);
+  void append(int surface_id, const Rectf& srcrect, const Rectf& dstrect);
+
+private:
+  int m_width;
+  int m_height;
+  int m_chunks_x;
+  std::vector<Chunk> m_chunks;
+
+  /** Whether the chunks were built with the editor images */
+  bool m_editor;
+
+  /** Every surface ever seen by this cache, batches refer to them by index */
+  std::vector<SurfacePtr> m_surfaces;
+  std::unordered_map<const Surface*, int> m_surface_ids;
+
+  /** Per-surface geometry of the visible tiles, indexed by surface
+      id. It stays valid while m_frame_rect and the chunks don't change. */
+  std::vector<FrameBatch> m_frame_batches;
+  std::vector<int> m_frame_surfaces;
+  std::vector<int> m_frame_animated;
+  Rect m_frame_rect;
+  bool m_frame_valid;
+
+private:
+  TileMapChunkCache(const TileMapChunkCache&) = delete;
+  TileMapChunkCache& operator=(const TileMapChunkCache&) = delete;
+};
+
+#endif
+
+/* EOF */
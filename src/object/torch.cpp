@@ -41,7 +41,7 @@ Torch::Torch(const ReaderMapping& reader) :
   reader.get("layer", m_layer, 0);
 
   m_torch = SpriteManager::current()->create(sprite_name);
-  m_col.m_bbox.set_size(static_cast<float>(m_torch->get_width()),
+  m_col.set_size(static_cast<float>(m_torch->get_width()),
                 static_cast<float>(m_torch->get_height()));
   m_flame_glow->set_blend(Blend::ADD);
   m_flame_light->set_blend(Blend::ADD);
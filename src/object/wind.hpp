@@ -35,6 +35,9 @@ public:
   virtual void draw(DrawingContext& context) override;
   virtual HitResponse collision(GameObject& other, const CollisionHit& hit) override;
 
+  /** only emits particles nobody sees while outside the active region */
+  virtual bool can_sleep() const override { return true; }
+
   virtual bool has_variable_size() const override { return true; }
   virtual std::string get_class() const override { return "wind"; }
   virtual std::string get_display_name() const override { return _("Wind");}
@@ -0,0 +1,68 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "sprite/action_id.hpp"
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct ActionRegistry
+{
+  std::mutex mutex;
+  std::unordered_map<std::string, int> ids;
+  std::vector<std::string> names;
+};
+
+ActionRegistry& get_registry()
+{
+  static ActionRegistry registry;
+  return registry;
+}
+
+} // namespace
+
+ActionId::ActionId(const std::string& name) :
+  m_id()
+{
+  ActionRegistry& registry = get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+
+  const auto it = registry.ids.find(name);
+  if (it != registry.ids.end()) {
+    m_id = it->second;
+  } else {
+    m_id = static_cast<int>(registry.names.size());
+    registry.ids[name] = m_id;
+    registry.names.push_back(name);
+  }
+}
+
+std::string
+ActionId::get_name() const
+{
+  if (m_id < 0)
+    return {};
+
+  ActionRegistry& registry = get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  return registry.names[m_id];
+}
+
+/* EOF */
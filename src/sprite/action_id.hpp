@@ -0,0 +1,49 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_SPRITE_ACTION_ID_HPP
+#define HEADER_SUPERTUX_SPRITE_ACTION_ID_HPP
+
+#include <string>
+
+/** Interned sprite action name. Every name gets a small integer that
+    is the same across all sprites, so switching actions by id is an
+    array lookup instead of a string compare and map walk. Interning
+    takes a lock, so keep the ids around instead of creating them in
+    per-frame code. */
+class ActionId final
+{
+public:
+  /** Creates an id that matches no action */
+  ActionId() : m_id(-1) {}
+
+  explicit ActionId(const std::string& name);
+
+  bool is_valid() const { return m_id >= 0; }
+  int get_index() const { return m_id; }
+  std::string get_name() const;
+
+  bool operator==(const ActionId& other) const { return m_id == other.m_id; }
+  bool operator!=(const ActionId& other) const { return m_id != other.m_id; }
+
+private:
+  int m_id;
+};
+
+#endif
+
+/* EOF */
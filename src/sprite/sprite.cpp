@@ -73,10 +73,42 @@ Sprite::set_action(const std::string& name, int loops)
     return;
   }
 
-  m_action = newaction;
+  switch_action(*newaction, loops);
+}
+
+void
+Sprite::set_action(ActionId id, int loops)
+{
+  const SpriteData::Action* newaction = m_data.get_action(id);
+  if (!newaction) {
+    log_debug << "Action '" << id.get_name() << "' not found." << std::endl;
+    return;
+  }
+
+  if (newaction != m_action)
+    switch_action(*newaction, loops);
+}
+
+void
+Sprite::set_action(ActionId id, Direction dir, int loops)
+{
+  const SpriteData::Action* newaction = m_data.get_action(id, dir);
+  if (!newaction) {
+    log_debug << "Action '" << id.get_name() << "' (" << dir << ") not found." << std::endl;
+    return;
+  }
+
+  if (newaction != m_action)
+    switch_action(*newaction, loops);
+}
+
+void
+Sprite::switch_action(const SpriteData::Action& action, int loops)
+{
+  m_action = &action;
   // If the new action has a loops property,
   // we prefer that over the parameter.
-  m_animation_loops = newaction->has_custom_loops ? newaction->loops : loops;
+  m_animation_loops = action.has_custom_loops ? action.loops : loops;
   m_frame = 0;
   m_frameidx = 0;
 }
@@ -93,7 +125,39 @@ Sprite::set_action_continued(const std::string& name)
     return;
   }
 
-  m_action = newaction;
+  continue_action(*newaction);
+}
+
+void
+Sprite::set_action_continued(ActionId id)
+{
+  const SpriteData::Action* newaction = m_data.get_action(id);
+  if (!newaction) {
+    log_debug << "Action '" << id.get_name() << "' not found." << std::endl;
+    return;
+  }
+
+  if (newaction != m_action)
+    continue_action(*newaction);
+}
+
+void
+Sprite::set_action_continued(ActionId id, Direction dir)
+{
+  const SpriteData::Action* newaction = m_data.get_action(id, dir);
+  if (!newaction) {
+    log_debug << "Action '" << id.get_name() << "' (" << dir << ") not found." << std::endl;
+    return;
+  }
+
+  if (newaction != m_action)
+    continue_action(*newaction);
+}
+
+void
+Sprite::continue_action(const SpriteData::Action& action)
+{
+  m_action = &action;
   update();
 }
 
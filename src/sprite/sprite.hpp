@@ -40,6 +40,14 @@ public:
   /** Set action (or state), but keep current frame number, loop counter, etc. */
   void set_action_continued(const std::string& name);
 
+  /** Set action by interned id, prefer these in per-frame code */
+  void set_action(ActionId id, int loops = -1);
+  void set_action_continued(ActionId id);
+
+  /** Set the "-left" or "-right" variant of the action id */
+  void set_action(ActionId id, Direction dir, int loops = -1);
+  void set_action_continued(ActionId id, Direction dir);
+
   /** Set number of animation cycles until animation stops */
   void set_animation_loops(int loops = -1) { m_animation_loops = loops; }
 
@@ -55,11 +63,18 @@ public:
   /** Get currently drawn frame */
   int get_current_frame() const { return m_frameidx; }
 
+  /** Get the surface of the currently drawn frame */
+  SurfacePtr get_current_surface() const { return m_action->surfaces[m_frameidx]; }
+
+  /** Get the offset of the current frame, draw() puts it at pos - offset */
+  Vector get_current_offset() const { return Vector(m_action->x_offset, m_action->y_offset); }
+
   /** Get sprite's name */
   const std::string& get_name() const { return m_data.name; }
 
   /** Get current action name */
   const std::string& get_action() const { return m_action->name; }
+  ActionId get_action_id() const { return m_action->id; }
 
   int get_width() const;
   int get_height() const;
@@ -88,10 +103,14 @@ public:
   Blend get_blend() const;
 
   bool has_action (const std::string& name) const { return (m_data.get_action(name) != nullptr); }
+  bool has_action(ActionId id) const { return (m_data.get_action(id) != nullptr); }
 
 private:
   void update();
 
+  void switch_action(const SpriteData::Action& action, int loops);
+  void continue_action(const SpriteData::Action& action);
+
   SpriteData& m_data;
 
   // between 0 and 1
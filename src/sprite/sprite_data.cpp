@@ -30,6 +30,7 @@
 
 SpriteData::Action::Action() :
   name(),
+  id(),
   x_offset(0),
   y_offset(0),
   hitbox_w(0),
@@ -43,6 +44,7 @@ SpriteData::Action::Action() :
 
 SpriteData::SpriteData(const ReaderMapping& mapping) :
   actions(),
+  action_table(),
   name()
 {
   auto iter = mapping.get_iter();
@@ -57,6 +59,8 @@ SpriteData::SpriteData(const ReaderMapping& mapping) :
   }
   if (actions.empty())
     throw std::runtime_error("Error: Sprite without actions.");
+
+  build_action_table();
 }
 
 void
@@ -208,4 +212,57 @@ SpriteData::get_action(const std::string& act) const
   return i->second.get();
 }
 
+const SpriteData::Action*
+SpriteData::get_action(ActionId id) const
+{
+  if (id.get_index() < 0 || id.get_index() >= static_cast<int>(action_table.size()))
+    return nullptr;
+
+  return action_table[id.get_index()].action;
+}
+
+const SpriteData::Action*
+SpriteData::get_action(ActionId id, Direction dir) const
+{
+  if (id.get_index() < 0 || id.get_index() >= static_cast<int>(action_table.size()))
+    return nullptr;
+
+  const ActionVariants& variants = action_table[id.get_index()];
+  switch (dir)
+  {
+    case Direction::LEFT:
+      return variants.left;
+
+    case Direction::RIGHT:
+      return variants.right;
+
+    default:
+      return variants.action;
+  }
+}
+
+void
+SpriteData::build_action_table()
+{
+  const auto get_variants = [this](const ActionId& id) -> ActionVariants& {
+    if (id.get_index() >= static_cast<int>(action_table.size())) {
+      action_table.resize(id.get_index() + 1, ActionVariants{nullptr, nullptr, nullptr});
+    }
+    return action_table[id.get_index()];
+  };
+
+  for (const auto& it : actions) {
+    Action& action = *it.second;
+    action.id = ActionId(action.name);
+    get_variants(action.id).action = &action;
+
+    const std::string& action_name = action.name;
+    if (action_name.size() > 5 && action_name.compare(action_name.size() - 5, 5, "-left") == 0) {
+      get_variants(ActionId(action_name.substr(0, action_name.size() - 5))).left = &action;
+    } else if (action_name.size() > 6 && action_name.compare(action_name.size() - 6, 6, "-right") == 0) {
+      get_variants(ActionId(action_name.substr(0, action_name.size() - 6))).right = &action;
+    }
+  }
+}
+
 /* EOF */
@@ -21,6 +21,8 @@
 #include <string>
 #include <vector>
 
+#include "sprite/action_id.hpp"
+#include "supertux/direction.hpp"
 #include "video/surface_ptr.hpp"
 
 class ReaderMapping;
@@ -44,6 +46,7 @@ private:
     Action();
 
     std::string name;
+    ActionId id;
 
     /** Position correction */
     float x_offset;
@@ -70,11 +73,31 @@ private:
 
   typedef std::map <std::string, std::unique_ptr<Action> > Actions;
 
+  /** An action and its "-left" and "-right" variants */
+  struct ActionVariants
+  {
+    const Action* action;
+    const Action* left;
+    const Action* right;
+  };
+
   void parse_action(const ReaderMapping& mapping);
   /** Get an action */
   const Action* get_action(const std::string& act) const;
+  const Action* get_action(ActionId id) const;
+
+  /** Get the "-left" or "-right" variant of id, other directions
+      give the action itself */
+  const Action* get_action(ActionId id, Direction dir) const;
+
+  /** Fills action_table once all actions are parsed */
+  void build_action_table();
 
   Actions actions;
+
+  /** Actions and their direction variants indexed by ActionId */
+  std::vector<ActionVariants> action_table;
+
   std::string name;
 };
 
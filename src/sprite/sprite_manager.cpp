@@ -18,17 +18,33 @@
 
 #include "sprite/sprite.hpp"
 #include "util/file_system.hpp"
+#include "util/log.hpp"
 #include "util/reader_document.hpp"
 #include "util/reader_mapping.hpp"
 #include "util/string_util.hpp"
+#include "util/worker_pool.hpp"
+#include "video/texture_manager.hpp"
 
 #include <sstream>
 
 SpriteManager::SpriteManager() :
-  sprites()
+  sprites(),
+  preloading(),
+  parsed(),
+  failed(),
+  parsed_mutex(),
+  documents(),
+  preload_hits(0),
+  preload_misses(0),
+  workers(new WorkerPool(1))
 {
 }
 
+SpriteManager::~SpriteManager()
+{
+  workers.reset();
+}
+
 SpritePtr
 SpriteManager::create(const std::string& name)
 {
@@ -49,27 +65,110 @@ SpriteManager::create(const std::string& name)
   return SpritePtr(new Sprite(*data));
 }
 
-SpriteData*
-SpriteManager::load(const std::string& filename)
+void
+SpriteManager::preload(const std::vector<std::string>& filenames)
+{
+  for (const auto& filename : filenames) {
+    if (sprites.count(filename) || documents.count(filename) || preloading.count(filename))
+      continue;
+
+    preloading.insert(filename);
+    workers->add([this, filename]{
+        try {
+          ReaderDocument doc = parse(filename);
+          std::lock_guard<std::mutex> lock(parsed_mutex);
+          parsed.push_back(std::move(doc));
+        } catch(const std::exception& e) {
+          // create() reports the error if the sprite is ever used
+          std::lock_guard<std::mutex> lock(parsed_mutex);
+          failed.push_back(filename);
+        }
+      });
+  }
+}
+
+void
+SpriteManager::process_preloads()
 {
-  ReaderDocument doc = [filename](){
-    try {
-      if (StringUtil::has_suffix(filename, ".sprite")) {
-        return ReaderDocument::from_file(filename);
-      } else {
-        std::stringstream text;
-        text << "(supertux-sprite (action "
-             << "(name \"default\") "
-             << "(images \"" << FileSystem::basename(filename) << "\")))";
-        return ReaderDocument::from_stream(text, filename);
+  if (preloading.empty())
+    return;
+
+  std::vector<ReaderDocument> docs;
+  {
+    std::lock_guard<std::mutex> lock(parsed_mutex);
+    docs.swap(parsed);
+    for (const auto& filename : failed) {
+      preloading.erase(filename);
+    }
+    failed.clear();
+  }
+
+  std::vector<std::string> images;
+  for (auto& doc : docs) {
+    const std::string filename = doc.get_filename();
+    preloading.erase(filename);
+    if (sprites.count(filename))
+      continue;
+
+    auto root = doc.get_root();
+    if (root.get_name() == "supertux-sprite") {
+      auto iter = root.get_mapping().get_iter();
+      while (iter.next()) {
+        std::vector<std::string> action_images;
+        if (iter.get_key() == "action" &&
+            iter.as_mapping().get("images", action_images)) {
+          for (const auto& image : action_images) {
+            images.push_back(FileSystem::join(doc.get_directory(), image));
+          }
+        }
       }
-    } catch(const std::exception& e) {
-      std::ostringstream msg;
-      msg << "Parse error when trying to load sprite '" << filename
-      << "': " << e.what() << "\n";
-      throw std::runtime_error(msg.str());
     }
-  }();
+    documents.emplace(filename, std::move(doc));
+  }
+
+  if (!images.empty()) {
+    if (auto texture_manager = TextureManager::current()) {
+      texture_manager->preload(images);
+    }
+  }
+}
+
+ReaderDocument
+SpriteManager::parse(const std::string& filename)
+{
+  try {
+    if (StringUtil::has_suffix(filename, ".sprite")) {
+      return ReaderDocument::from_file(filename);
+    } else {
+      std::stringstream text;
+      text << "(supertux-sprite (action "
+           << "(name \"default\") "
+           << "(images \"" << FileSystem::basename(filename) << "\")))";
+      return ReaderDocument::from_stream(text, filename);
+    }
+  } catch(const std::exception& e) {
+    std::ostringstream msg;
+    msg << "Parse error when trying to load sprite '" << filename
+    << "': " << e.what() << "\n";
+    throw std::runtime_error(msg.str());
+  }
+}
+
+SpriteData*
+SpriteManager::load(const std::string& filename)
+{
+  // levels are built in one go, so pick up the documents the worker
+  // finished in the meantime instead of waiting for the next frame
+  process_preloads();
+
+  auto preloaded = documents.find(filename);
+  ReaderDocument doc = (preloaded != documents.end()) ? std::move(preloaded->second) : parse(filename);
+  if (preloaded != documents.end()) {
+    documents.erase(preloaded);
+    preload_hits += 1;
+  } else {
+    preload_misses += 1;
+  }
 
   auto root = doc.get_root();
 
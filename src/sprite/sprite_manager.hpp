@@ -19,12 +19,17 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "sprite/sprite_ptr.hpp"
 #include "util/currenton.hpp"
+#include "util/reader_document.hpp"
 
 class SpriteData;
+class WorkerPool;
 
 class SpriteManager final : public Currenton<SpriteManager>
 {
@@ -32,14 +37,56 @@ private:
   typedef std::map<std::string, std::unique_ptr<SpriteData> > Sprites;
   Sprites sprites;
 
+  /** sprite files handed to the worker thread and not yet picked up
+      by process_preloads() */
+  std::set<std::string> preloading;
+
+  /** documents parsed by the worker thread */
+  std::vector<ReaderDocument> parsed;
+
+  /** sprite files the worker thread failed to parse */
+  std::vector<std::string> failed;
+  std::mutex parsed_mutex;
+
+  /** preloaded documents that haven't been turned into SpriteData yet */
+  std::map<std::string, ReaderDocument> documents;
+
+  int preload_hits;
+  int preload_misses;
+
+  /** destroyed first, so that no job outlives the members above */
+  std::unique_ptr<WorkerPool> workers;
+
 public:
   SpriteManager();
+  ~SpriteManager();
 
   /** loads a sprite. */
   SpritePtr create(const std::string& filename);
 
+  /** Parses the given sprite files on a background thread, their
+      images are preloaded by the TextureManager once parsing is done */
+  void preload(const std::vector<std::string>& filenames);
+
+  /** Picks up the parsed sprite files, call this once per frame,
+      load() calls it as well */
+  void process_preloads();
+
+  /** Number of sprite files that were parsed by preload() before they
+      were needed */
+  int get_preload_hits() const { return preload_hits; }
+
+  /** Number of sprite files that had to be parsed on the main thread */
+  int get_preload_misses() const { return preload_misses; }
+
 private:
   SpriteData* load(const std::string& filename);
+
+  static ReaderDocument parse(const std::string& filename);
+
+private:
+  SpriteManager(const SpriteManager&) = delete;
+  SpriteManager& operator=(const SpriteManager&) = delete;
 };
 
 #endif
@@ -26,6 +26,7 @@
 #include "supertux/game_object.hpp"
 #include "supertux/globals.hpp"
 #include "util/log.hpp"
+#include "util/profiler.hpp"
 
 SquirrelEnvironment::SquirrelEnvironment(SquirrelVM& vm, const std::string& name) :
   m_vm(vm),
@@ -149,6 +150,8 @@ SquirrelEnvironment::garbage_collect()
 void
 SquirrelEnvironment::run_script(std::istream& in, const std::string& sourcename)
 {
+  PROFILE_ZONE("SquirrelEnvironment::run_script");
+
   garbage_collect();
 
   try
@@ -181,6 +184,7 @@ SquirrelEnvironment::wait_for_seconds(HSQUIRRELVM vm, float seconds)
 void
 SquirrelEnvironment::update(float dt_sec)
 {
+  PROFILE_ZONE("SquirrelEnvironment::update");
   m_scheduler->update(g_game_time);
 }
 
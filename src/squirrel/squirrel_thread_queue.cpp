@@ -19,6 +19,7 @@
 #include "squirrel/squirrel_virtual_machine.hpp"
 #include "squirrel/squirrel_util.hpp"
 #include "util/log.hpp"
+#include "util/profiler.hpp"
 
 SquirrelThreadQueue::SquirrelThreadQueue(SquirrelVM& vm) :
   m_vm(vm),
@@ -47,6 +48,8 @@ SquirrelThreadQueue::add(HSQUIRRELVM vm)
 void
 SquirrelThreadQueue::wakeup()
 {
+  PROFILE_ZONE("SquirrelThreadQueue::wakeup");
+
   std::vector<HSQOBJECT> threads = std::move(m_threads);
   m_threads.clear();
 
@@ -33,6 +33,7 @@
 #include "supertux/console.hpp"
 #include "supertux/globals.hpp"
 #include "util/log.hpp"
+#include "util/profiler.hpp"
 
 #ifdef ENABLE_SQDBG
 #  include "../../external/squirrel/sqdbg/sqrdbg.h"
@@ -134,6 +135,7 @@ SquirrelVirtualMachine::~SquirrelVirtualMachine()
 void
 SquirrelVirtualMachine::update(float dt_sec)
 {
+  PROFILE_ZONE("SquirrelVirtualMachine::update");
   update_debugger();
   m_scheduler->update(g_game_time);
 }
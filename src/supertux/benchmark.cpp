@@ -0,0 +1,165 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "supertux/benchmark.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <math.h>
+#include <numeric>
+#include <stdio.h>
+#include <string.h>
+
+const char*
+Benchmark::get_section_name(Section section)
+{
+  switch (section)
+  {
+    case STEP: return "step";
+    case SECTOR_UPDATE: return "sector update";
+    case SCRIPTING: return "scripting";
+    case COLLISION: return "collision";
+    case DRAW: return "draw requests";
+    default: return "unknown";
+  }
+}
+
+bool
+Benchmark::is_section_zone(Section section, const char* zone)
+{
+  switch (section)
+  {
+    case SECTOR_UPDATE:
+      return strcmp(zone, "Sector::update") == 0;
+
+    case SCRIPTING:
+      // scripts run from the sector, the global VM and from waking
+      // threads on a screen switch
+      return (strcmp(zone, "SquirrelEnvironment::update") == 0 ||
+              strcmp(zone, "SquirrelEnvironment::run_script") == 0 ||
+              strcmp(zone, "SquirrelVirtualMachine::update") == 0 ||
+              strcmp(zone, "SquirrelThreadQueue::wakeup") == 0);
+
+    case COLLISION:
+      return strcmp(zone, "CollisionSystem::update") == 0;
+
+    case DRAW:
+      return strcmp(zone, "ScreenManager::draw_requests") == 0;
+
+    default:
+      return false;
+  }
+}
+
+Benchmark::Benchmark() :
+  m_current(),
+  m_samples()
+{
+  m_current.fill(0.0f);
+}
+
+void
+Benchmark::add_time(Section section, float msec)
+{
+  m_current[section] += msec;
+}
+
+void
+Benchmark::end_step()
+{
+  for (int i = 0; i < SECTION_COUNT; ++i)
+  {
+    m_samples[i].push_back(m_current[i]);
+    m_current[i] = 0.0f;
+  }
+}
+
+void
+Benchmark::add_frame(const Profiler::Frame& frame)
+{
+  add_time(STEP, static_cast<float>(frame.end - frame.start) / 1.0e6f);
+
+  // the events are in the order the zones were entered, so a zone
+  // nested in a counted one starts before that one ended
+  std::array<int64_t, SECTION_COUNT> counted_end;
+  counted_end.fill(std::numeric_limits<int64_t>::min());
+
+  for (const auto& event : frame.events)
+  {
+    for (int i = 0; i < SECTION_COUNT; ++i)
+    {
+      const Section section = static_cast<Section>(i);
+      if (event.start >= counted_end[i] && is_section_zone(section, event.name))
+      {
+        add_time(section, static_cast<float>(event.end - event.start) / 1.0e6f);
+        counted_end[i] = event.end;
+      }
+    }
+  }
+
+  end_step();
+}
+
+float
+Benchmark::get_percentile(Section section, float percentile) const
+{
+  std::vector<float> samples = m_samples[section];
+  if (samples.empty())
+    return 0.0f;
+
+  const float rank = ceilf(percentile / 100.0f * static_cast<float>(samples.size()));
+  const size_t index = static_cast<size_t>(std::max(rank, 1.0f)) - 1;
+  const auto nth = samples.begin() + std::min(index, samples.size() - 1);
+  std::nth_element(samples.begin(), nth, samples.end());
+  return *nth;
+}
+
+float
+Benchmark::get_mean(Section section) const
+{
+  const auto& samples = m_samples[section];
+  if (samples.empty())
+    return 0.0f;
+
+  return std::accumulate(samples.begin(), samples.end(), 0.0f) / static_cast<float>(samples.size());
+}
+
+void
+Benchmark::print(std::ostream& out) const
+{
+  char line[128];
+
+  out << "Benchmark: " << get_step_count() << " steps, times in milliseconds\n";
+  snprintf(line, sizeof(line), "%-14s %9s %9s %9s %9s %9s\n",
+           "section", "mean", "p50", "p90", "p99", "max");
+  out << line;
+
+  for (int i = 0; i < SECTION_COUNT; ++i)
+  {
+    const Section section = static_cast<Section>(i);
+    snprintf(line, sizeof(line), "%-14s %9.4f %9.4f %9.4f %9.4f %9.4f\n",
+             get_section_name(section),
+             static_cast<double>(get_mean(section)),
+             static_cast<double>(get_percentile(section, 50.0f)),
+             static_cast<double>(get_percentile(section, 90.0f)),
+             static_cast<double>(get_percentile(section, 99.0f)),
+             static_cast<double>(get_percentile(section, 100.0f)));
+    out << line;
+  }
+  out << std::flush;
+}
+
+/* EOF */
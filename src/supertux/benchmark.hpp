@@ -0,0 +1,84 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_SUPERTUX_BENCHMARK_HPP
+#define HEADER_SUPERTUX_SUPERTUX_BENCHMARK_HPP
+
+#include <array>
+#include <ostream>
+#include <vector>
+
+#include "util/currenton.hpp"
+#include "util/profiler.hpp"
+
+/** Collects per-step timings while a demo is replayed with
+    --benchmark, taken from the zones the Profiler recorded for the
+    step. Sections nest, e.g. SECTOR_UPDATE includes SCRIPTING and
+    COLLISION. */
+class Benchmark final : public Currenton<Benchmark>
+{
+public:
+  enum Section {
+    STEP,
+    SECTOR_UPDATE,
+    SCRIPTING,
+    COLLISION,
+    DRAW,
+    SECTION_COUNT
+  };
+
+  static const char* get_section_name(Section section);
+
+  /** Returns whether the time of the profiler zone counts for
+      section, always false for STEP, which is the whole frame. A zone
+      nested in another zone of the same section is not counted
+      again. */
+  static bool is_section_zone(Section section, const char* zone);
+
+public:
+  Benchmark();
+
+  /** Adds time spent in section to the current step */
+  void add_time(Section section, float msec);
+
+  /** Records the time accumulated since the last call as one sample
+      per section */
+  void end_step();
+
+  /** Adds the zone times of frame and ends the step */
+  void add_frame(const Profiler::Frame& frame);
+
+  int get_step_count() const { return static_cast<int>(m_samples[STEP].size()); }
+
+  /** Returns the given percentile (0 to 100) of the samples of
+      section in milliseconds, using the nearest-rank method */
+  float get_percentile(Section section, float percentile) const;
+  float get_mean(Section section) const;
+
+  void print(std::ostream& out) const;
+
+private:
+  std::array<float, SECTION_COUNT> m_current;
+  std::array<std::vector<float>, SECTION_COUNT> m_samples;
+
+private:
+  Benchmark(const Benchmark&) = delete;
+  Benchmark& operator=(const Benchmark&) = delete;
+};
+
+#endif
+
+/* EOF */
@@ -43,6 +43,7 @@ CommandLineArguments::CommandLineArguments() :
   enable_script_debugger(),
   start_demo(),
   record_demo(),
+  benchmark(),
   tux_spawn_pos(),
   sector(),
   spawnpoint(),
@@ -107,6 +108,7 @@ CommandLineArguments::print_help(const char* arg0) const
     << _("Demo Recording Options:") << "\n"
     << _("  --record-demo FILE LEVEL     Record a demo to FILE") << "\n"
     << _("  --play-demo FILE LEVEL       Play a recorded demo") << "\n"
+    << _("  --benchmark FILE LEVEL       Play a demo as fast as possible without video and print timings") << "\n"
     << "\n"
     << _("Directory Options:") << "\n"
     << _("  --datadir DIR                Set the directory for the games datafiles") << "\n"
@@ -310,6 +312,22 @@ CommandLineArguments::parse_args(int argc, char** argv)
         start_demo = argv[++i];
       }
     }
+    else if (arg == "--benchmark")
+    {
+#ifndef ENABLE_PROFILER
+      // the timings are taken from the profiler zones
+      throw std::runtime_error("--benchmark needs a build with ENABLE_PROFILER");
+#endif
+      if (i + 1 >= argc)
+      {
+        throw std::runtime_error("Need to specify a demo filename");
+      }
+      else
+      {
+        start_demo = argv[++i];
+        benchmark = true;
+      }
+    }
     else if (arg == "--record-demo")
     {
       if (i + 1 >= argc)
@@ -389,6 +407,10 @@ CommandLineArguments::parse_args(int argc, char** argv)
   if (filenames.size() > 1 && !(resave && *resave)) {
     throw std::runtime_error("Only one filename allowed for the given options");
   }
+
+  if (benchmark && *benchmark && filenames.empty()) {
+    throw std::runtime_error("Need to specify a level to benchmark");
+  }
 }
 
 void
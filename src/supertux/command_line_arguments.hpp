@@ -68,6 +68,7 @@ public:
   boost::optional<bool> enable_script_debugger;
   boost::optional<std::string> start_demo;
   boost::optional<std::string> record_demo;
+  boost::optional<bool> benchmark;
   boost::optional<Vector> tux_spawn_pos;
   boost::optional<std::string> sector;
   boost::optional<std::string> spawnpoint;
@@ -25,6 +25,12 @@ Debug::Debug() :
   show_collision_rects(false),
   show_worldmap_path(false),
   draw_redundant_frames(false),
+  show_profiler(false),
+  use_collision_broadphase(true),
+  use_object_sleeping(true),
+  use_static_lights(true),
+  use_parallel_update(false),
+  verify_collision_broadphase(false),
   m_use_bitmap_fonts(false),
   m_game_speed_multiplier(1.0f)
 {
@@ -39,6 +39,30 @@ public:
   // vaguely measure the impact of code changes which should increase the FPS
   bool draw_redundant_frames;
 
+  /** Show the zone timings of the profiler */
+  bool show_profiler;
+
+  /** Use the spatial grids of the CollisionSystem for moving
+      vs. moving collision detection and object queries instead of
+      testing every object */
+  bool use_collision_broadphase;
+
+  /** Update objects that can sleep less often while they are far
+      away from the camera */
+  bool use_object_sleeping;
+
+  /** Accumulate lights that don't move into retained light map tiles
+      instead of drawing them every frame */
+  bool use_static_lights;
+
+  /** Update objects that are is_update_thread_safe() on worker
+      threads before the other objects */
+  bool use_parallel_update;
+
+  /** Run the brute-force tests alongside the spatial grids and report
+      objects the grids missed */
+  bool verify_collision_broadphase;
+
 private:
   /** Use old bitmap fonts instead of TTF */
   bool m_use_bitmap_fonts;
@@ -18,6 +18,7 @@
 
 #include <algorithm>
 
+#include "supertux/game_object_manager.hpp"
 #include "supertux/object_remove_listener.hpp"
 #include "util/reader_mapping.hpp"
 #include "util/writer.hpp"
@@ -26,7 +27,15 @@
 GameObject::GameObject() :
   m_name(),
   m_uid(),
+  m_type_slot(0),
   m_scheduled_for_removal(false),
+  m_manager(nullptr),
+  m_sleep_time(0.0f),
+  m_wake_up(false),
+  m_sleeping(false),
+  m_sleep_slot(0),
+  m_sleep_start(0.0),
+  m_add_order(0),
   m_components(),
   m_remove_listeners()
 {
@@ -35,7 +44,15 @@ GameObject::GameObject() :
 GameObject::GameObject(const std::string& name) :
   m_name(name),
   m_uid(),
+  m_type_slot(0),
   m_scheduled_for_removal(false),
+  m_manager(nullptr),
+  m_sleep_time(0.0f),
+  m_wake_up(false),
+  m_sleeping(false),
+  m_sleep_slot(0),
+  m_sleep_start(0.0),
+  m_add_order(0),
   m_components(),
   m_remove_listeners()
 {
@@ -55,6 +72,15 @@ GameObject::~GameObject()
   m_remove_listeners.clear();
 }
 
+void
+GameObject::wake_up()
+{
+  m_wake_up = true;
+  if (m_sleeping && m_manager) {
+    m_manager->wake_up(*this);
+  }
+}
+
 void
 GameObject::add_remove_listener(ObjectRemoveListener* listener)
 {
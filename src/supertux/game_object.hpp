@@ -27,6 +27,7 @@
 
 class DrawingContext;
 class GameObjectComponent;
+class GameObjectManager;
 class ObjectRemoveListener;
 class ReaderMapping;
 class Writer;
@@ -80,6 +81,29 @@ public:
       given GameObjectManager */
   virtual bool is_singleton() const { return false; }
 
+  /** Objects returning true while they are outside of the active
+      region are put to sleep: they are only updated every few steps,
+      with the skipped time added up, see GameObjectManager::update().
+      The result is checked again on every visit, so it may depend on
+      the state of the object, like BadGuy returning true only while
+      it is inactive. While it returns true, update() has to cope with
+      large time steps and must not use gameRandom. */
+  virtual bool can_sleep() const { return false; }
+
+  /** Objects returning true may be updated on a worker thread,
+      alongside other such objects, see
+      GameObjectManager::update_parallel(). Their update() may only
+      change the object itself and read objects that don't change
+      during that phase. Spawning objects and playing sounds is fine,
+      both are deferred until all threads are done. gameRandom must not
+      be used, as that would make demos depend on the thread timing. */
+  virtual bool is_update_thread_safe() const { return false; }
+
+  /** Makes a sleeping object update in the next step, regardless of
+      where it is. Call this when something other than the object's
+      own update() changes it in a way that needs updates. */
+  void wake_up();
+
   /** Does this object have variable size
       (secret area trigger, wind, etc.) */
   virtual bool has_variable_size() const { return false; }
@@ -172,9 +196,36 @@ private:
       set by the GameObjectManager. */
   UID m_uid;
 
+  /** position of the object in its GameObjectManager type bucket */
+  size_t m_type_slot;
+
   /** this flag indicates if the object should be removed at the end of the frame */
   bool m_scheduled_for_removal;
 
+  /** the manager the object was added to, nullptr before that */
+  GameObjectManager* m_manager;
+
+  /** time that passed since the last update() while sleeping, added
+      to the next update() */
+  float m_sleep_time;
+
+  /** set by wake_up(), reset on the next update */
+  bool m_wake_up;
+
+  /** true while the object is in the sleeping list of m_manager */
+  bool m_sleeping;
+
+  /** position in the sleeping list of m_manager */
+  size_t m_sleep_slot;
+
+  /** GameObjectManager time up to which the sleeping object has
+      been updated */
+  double m_sleep_start;
+
+  /** position of the object in the add order of m_manager, woken
+      objects are put back into the update order by it */
+  size_t m_add_order;
+
   std::vector<std::unique_ptr<GameObjectComponent> > m_components;
 
   std::vector<ObjectRemoveListener*> m_remove_listeners;
@@ -260,7 +260,7 @@ GameObjectFactory::init_factories()
   add_factory<worldmap_editor::Teleporter>("teleporter");
   add_factory<worldmap_editor::WorldmapSpawnPoint>("worldmap-spawnpoint");
 
-  add_factory("tilemap", [](const ReaderMapping& reader) {
+  add_factory("tilemap", [](const ReaderMapping& reader) -> std::unique_ptr<GameObject> {
       auto tileset = TileManager::current()->get_tileset(Level::current()->get_tileset());
       return std::make_unique<TileMap>(tileset, reader);
     });
@@ -17,6 +17,8 @@
 #ifndef HEADER_SUPERTUX_SUPERTUX_GAME_OBJECT_ITERATOR_HPP
 #define HEADER_SUPERTUX_SUPERTUX_GAME_OBJECT_ITERATOR_HPP
 
+#include <type_traits>
+#include <typeinfo>
 #include <vector>
 
 #include "game_object_manager.hpp"
@@ -106,19 +108,99 @@ private:
   T* m_object;
 };
 
+/** Iterates over the type bucket of a final class, every object in
+    it is known to be a T, so no cast needs to be checked */
+template<typename T>
+class GameObjectBucketIterator
+{
+public:
+  typedef GameObject* const* Iterator;
+
+public:
+  GameObjectBucketIterator(Iterator it) :
+    m_it(it)
+  {
+  }
+
+  GameObjectBucketIterator& operator++()
+  {
+    ++m_it;
+    return *this;
+  }
+
+  GameObjectBucketIterator operator++(int)
+  {
+    GameObjectBucketIterator tmp(*this);
+    ++m_it;
+    return tmp;
+  }
+
+  T* operator->() const {
+    return static_cast<T*>(*m_it);
+  }
+
+  T& operator*() const {
+    return *static_cast<T*>(*m_it);
+  }
+
+  bool operator==(const GameObjectBucketIterator& other) const
+  {
+    return m_it == other.m_it;
+  }
+
+  bool operator!=(const GameObjectBucketIterator& other) const
+  {
+    return !(*this == other);
+  }
+
+private:
+  Iterator m_it;
+};
+
+/** Range over all objects of type T. Final classes can't have
+    subclasses, so their objects are read straight from the type
+    bucket, other classes fall back to checking every object with
+    dynamic_cast. */
 template<typename T>
 class GameObjectRange
 {
+private:
+  typedef std::integral_constant<bool, std::is_final<T>::value> UseBucket;
+
+public:
+  typedef typename std::conditional<UseBucket::value,
+                                    GameObjectBucketIterator<T>,
+                                    GameObjectIterator<T> >::type Iterator;
+
 public:
   GameObjectRange(const GameObjectManager& manager) :
     m_manager(manager)
   {}
 
-  GameObjectIterator<T> begin() const {
+  Iterator begin() const {
+    return begin(UseBucket());
+  }
+
+  Iterator end() const {
+    return end(UseBucket());
+  }
+
+private:
+  GameObjectBucketIterator<T> begin(std::true_type) const {
+    const auto& bucket = m_manager.get_objects_by_type_index(typeid(T));
+    return GameObjectBucketIterator<T>(bucket.data());
+  }
+
+  GameObjectBucketIterator<T> end(std::true_type) const {
+    const auto& bucket = m_manager.get_objects_by_type_index(typeid(T));
+    return GameObjectBucketIterator<T>(bucket.data() + bucket.size());
+  }
+
+  GameObjectIterator<T> begin(std::false_type) const {
     return GameObjectIterator<T>(m_manager.get_objects().begin(), m_manager.get_objects().end());
   }
 
-  GameObjectIterator<T> end() const {
+  GameObjectIterator<T> end(std::false_type) const {
     return GameObjectIterator<T>(m_manager.get_objects().end(), m_manager.get_objects().end());
   }
 
@@ -19,19 +19,41 @@
 
 #include <algorithm>
 
+#include "collision/collision.hpp"
+#include "math/rectf.hpp"
 #include "object/tilemap.hpp"
+#include "supertux/moving_object.hpp"
+#include "util/command_queue.hpp"
+#include "util/parallel_for.hpp"
+
+namespace {
+
+bool is_in_region(GameObject& object, const Rectf& region)
+{
+  auto moving_object = dynamic_cast<MovingObject*>(&object);
+  return !moving_object || collision::intersects(moving_object->get_bbox(), region);
+}
+
+} // namespace
 
 bool GameObjectManager::s_draw_solids_only = false;
 
 GameObjectManager::GameObjectManager() :
-  m_uid_generator(),
   m_gameobjects(),
   m_gameobjects_new(),
   m_solid_tilemaps(),
   m_objects_by_name(),
   m_objects_by_uid(),
   m_objects_by_type_index(),
-  m_name_resolve_requests()
+  m_name_resolve_requests(),
+  m_awake(),
+  m_woken(),
+  m_next_add_order(0),
+  m_sleeping(),
+  m_sleep_cursor(0),
+  m_time(0.0),
+  m_update_step(0),
+  m_parallel_objects()
 {
 }
 
@@ -81,7 +103,16 @@ GameObjectManager::add_object(std::unique_ptr<GameObject> object)
   assert(object);
   assert(!object->get_uid());
 
-  object->set_uid(m_uid_generator.next());
+  if (CommandQueue* queue = CommandQueue::current())
+  {
+    // Called from an object that is updated on a worker thread, the
+    // object is added on the calling thread of update_parallel()
+    GameObject* ptr = object.release();
+    queue->push([this, ptr]{ add_object(std::unique_ptr<GameObject>(ptr)); });
+    return *ptr;
+  }
+
+  object->set_uid(m_objects_by_uid.insert(object.get()));
 
   // make sure the object isn't already in the list
 #ifndef NDEBUG
@@ -104,23 +135,200 @@ GameObjectManager::clear_objects()
   flush_game_objects();
 
   for (const auto& obj: m_gameobjects) {
+    this_before_object_remove(*obj);
     before_object_remove(*obj);
   }
   m_gameobjects.clear();
+  m_awake.clear();
+  m_woken.clear();
 }
 
 void
 GameObjectManager::update(float dt_sec)
 {
-  for (const auto& object : m_gameobjects)
+  update_objects(dt_sec, nullptr, nullptr);
+}
+
+void
+GameObjectManager::update(float dt_sec, const Rectf& active_region)
+{
+  update_objects(dt_sec, &active_region, nullptr);
+}
+
+void
+GameObjectManager::update_parallel(float dt_sec, const Rectf* active_region, ParallelFor& parallel_for)
+{
+  update_objects(dt_sec, active_region, &parallel_for);
+}
+
+void
+GameObjectManager::update_objects(float dt_sec, const Rectf* active_region, ParallelFor* parallel_for)
+{
+  m_time += dt_sec;
+
+  if (active_region)
   {
-    if (!object->is_valid())
+    m_update_step += 1;
+  }
+  else
+  {
+    // sleeping got turned off
+    while (!m_sleeping.empty()) {
+      wake_up(*m_sleeping.back());
+    }
+  }
+
+  merge_woken();
+
+  if (parallel_for)
+  {
+    m_parallel_objects.clear();
+    for (GameObject* object : m_awake)
+    {
+      if (object->is_valid() && object->is_update_thread_safe())
+        m_parallel_objects.push_back(object);
+    }
+
+    // the object lists don't change until the workers are done, as
+    // add_object() is deferred while they run
+    parallel_for->run(m_parallel_objects.size(),
+                      [this, dt_sec](size_t i) {
+                        update_awake(*m_parallel_objects[i], dt_sec);
+                      });
+  }
+
+  // Objects that fall asleep are dropped from m_awake in place,
+  // objects woken during the loop go to m_woken and get their first
+  // update in the next step
+  const size_t count = m_awake.size();
+  size_t keep = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    GameObject& object = *m_awake[i];
+    if (object.is_valid() && !(parallel_for && object.is_update_thread_safe()))
+    {
+      if (active_region && object.can_sleep() && !object.m_wake_up &&
+          (static_cast<size_t>(m_update_step) + i) % SLEEP_UPDATE_INTERVAL == 0 &&
+          !is_in_region(object, *active_region))
+      {
+        send_to_sleep(object, dt_sec);
+        continue;
+      }
+
+      update_awake(object, dt_sec);
+    }
+    m_awake[keep++] = &object;
+  }
+  m_awake.erase(m_awake.begin() + keep, m_awake.begin() + count);
+
+  if (active_region)
+  {
+    update_sleeping(*active_region);
+  }
+}
+
+void
+GameObjectManager::update_awake(GameObject& object, float dt_sec)
+{
+  object.update(object.m_sleep_time + dt_sec);
+  object.m_sleep_time = 0.0f;
+  object.m_wake_up = false;
+}
+
+void
+GameObjectManager::update_sleeping(const Rectf& active_region)
+{
+  // visit every sleeping object once per SLEEP_UPDATE_INTERVAL steps
+  size_t visits = (m_sleeping.size() + SLEEP_UPDATE_INTERVAL - 1) / SLEEP_UPDATE_INTERVAL;
+  while (visits > 0 && !m_sleeping.empty())
+  {
+    visits -= 1;
+    if (m_sleep_cursor >= m_sleeping.size())
+      m_sleep_cursor = 0;
+
+    GameObject& object = *m_sleeping[m_sleep_cursor];
+    if (!object.is_valid())
+    {
+      // removed in flush_game_objects()
+      m_sleep_cursor += 1;
       continue;
+    }
+
+    object.update(static_cast<float>(m_time - object.m_sleep_start));
+    object.m_sleep_start = m_time;
 
-    object->update(dt_sec);
+    if (!object.can_sleep() || is_in_region(object, active_region))
+    {
+      // the last object takes the freed slot, so the cursor stays
+      remove_from_sleeping(object);
+      m_woken.push_back(&object);
+    }
+    else
+    {
+      m_sleep_cursor += 1;
+    }
   }
 }
 
+void
+GameObjectManager::send_to_sleep(GameObject& object, float dt_sec)
+{
+  // the object hasn't been updated for this step nor for the time
+  // it still had to catch up on
+  object.m_sleep_start = m_time - static_cast<double>(dt_sec) - static_cast<double>(object.m_sleep_time);
+  object.m_sleep_time = 0.0f;
+  object.m_sleeping = true;
+  object.m_sleep_slot = m_sleeping.size();
+  m_sleeping.push_back(&object);
+}
+
+void
+GameObjectManager::wake_up(GameObject& object)
+{
+  if (CommandQueue* queue = CommandQueue::current())
+  {
+    // the sleeping list belongs to the calling thread of update_parallel()
+    GameObject* ptr = &object;
+    queue->push([this, ptr]{ wake_up(*ptr); });
+    return;
+  }
+
+  if (!object.m_sleeping)
+    return;
+
+  remove_from_sleeping(object);
+  object.m_sleep_time = static_cast<float>(m_time - object.m_sleep_start);
+  m_woken.push_back(&object);
+}
+
+void
+GameObjectManager::merge_woken()
+{
+  if (m_woken.empty())
+    return;
+
+  const auto by_add_order = [](const GameObject* lhs, const GameObject* rhs) {
+    return lhs->m_add_order < rhs->m_add_order;
+  };
+
+  std::sort(m_woken.begin(), m_woken.end(), by_add_order);
+  const size_t awake = m_awake.size();
+  m_awake.insert(m_awake.end(), m_woken.begin(), m_woken.end());
+  std::inplace_merge(m_awake.begin(), m_awake.begin() + awake, m_awake.end(), by_add_order);
+  m_woken.clear();
+}
+
+void
+GameObjectManager::remove_from_sleeping(GameObject& object)
+{
+  assert(object.m_sleeping && m_sleeping[object.m_sleep_slot] == &object);
+  GameObject* last = m_sleeping.back();
+  m_sleeping[object.m_sleep_slot] = last;
+  last->m_sleep_slot = object.m_sleep_slot;
+  m_sleeping.pop_back();
+  object.m_sleeping = false;
+}
+
 void
 GameObjectManager::draw(DrawingContext& context)
 {
@@ -143,7 +351,21 @@ GameObjectManager::draw(DrawingContext& context)
 void
 GameObjectManager::flush_game_objects()
 {
-  { // cleanup marked objects
+  { // cleanup marked objects, pooled classes (see Pooled<T>) hand
+    // their memory back to their free list here
+    m_awake.erase(
+      std::remove_if(m_awake.begin(), m_awake.end(),
+                     [](GameObject* obj) {
+                       return !obj->is_valid();
+                     }),
+      m_awake.end());
+    m_woken.erase(
+      std::remove_if(m_woken.begin(), m_woken.end(),
+                     [](GameObject* obj) {
+                       return !obj->is_valid();
+                     }),
+      m_woken.end());
+
     m_gameobjects.erase(
       std::remove_if(m_gameobjects.begin(), m_gameobjects.end(),
                      [this](const std::unique_ptr<GameObject>& obj) {
@@ -171,6 +393,10 @@ GameObjectManager::flush_game_objects()
           this_before_object_add(*object);
           m_gameobjects.push_back(std::move(object));
         }
+        else
+        {
+          m_objects_by_uid.erase(object->get_uid());
+        }
       }
     }
   }
@@ -208,14 +434,20 @@ GameObjectManager::this_before_object_add(GameObject& object)
     }
   }
 
-  { // by_id
-    assert(object.get_uid());
-
-    m_objects_by_uid[object.get_uid()] = &object;
+  { // by_id, the uid was already registered in add_object()
+    assert(m_objects_by_uid.get(object.get_uid()) == &object);
   }
 
   { // by_type_index
-    m_objects_by_type_index[std::type_index(typeid(object))].push_back(&object);
+    auto& vec = m_objects_by_type_index[std::type_index(typeid(object))];
+    object.m_type_slot = vec.size();
+    vec.push_back(&object);
+  }
+
+  { // update lists
+    object.m_manager = this;
+    object.m_add_order = m_next_add_order++;
+    m_awake.push_back(&object);
   }
 }
 
@@ -236,9 +468,19 @@ GameObjectManager::this_before_object_remove(GameObject& object)
 
   { // by_type_index
     auto& vec = m_objects_by_type_index[std::type_index(typeid(object))];
-    auto it = std::find(vec.begin(), vec.end(), &object);
-    assert(it != vec.end());
-    vec.erase(it);
+    assert(object.m_type_slot < vec.size() && vec[object.m_type_slot] == &object);
+    GameObject* last = vec.back();
+    vec[object.m_type_slot] = last;
+    last->m_type_slot = object.m_type_slot;
+    vec.pop_back();
+  }
+
+  { // update lists, m_awake is cleaned up by the caller
+    if (object.m_sleeping)
+    {
+      remove_from_sleeping(object);
+    }
+    object.m_manager = nullptr;
   }
 }
 
@@ -24,9 +24,11 @@
 #include <vector>
 
 #include "supertux/game_object.hpp"
-#include "util/uid_generator.hpp"
+#include "util/uid_table.hpp"
 
 class DrawingContext;
+class ParallelFor;
+class Rectf;
 class TileMap;
 
 template<class T> class GameObjectRange;
@@ -60,7 +62,31 @@ public:
     return obj_ref;
   }
 
+  static const int SLEEP_UPDATE_INTERVAL = 10;
+
   void update(float dt_sec);
+
+  /** Like update(dt_sec), but objects that can_sleep() and are
+      outside of active_region are moved to a sleeping list. Each step
+      visits 1/SLEEP_UPDATE_INTERVAL of that list, updates the visited
+      objects with the time they slept and wakes those that are back in
+      the region. Objects that can sleep are only checked against the
+      region every SLEEP_UPDATE_INTERVAL steps. */
+  void update(float dt_sec, const Rectf& active_region);
+
+  /** Like update(), but the objects that are is_update_thread_safe()
+      are updated first and spread over the threads of parallel_for,
+      the other objects are updated afterwards on the calling thread.
+      Objects added during the parallel part are queued up in the
+      order a serial update would have added them. Sleeping works as
+      in update(dt_sec, active_region) unless active_region is
+      nullptr. */
+  void update_parallel(float dt_sec, const Rectf* active_region, ParallelFor& parallel_for);
+
+  /** Moves a sleeping object back to the awake objects, called by
+      GameObject::wake_up() */
+  void wake_up(GameObject& object);
+
   void draw(DrawingContext& context);
 
   const std::vector<std::unique_ptr<GameObject> >& get_objects() const;
@@ -114,27 +140,22 @@ public:
   template<class T>
   T* get_object_by_uid(const UID& uid) const
   {
-    auto it = m_objects_by_uid.find(uid);
-    if (it == m_objects_by_uid.end())
+    // Objects are registered in add_object(), so objects that are
+    // still waiting for flush_game_objects() are found as well
+    GameObject* object = m_objects_by_uid.get(uid);
+    if (!object)
     {
-      // FIXME: Is this a good idea? Should gameobjects be made
-      // accessible even when not fully inserted into the manager?
-      for (auto&& itnew : m_gameobjects_new)
-      {
-        if (itnew->get_uid() == uid)
-          return static_cast<T*>(itnew.get());
-      }
       return nullptr;
     }
     else
     {
 #ifdef NDEBUG
-      return static_cast<T*>(it->second);
+      return static_cast<T*>(object);
 #else
       // Since uids should be unique, there should be no need to guess
       // the type, thus we assert() when the object type is not what
       // we expected.
-      auto ptr = dynamic_cast<T*>(it->second);
+      auto ptr = dynamic_cast<T*>(object);
       assert(ptr != nullptr);
       return ptr;
 #endif
@@ -196,12 +217,24 @@ protected:
   }
 
 private:
+  void update_objects(float dt_sec, const Rectf* active_region, ParallelFor* parallel_for);
+
+  /** Updates an awake object, catching up on the time it slept */
+  void update_awake(GameObject& object, float dt_sec);
+
+  /** Visits the next slice of m_sleeping */
+  void update_sleeping(const Rectf& active_region);
+
+  void send_to_sleep(GameObject& object, float dt_sec);
+
+  /** Moves m_woken into m_awake, keeping m_awake in add order */
+  void merge_woken();
+  void remove_from_sleeping(GameObject& object);
+
   void this_before_object_add(GameObject& object);
   void this_before_object_remove(GameObject& object);
 
 private:
-  UIDGenerator m_uid_generator;
-
   std::vector<std::unique_ptr<GameObject>> m_gameobjects;
 
   /** container for newly created objects, they'll be added in flush_game_objects() */
@@ -211,11 +244,48 @@ private:
   std::vector<TileMap*> m_solid_tilemaps;
 
   std::unordered_map<std::string, GameObject*> m_objects_by_name;
-  std::unordered_map<UID, GameObject*> m_objects_by_uid;
+
+  /** Hands out the UIDs of the objects, from add_object() until they
+      are removed */
+  UIDTable<GameObject*> m_objects_by_uid;
+
+  /** Objects by their exact type, the order within a bucket is not
+      stable as removal moves the last object into the freed slot */
   std::unordered_map<std::type_index, std::vector<GameObject*> > m_objects_by_type_index;
 
   std::vector<NameResolveRequest> m_name_resolve_requests;
 
+  /** Objects that are updated every step, in the order they were
+      added */
+  std::vector<GameObject*> m_awake;
+
+  /** Objects woken since the last update, they are merged back into
+      m_awake by their m_add_order at the start of the next update */
+  std::vector<GameObject*> m_woken;
+
+  /** m_add_order of the next added object */
+  size_t m_next_add_order;
+
+  /** Objects that are only visited every SLEEP_UPDATE_INTERVAL steps */
+  std::vector<GameObject*> m_sleeping;
+
+  /** next object of m_sleeping to visit */
+  size_t m_sleep_cursor;
+
+  /** sum of the update() time steps, sleeping objects are updated
+      with the time that passed since their m_sleep_start. A double,
+      as a float sum would lose the fractions of a step after a few
+      hours of play. */
+  double m_time;
+
+  /** number of update() calls with an active region, used to spread
+      the region checks over the steps */
+  int m_update_step;
+
+  /** Awake objects that update_parallel() hands to the worker
+      threads, kept around to avoid reallocation */
+  std::vector<GameObject*> m_parallel_objects;
+
 private:
   GameObjectManager(const GameObjectManager&) = delete;
   GameObjectManager& operator=(const GameObjectManager&) = delete;
@@ -37,9 +37,11 @@
 #include "supertux/screen_manager.hpp"
 #include "supertux/sector.hpp"
 #include "util/file_system.hpp"
+#include "util/profiler.hpp"
 #include "video/compositor.hpp"
 #include "video/drawing_context.hpp"
 #include "video/surface.hpp"
+#include "video/texture_manager.hpp"
 #include "worldmap/worldmap.hpp"
 
 GameSession::GameSession(const std::string& levelfile_, Savegame& savegame, Statistics* statistics) :
@@ -115,6 +117,11 @@ GameSession::restart_level(bool after_death)
     m_levelfile = FileSystem::basename(m_levelfile);
   }
 
+  // textures warmed for the previous level aren't needed anymore
+  if (auto texture_manager = TextureManager::current()) {
+    texture_manager->release_preloads();
+  }
+
   try {
     m_old_level = std::move(m_level);
     m_level = LevelParser::from_file(m_levelfile, false, false);
@@ -299,6 +306,8 @@ GameSession::leave()
 void
 GameSession::update(float dt_sec, const Controller& controller)
 {
+  PROFILE_ZONE("GameSession::update");
+
   // Set active flag
   if (!m_active)
   {
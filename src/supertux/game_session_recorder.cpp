@@ -136,6 +136,12 @@ GameSessionRecorder::reset_demo_controller()
   player.set_controller(m_demo_controller.get());
 }
 
+bool
+GameSessionRecorder::is_demo_finished() const
+{
+  return m_playback_demo_stream != nullptr && !m_playback_demo_stream->good();
+}
+
 void
 GameSessionRecorder::process_events()
 {
@@ -144,7 +150,8 @@ GameSessionRecorder::process_events()
   {
     m_demo_controller->update();
 
-    char left, right, up, down, jump, action;
+    // all buttons are released once the demo runs out of input
+    char left = 0, right = 0, up = 0, down = 0, jump = 0, action = 0;
 
     m_playback_demo_stream->get(left);
     m_playback_demo_stream->get(right);
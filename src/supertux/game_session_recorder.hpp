@@ -40,6 +40,9 @@ public:
 
   bool is_playing_demo() const { return m_playing; }
 
+  /** Returns true once the demo being played back ran out of input */
+  bool is_demo_finished() const;
+
 private:
   void capture_demo_step();
 
@@ -30,6 +30,9 @@ Config::Config() :
   window_resizable(true),
   aspect_size(0, 0), // auto detect
   magnification(0.0f),
+  use_texture_atlas(false),
+  texture_atlas_size(2048),
+  use_glyph_atlas(false),
   use_fullscreen(false),
   video(VideoSystem::VIDEO_AUTO),
   try_vsync(true),
@@ -54,6 +57,7 @@ Config::Config() :
   transitions_enabled(true),
   confirmation_dialog(false),
   pause_on_focusloss(true),
+  use_level_cache(true),
   repository_url()
 {
 }
@@ -76,6 +80,7 @@ Config::load()
   config_mapping.get("developer", developer_mode);
   config_mapping.get("confirmation_dialog", confirmation_dialog);
   config_mapping.get("pause_on_focusloss", pause_on_focusloss);
+  config_mapping.get("level_cache", use_level_cache);
 
   if (is_christmas()) {
     if (!config_mapping.get("christmas", christmas_mode))
@@ -116,6 +121,10 @@ Config::load()
     config_video_mapping->get("aspect_height", aspect_size.height);
 
     config_video_mapping->get("magnification", magnification);
+
+    config_video_mapping->get("texture_atlas", use_texture_atlas);
+    config_video_mapping->get("texture_atlas_size", texture_atlas_size);
+    config_video_mapping->get("glyph_atlas", use_glyph_atlas);
   }
 
   boost::optional<ReaderMapping> config_audio_mapping;
@@ -182,6 +191,7 @@ Config::save()
   writer.write("developer", developer_mode);
   writer.write("confirmation_dialog", confirmation_dialog);
   writer.write("pause_on_focusloss", pause_on_focusloss);
+  writer.write("level_cache", use_level_cache);
   if (is_christmas()) {
     writer.write("christmas", christmas_mode);
   }
@@ -213,6 +223,10 @@ Config::save()
 
   writer.write("magnification", magnification);
 
+  writer.write("texture_atlas", use_texture_atlas);
+  writer.write("texture_atlas_size", texture_atlas_size);
+  writer.write("glyph_atlas", use_glyph_atlas);
+
   writer.end_list("video");
 
   writer.start_list("audio");
@@ -54,6 +54,15 @@ public:
 
   float magnification;
 
+  /** pack small images into shared textures, see TextureAtlas */
+  bool use_texture_atlas;
+  int texture_atlas_size;
+
+  /** draw TTF text from a shared glyph atlas instead of rendering
+      each string into its own texture, off by default as the glyphs
+      are placed by advance only, without kerning or shaping */
+  bool use_glyph_atlas;
+
   bool use_fullscreen;
   VideoSystem::Enum video;
   bool try_vsync;
@@ -96,6 +105,9 @@ public:
   bool confirmation_dialog;
   bool pause_on_focusloss;
 
+  /** keep a binary copy of loaded levels, see LevelCache */
+  bool use_level_cache;
+
   std::string repository_url;
 
   bool is_christmas() const {
@@ -0,0 +1,175 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "supertux/level_cache.hpp"
+
+#include <physfs.h>
+#include <sstream>
+#include <stdexcept>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#include "physfs/ofile_stream.hpp"
+#include "physfs/util.hpp"
+#include "util/binary_sexp.hpp"
+#include "util/log.hpp"
+#include "util/reader_document.hpp"
+
+namespace {
+
+const char* const CACHE_DIRECTORY = "cache/levels";
+const char CACHE_MAGIC[4] = { 'S', 'T', 'L', 'C' };
+const uint32_t CACHE_VERSION = 1;
+
+struct Header
+{
+  char magic[4];
+  uint32_t version;
+  int64_t modtime;
+  uint64_t filesize;
+
+  /** hash of the source file contents */
+  uint64_t source_hash;
+
+  /** hash of the binary payload following the header */
+  uint64_t payload_hash;
+};
+
+uint64_t fnv1a(const char* data, size_t size)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<uint8_t>(data[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+std::string get_cache_filename(const std::string& filename)
+{
+  const std::string path = physfsutil::realpath(filename);
+  std::ostringstream out;
+  out << CACHE_DIRECTORY << '/' << std::hex << fnv1a(path.data(), path.size()) << ".stlc";
+  return out.str();
+}
+
+/** Reads the whole file with a single read call */
+bool read_file(const std::string& filename, std::vector<char>& data)
+{
+  PHYSFS_File* file = PHYSFS_openRead(filename.c_str());
+  if (!file)
+    return false;
+
+  const PHYSFS_sint64 size = PHYSFS_fileLength(file);
+  if (size < 0) {
+    PHYSFS_close(file);
+    return false;
+  }
+
+  data.resize(static_cast<size_t>(size));
+  const PHYSFS_sint64 count = PHYSFS_readBytes(file, data.data(), data.size());
+  PHYSFS_close(file);
+  return count == size;
+}
+
+} // namespace
+
+boost::optional<ReaderDocument>
+LevelCache::load(const std::string& filename)
+{
+  try
+  {
+    PHYSFS_Stat statbuf;
+    if (!PHYSFS_stat(filename.c_str(), &statbuf))
+      return boost::none;
+
+    std::vector<char> data;
+    if (!read_file(get_cache_filename(filename), data) || data.size() < sizeof(Header))
+      return boost::none;
+
+    Header header;
+    memcpy(&header, data.data(), sizeof(header));
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.version != CACHE_VERSION ||
+        header.modtime != statbuf.modtime ||
+        header.filesize != static_cast<uint64_t>(statbuf.filesize))
+      return boost::none;
+
+    // the modification time only has a resolution of a second, so
+    // compare the contents as well
+    std::vector<char> source;
+    if (!read_file(filename, source) ||
+        header.source_hash != fnv1a(source.data(), source.size()))
+      return boost::none;
+
+    const char* payload = data.data() + sizeof(header);
+    const size_t payload_size = data.size() - sizeof(header);
+    if (header.payload_hash != fnv1a(payload, payload_size))
+    {
+      log_warning << "Level cache for '" << filename << "' is corrupt" << std::endl;
+      return boost::none;
+    }
+
+    return ReaderDocument(filename, binary_sexp::read(payload, payload_size));
+  }
+  catch(const std::exception& e)
+  {
+    log_warning << "Couldn't read level cache for '" << filename << "': " << e.what() << std::endl;
+    return boost::none;
+  }
+}
+
+void
+LevelCache::store(const std::string& filename, const ReaderDocument& doc)
+{
+  try
+  {
+    PHYSFS_Stat statbuf;
+    std::vector<char> source;
+    if (!PHYSFS_stat(filename.c_str(), &statbuf) || !read_file(filename, source))
+      return;
+
+    if (!PHYSFS_exists(CACHE_DIRECTORY) && !PHYSFS_mkdir(CACHE_DIRECTORY))
+    {
+      std::ostringstream msg;
+      msg << "Couldn't create directory '" << CACHE_DIRECTORY << "': " << PHYSFS_getLastErrorCode();
+      throw std::runtime_error(msg.str());
+    }
+
+    std::ostringstream payload_stream;
+    binary_sexp::write(payload_stream, doc.get_sexp());
+    const std::string payload = payload_stream.str();
+
+    Header header;
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.modtime = statbuf.modtime;
+    header.filesize = static_cast<uint64_t>(statbuf.filesize);
+    header.source_hash = fnv1a(source.data(), source.size());
+    header.payload_hash = fnv1a(payload.data(), payload.size());
+
+    OFileStream out(get_cache_filename(filename));
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(payload.data(), payload.size());
+  }
+  catch(const std::exception& e)
+  {
+    log_warning << "Couldn't write level cache for '" << filename << "': " << e.what() << std::endl;
+  }
+}
+
+/* EOF */
@@ -0,0 +1,47 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_SUPERTUX_LEVEL_CACHE_HPP
+#define HEADER_SUPERTUX_SUPERTUX_LEVEL_CACHE_HPP
+
+#include <boost/optional.hpp>
+#include <string>
+
+class ReaderDocument;
+
+/** Keeps a binary copy of parsed level files in the user directory,
+    so that loading a level skips the sexp lexer. A cache entry is
+    only used when the modification time, size and content hash of
+    the source file still match. */
+class LevelCache final
+{
+public:
+  /** Returns the cached document for filename or none if there is no
+      cache entry or it is stale */
+  static boost::optional<ReaderDocument> load(const std::string& filename);
+
+  /** Stores doc, which was parsed from filename, in the cache */
+  static void store(const std::string& filename, const ReaderDocument& doc);
+
+private:
+  LevelCache() = delete;
+  LevelCache(const LevelCache&) = delete;
+  LevelCache& operator=(const LevelCache&) = delete;
+};
+
+#endif
+
+/* EOF */
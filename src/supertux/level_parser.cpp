@@ -19,13 +19,62 @@
 #include <physfs.h>
 #include <sstream>
 
+#include "supertux/gameconfig.hpp"
+#include "supertux/globals.hpp"
 #include "supertux/level.hpp"
+#include "supertux/level_cache.hpp"
 #include "supertux/sector.hpp"
 #include "supertux/sector_parser.hpp"
 #include "util/log.hpp"
 #include "util/reader.hpp"
 #include "util/reader_document.hpp"
 #include "util/reader_mapping.hpp"
+#include "util/string_util.hpp"
+
+namespace {
+
+void add_resource(const std::string& name, Sector::PrefetchFiles& files)
+{
+  if (StringUtil::has_suffix(name, ".sprite")) {
+    files.sprites.insert(name);
+  } else if (StringUtil::has_suffix(name, ".png") || StringUtil::has_suffix(name, ".jpg")) {
+    files.images.insert(name);
+  } else if (StringUtil::has_suffix(name, ".wav") || StringUtil::has_suffix(name, ".ogg")) {
+    files.sounds.insert(name);
+  }
+}
+
+/** Collects every string of a sector that names a sprite, an image or
+    a sound, including quoted names in scripts. Objects that use their
+    default sprite or built-in sounds don't show up here. */
+void collect_resources(const sexp::Value& sx, Sector::PrefetchFiles& files)
+{
+  if (sx.is_array())
+  {
+    for (const auto& item : sx.as_array()) {
+      collect_resources(item, files);
+    }
+  }
+  else if (sx.is_string())
+  {
+    const std::string& str = sx.as_string();
+    if (str.find('"') == std::string::npos) {
+      add_resource(str, files);
+    } else {
+      // a script, look at its string literals
+      std::string::size_type start = str.find('"');
+      while (start != std::string::npos) {
+        const std::string::size_type end = str.find('"', start + 1);
+        if (end == std::string::npos)
+          break;
+        add_resource(str.substr(start + 1, end - start - 1), files);
+        start = str.find('"', end + 1);
+      }
+    }
+  }
+}
+
+} // namespace
 
 std::string
 LevelParser::get_level_name(const std::string& filename)
@@ -134,7 +183,17 @@ LevelParser::load(const std::string& filepath)
   m_level.m_filename = filepath;
   register_translation_directory(filepath);
   try {
+    if (g_config->use_level_cache) {
+      if (auto cached = LevelCache::load(filepath)) {
+        load(*cached);
+        return;
+      }
+    }
+
     auto doc = ReaderDocument::from_file(filepath);
+    if (g_config->use_level_cache) {
+      LevelCache::store(filepath, doc);
+    }
     load(doc);
   } catch(std::exception& e) {
     std::stringstream msg;
@@ -172,6 +231,9 @@ LevelParser::load(const ReaderDocument& doc)
     while (iter.next()) {
       if (iter.get_key() == "sector") {
         auto sector = SectorParser::from_reader(m_level, iter.as_mapping(), m_editable);
+        Sector::PrefetchFiles files;
+        collect_resources(iter.as_mapping().get_sexp(), files);
+        sector->set_prefetch_files(std::move(files));
         m_level.add_sector(std::move(sector));
       }
     }
@@ -196,6 +258,9 @@ LevelParser::load_old_format(const ReaderMapping& reader)
   reader.get("author", m_level.m_author);
 
   auto sector = SectorParser::from_reader_old_format(m_level, reader, m_editable);
+  Sector::PrefetchFiles files;
+  collect_resources(reader.get_sexp(), files);
+  sector->set_prefetch_files(std::move(files));
   m_level.add_sector(std::move(sector));
 }
 
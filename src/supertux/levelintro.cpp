@@ -65,6 +65,10 @@ LevelIntro::~LevelIntro()
 void
 LevelIntro::setup()
 {
+  // load what the sectors name while the intro is shown
+  for (size_t i = 0; i < m_level.get_sector_count(); ++i) {
+    m_level.get_sector(i)->prefetch();
+  }
 }
 
 void
@@ -50,6 +50,7 @@ extern "C" {
 #include "physfs/physfs_sdl.hpp"
 #include "sprite/sprite_data.hpp"
 #include "sprite/sprite_manager.hpp"
+#include "supertux/benchmark.hpp"
 #include "supertux/command_line_arguments.hpp"
 #include "supertux/console.hpp"
 #include "supertux/game_manager.hpp"
@@ -70,8 +71,8 @@ extern "C" {
 #include "supertux/world.hpp"
 #include "util/file_system.hpp"
 #include "util/gettext.hpp"
+#include "util/profiler.hpp"
 #include "util/string_util.hpp"
-#include "util/timelog.hpp"
 #include "util/string_util.hpp"
 #include "video/sdl_surface.hpp"
 #include "video/sdl_surface_ptr.hpp"
@@ -79,8 +80,6 @@ extern "C" {
 #include "worldmap/worldmap.hpp"
 #include "worldmap/worldmap_screen.hpp"
 
-static Timelog s_timelog;
-
 class ConfigSubsystem final
 {
 public:
@@ -396,49 +395,55 @@ Main::resave(const std::string& input_filename, const std::string& output_filena
 void
 Main::launch_game(const CommandLineArguments& args)
 {
+  const bool benchmark_mode = args.benchmark && *args.benchmark;
+  if (benchmark_mode) {
+    // allow benchmarking on machines without a display
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+  }
+
   SDLSubsystem sdl_subsystem;
   ConsoleBuffer console_buffer;
 
-  s_timelog.log("controller");
+  PROFILE_PHASE("controller");
   InputManager input_manager(g_config->keyboard_config, g_config->joystick_config);
 
-  s_timelog.log("commandline");
+  PROFILE_PHASE("commandline");
 
   auto video = g_config->video;
-  if (args.resave && *args.resave) {
+  if ((args.resave && *args.resave) || benchmark_mode) {
     if (args.video) {
       video = *args.video;
     } else {
       video = VideoSystem::VIDEO_NULL;
     }
   }
-  s_timelog.log("video");
+  PROFILE_PHASE("video");
   std::unique_ptr<VideoSystem> video_system = VideoSystem::create(video);
   init_video();
 
   TTFSurfaceManager ttf_surface_manager;
 
-  s_timelog.log("audio");
+  PROFILE_PHASE("audio");
   SoundManager sound_manager;
-  sound_manager.enable_sound(g_config->sound_enabled);
-  sound_manager.enable_music(g_config->music_enabled);
+  sound_manager.enable_sound(g_config->sound_enabled && !benchmark_mode);
+  sound_manager.enable_music(g_config->music_enabled && !benchmark_mode);
   sound_manager.set_sound_volume(g_config->sound_volume);
   sound_manager.set_music_volume(g_config->music_volume);
 
-  s_timelog.log("scripting");
+  PROFILE_PHASE("scripting");
   SquirrelVirtualMachine scripting(g_config->enable_script_debugger);
 
-  s_timelog.log("resources");
+  PROFILE_PHASE("resources");
   TileManager tile_manager;
   SpriteManager sprite_manager;
   Resources resources;
 
-  s_timelog.log("addons");
+  PROFILE_PHASE("addons");
   AddonManager addon_manager("addons", g_config->addons);
 
   Console console(console_buffer);
 
-  s_timelog.log(nullptr);
+  PROFILE_PHASE(nullptr);
 
   const auto default_savegame = std::make_unique<Savegame>(std::string());
 
@@ -531,7 +536,16 @@ Main::launch_game(const CommandLineArguments& args)
     }
   }
 
+  std::unique_ptr<Benchmark> benchmark;
+  if (benchmark_mode) {
+    benchmark = std::make_unique<Benchmark>();
+  }
+
   screen_manager.run();
+
+  if (benchmark) {
+    benchmark->print(std::cout);
+  }
 }
 
 int
@@ -579,11 +593,11 @@ Main::run(int argc, char** argv)
     PhysfsSubsystem physfs_subsystem(argv[0], args.datadir, args.userdir);
     physfs_subsystem.print_search_path();
 
-    s_timelog.log("config");
+    PROFILE_PHASE("config");
     ConfigSubsystem config_subsystem;
     args.merge_into(*g_config);
 
-    s_timelog.log("tinygettext");
+    PROFILE_PHASE("tinygettext");
     init_tinygettext();
 
     switch (args.get_action())
@@ -19,11 +19,17 @@
 #include <algorithm>
 #include <sstream>
 
+#include "audio/sound_manager.hpp"
 #include "gui/item_stringselect.hpp"
+#include "physfs/ofile_stream.hpp"
+#include "sprite/sprite_manager.hpp"
 #include "supertux/debug.hpp"
 #include "supertux/gameconfig.hpp"
 #include "supertux/globals.hpp"
 #include "util/gettext.hpp"
+#include "util/log.hpp"
+#include "util/object_pool.hpp"
+#include "util/profiler.hpp"
 #include "video/texture_manager.hpp"
 
 DebugMenu::DebugMenu() :
@@ -66,10 +72,42 @@ DebugMenu::DebugMenu() :
   add_toggle(-1, _("Show Framerate"), &g_config->show_fps);
   add_toggle(-1, _("Draw Redundant Frames"), &g_debug.draw_redundant_frames);
   add_toggle(-1, _("Show Player Position"), &g_config->show_player_pos);
+  add_toggle(-1, _("Collision Broadphase"), &g_debug.use_collision_broadphase);
+  add_toggle(-1, _("Verify Collision Broadphase"), &g_debug.verify_collision_broadphase);
+  add_toggle(-1, _("Object Sleeping"), &g_debug.use_object_sleeping);
+  add_toggle(-1, _("Static Light Layer"), &g_debug.use_static_lights);
+  add_toggle(-1, _("Parallel Object Update"), &g_debug.use_parallel_update);
   add_toggle(-1, _("Use Bitmap Fonts"),
              []{ return g_debug.get_use_bitmap_fonts(); },
              [](bool value){ g_debug.set_use_bitmap_fonts(value); });
   add_entry(_("Dump Texture Cache"), []{ TextureManager::current()->debug_print(std::cout); });
+  add_entry(_("Print Preload Statistics"), []{
+      log_info << "sprite preload hits: " << SpriteManager::current()->get_preload_hits()
+               << " misses: " << SpriteManager::current()->get_preload_misses() << std::endl;
+      log_info << "texture preload hits: " << TextureManager::current()->get_preload_hits()
+               << " misses: " << TextureManager::current()->get_preload_misses() << std::endl;
+      log_info << "sound cache hits: " << SoundManager::current()->get_cache_hits()
+               << " misses: " << SoundManager::current()->get_cache_misses()
+               << " evictions: " << SoundManager::current()->get_cache_evictions()
+               << " bytes: " << SoundManager::current()->get_cache_size() << std::endl;
+    });
+  add_entry(_("Print Object Pool Statistics"), []{
+      for (const auto* stats : ObjectPoolStats::get_all()) {
+        log_info << stats->get_name() << ": allocations: " << stats->allocations
+                 << " reused: " << stats->reuses
+                 << " live: " << stats->live
+                 << " free: " << stats->free << std::endl;
+      }
+    });
+#ifdef ENABLE_PROFILER
+  add_toggle(-1, _("Show Profiler"), &g_debug.show_profiler);
+  add_entry(_("Save Profiler Trace"), []{
+      const std::string filename = "profile.json";
+      OFileStream out(filename);
+      Profiler::instance().write_chrome_trace(out);
+      log_info << "Wrote profiler trace to " << filename << std::endl;
+    });
+#endif
 
   add_hl();
   add_back(_("Back"));
@@ -18,6 +18,7 @@
 
 #include "gui/menu_item.hpp"
 #include "editor/editor.hpp"
+#include "editor/undo_manager.hpp"
 #include "supertux/level.hpp"
 #include "supertux/sector.hpp"
 #include "util/gettext.hpp"
@@ -74,6 +75,7 @@ EditorSectorMenu::menu_action(MenuItem& item)
   switch (item.get_id()) {
     case MNID_RESIZESECTOR:
       if (new_size.is_valid()) {
+        Editor::current()->get_undo_manager().record_sector(*sector);
         sector->resize_sector(size, new_size, offset);
         size = new_size;
       }
@@ -53,14 +53,14 @@ MovingObject::get_settings()
 void
 MovingObject::editor_select()
 {
-  Sector::get().add<ResizeMarker>(&m_col.m_bbox, ResizeMarker::Side::LEFT_UP, ResizeMarker::Side::LEFT_UP);
-  Sector::get().add<ResizeMarker>(&m_col.m_bbox, ResizeMarker::Side::LEFT_UP, ResizeMarker::Side::NONE);
-  Sector::get().add<ResizeMarker>(&m_col.m_bbox, ResizeMarker::Side::LEFT_UP, ResizeMarker::Side::RIGHT_DOWN);
-  Sector::get().add<ResizeMarker>(&m_col.m_bbox, ResizeMarker::Side::NONE, ResizeMarker::Side::LEFT_UP);
-  Sector::get().add<ResizeMarker>(&m_col.m_bbox, ResizeMarker::Side::NONE, ResizeMarker::Side::RIGHT_DOWN);
-  Sector::get().add<ResizeMarker>(&m_col.m_bbox, ResizeMarker::Side::RIGHT_DOWN, ResizeMarker::Side::LEFT_UP);
-  Sector::get().add<ResizeMarker>(&m_col.m_bbox, ResizeMarker::Side::RIGHT_DOWN, ResizeMarker::Side::NONE);
-  Sector::get().add<ResizeMarker>(&m_col.m_bbox, ResizeMarker::Side::RIGHT_DOWN, ResizeMarker::Side::RIGHT_DOWN);
+  Sector::get().add<ResizeMarker>(&m_col, ResizeMarker::Side::LEFT_UP, ResizeMarker::Side::LEFT_UP);
+  Sector::get().add<ResizeMarker>(&m_col, ResizeMarker::Side::LEFT_UP, ResizeMarker::Side::NONE);
+  Sector::get().add<ResizeMarker>(&m_col, ResizeMarker::Side::LEFT_UP, ResizeMarker::Side::RIGHT_DOWN);
+  Sector::get().add<ResizeMarker>(&m_col, ResizeMarker::Side::NONE, ResizeMarker::Side::LEFT_UP);
+  Sector::get().add<ResizeMarker>(&m_col, ResizeMarker::Side::NONE, ResizeMarker::Side::RIGHT_DOWN);
+  Sector::get().add<ResizeMarker>(&m_col, ResizeMarker::Side::RIGHT_DOWN, ResizeMarker::Side::LEFT_UP);
+  Sector::get().add<ResizeMarker>(&m_col, ResizeMarker::Side::RIGHT_DOWN, ResizeMarker::Side::NONE);
+  Sector::get().add<ResizeMarker>(&m_col, ResizeMarker::Side::RIGHT_DOWN, ResizeMarker::Side::RIGHT_DOWN);
 }
 
 /* EOF */
@@ -17,6 +17,7 @@
 
 #include "supertux/object_factory.hpp"
 
+#include <algorithm>
 #include <sstream>
 
 #include "supertux/game_object.hpp"
@@ -26,10 +27,36 @@ ObjectFactory::ObjectFactory() :
 {
 }
 
+std::vector<ObjectFactory::Factory>::const_iterator
+ObjectFactory::find(const std::string& name) const
+{
+  const auto it = std::lower_bound(factories.begin(), factories.end(), name,
+                                   [](const Factory& factory, const std::string& key) {
+                                     return factory.name < key;
+                                   });
+  if (it != factories.end() && it->name == name) {
+    return it;
+  } else {
+    return factories.end();
+  }
+}
+
+void
+ObjectFactory::add_factory(const char* name, FactoryFunction func)
+{
+  assert(find(name) == factories.end());
+
+  const auto it = std::lower_bound(factories.begin(), factories.end(), name,
+                                   [](const Factory& factory, const char* key) {
+                                     return factory.name < key;
+                                   });
+  factories.insert(it, Factory{name, func});
+}
+
 std::unique_ptr<GameObject>
 ObjectFactory::create(const std::string& name, const ReaderMapping& reader) const
 {
-  auto it = factories.find(name);
+  const auto it = find(name);
 
   if (it == factories.end())
   {
@@ -39,7 +66,7 @@ ObjectFactory::create(const std::string& name, const ReaderMapping& reader) cons
   }
   else
   {
-    return it->second(reader);
+    return it->func(reader);
   }
 }
 
@@ -19,9 +19,9 @@
 #define HEADER_SUPERTUX_SUPERTUX_OBJECT_FACTORY_HPP
 
 #include <assert.h>
-#include <map>
 #include <memory>
-#include <functional>
+#include <string>
+#include <vector>
 
 #include "supertux/direction.hpp"
 
@@ -32,9 +32,18 @@ class GameObject;
 class ObjectFactory
 {
 private:
-  typedef std::function<std::unique_ptr<GameObject> (const ReaderMapping&)> FactoryFunction;
-  typedef std::map<std::string, FactoryFunction> Factories;
-  Factories factories;
+  typedef std::unique_ptr<GameObject> (*FactoryFunction)(const ReaderMapping&);
+
+  struct Factory
+  {
+    std::string name;
+    FactoryFunction func;
+  };
+
+  /** Flat table sorted by name, looked up with a binary search */
+  std::vector<Factory> factories;
+
+  std::vector<Factory>::const_iterator find(const std::string& name) const;
 
 public:
   /** Will throw in case of creation failure, will never return nullptr */
@@ -43,16 +52,12 @@ public:
 protected:
   ObjectFactory();
 
-  void add_factory(const char* name, const FactoryFunction& func)
-  {
-    assert(factories.find(name) == factories.end());
-    factories[name] = func;
-  }
+  void add_factory(const char* name, FactoryFunction func);
 
   template<class C>
   void add_factory(const char* name)
   {
-    add_factory(name, [](const ReaderMapping& reader) {
+    add_factory(name, [](const ReaderMapping& reader) -> std::unique_ptr<GameObject> {
         return std::make_unique<C>(reader);
       });
   }
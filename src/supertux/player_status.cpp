@@ -43,7 +43,7 @@ PlayerStatus::PlayerStatus() :
 
   // FIXME: Move sound handling into PlayerStatusHUD
   if (SoundManager::current()) {
-    SoundManager::current()->preload("sounds/coin.wav");
+    SoundManager::current()->pin("sounds/coin.wav");
     SoundManager::current()->preload("sounds/lifeup.wav");
   }
 }
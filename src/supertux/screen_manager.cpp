@@ -21,7 +21,9 @@
 #include "editor/editor.hpp"
 #include "gui/menu_manager.hpp"
 #include "object/player.hpp"
+#include "sprite/sprite_manager.hpp"
 #include "squirrel/squirrel_virtual_machine.hpp"
+#include "supertux/benchmark.hpp"
 #include "supertux/console.hpp"
 #include "supertux/constants.hpp"
 #include "supertux/controller_hud.hpp"
@@ -34,13 +36,23 @@
 #include "supertux/resources.hpp"
 #include "supertux/screen_fade.hpp"
 #include "supertux/sector.hpp"
+#include "supertux/tile_manager.hpp"
 #include "util/log.hpp"
+#include "util/profiler.hpp"
 #include "video/compositor.hpp"
 #include "video/drawing_context.hpp"
+#include "video/texture_manager.hpp"
 
 #include <stdio.h>
 #include <chrono>
 
+namespace {
+
+/** Seconds per frame that may be spent on turning preloaded images
+    into textures */
+const float PRELOAD_BUDGET = 0.002f;
+
+} // namespace
 
 ScreenManager::ScreenManager(VideoSystem& video_system, InputManager& input_manager) :
   m_video_system(video_system),
@@ -49,6 +61,8 @@ ScreenManager::ScreenManager(VideoSystem& video_system, InputManager& input_mana
   m_menu_manager(new MenuManager),
   m_controller_hud(new ControllerHUD),
   m_speed(1.0),
+  m_last_draw_count(0),
+  m_last_request_count(0),
   m_actions(),
   m_screen_fade(),
   m_screen_stack()
@@ -218,6 +232,15 @@ ScreenManager::draw_fps(DrawingContext& context, FPS_Stats& fps_statistics)
   pos.x -= w2;
   context.color().draw_text(Resources::small_font, str1,
     pos, ALIGN_RIGHT, LAYER_HUD);
+
+  // draw calls of the last frame, after merging compatible requests
+  pos.x = static_cast<float>(context.get_width()) - BORDER_X;
+  pos.y += 15;
+  snprintf(str1, str_length, "Draws %d / %d requests",
+    static_cast<int>(m_last_draw_count),
+    static_cast<int>(m_last_request_count));
+  context.color().draw_text(Resources::small_font, str1,
+    pos, ALIGN_RIGHT, LAYER_HUD);
 }
 
 void
@@ -236,42 +259,105 @@ ScreenManager::draw_player_pos(DrawingContext& context)
   }
 }
 
+void
+ScreenManager::draw_profiler(DrawingContext& context)
+{
+  const Profiler& profiler = Profiler::instance();
+  const auto stats = profiler.get_zone_stats();
+  const float line_height = Resources::small_font->get_height() + 2.0f;
+
+  // zone name, then the average and worst time per frame and the
+  // average number of calls per frame
+  const float avg_x = BORDER_X + 280.0f;
+  const float max_x = avg_x + 70.0f;
+  const float calls_x = max_x + 60.0f;
+
+  context.color().draw_filled_rect(Rectf(0.0f, BORDER_Y + 50.0f, calls_x + BORDER_X,
+                                         BORDER_Y + 50.0f + line_height * static_cast<float>(stats.size() + 2)),
+                                   Color(0.0f, 0.0f, 0.0f, 0.6f), LAYER_HUD);
+
+  char text[64];
+  Vector pos(BORDER_X, BORDER_Y + 50.0f);
+  snprintf(text, sizeof(text), "Frame %.2f ms (%d frames)",
+           static_cast<double>(profiler.get_average_frame_time()), profiler.get_frame_count());
+  context.color().draw_text(Resources::small_font, text, pos, ALIGN_LEFT, LAYER_HUD);
+
+  pos.y += line_height;
+  context.color().draw_text(Resources::small_font, "avg ms", Vector(avg_x, pos.y), ALIGN_RIGHT, LAYER_HUD);
+  context.color().draw_text(Resources::small_font, "max ms", Vector(max_x, pos.y), ALIGN_RIGHT, LAYER_HUD);
+  context.color().draw_text(Resources::small_font, "calls", Vector(calls_x, pos.y), ALIGN_RIGHT, LAYER_HUD);
+
+  for (const auto& zone : stats)
+  {
+    pos.y += line_height;
+    context.color().draw_text(Resources::small_font, zone.name,
+                              Vector(BORDER_X + 12.0f * static_cast<float>(zone.depth), pos.y),
+                              ALIGN_LEFT, LAYER_HUD);
+
+    snprintf(text, sizeof(text), "%.2f", static_cast<double>(zone.avg_msec));
+    context.color().draw_text(Resources::small_font, text, Vector(avg_x, pos.y), ALIGN_RIGHT, LAYER_HUD);
+    snprintf(text, sizeof(text), "%.2f", static_cast<double>(zone.max_msec));
+    context.color().draw_text(Resources::small_font, text, Vector(max_x, pos.y), ALIGN_RIGHT, LAYER_HUD);
+    snprintf(text, sizeof(text), "%.1f", static_cast<double>(zone.calls));
+    context.color().draw_text(Resources::small_font, text, Vector(calls_x, pos.y), ALIGN_RIGHT, LAYER_HUD);
+  }
+}
+
 void
 ScreenManager::draw(Compositor& compositor, FPS_Stats& fps_statistics)
 {
+  PROFILE_ZONE("ScreenManager::draw");
+
   assert(!m_screen_stack.empty());
 
-  // draw the actual screen
-  m_screen_stack.back()->draw(compositor);
+  {
+    PROFILE_ZONE("ScreenManager::draw_requests");
+
+    if (auto tile_manager = TileManager::current()) {
+      tile_manager->update_animations();
+    }
 
-  // draw effects and hud
-  auto& context = compositor.make_context(true);
-  m_menu_manager->draw(context);
+    // draw the actual screen
+    m_screen_stack.back()->draw(compositor);
 
-  if (m_screen_fade) {
-    m_screen_fade->draw(context);
-  }
+    // draw effects and hud
+    auto& context = compositor.make_context(true);
+    m_menu_manager->draw(context);
 
-  Console::current()->draw(context);
+    if (m_screen_fade) {
+      m_screen_fade->draw(context);
+    }
 
-  if (g_config->show_fps)
-    draw_fps(context, fps_statistics);
+    Console::current()->draw(context);
 
-  if (g_config->show_controller) {
-    m_controller_hud->draw(context);
-  }
+    if (g_config->show_fps)
+      draw_fps(context, fps_statistics);
+
+    if (g_config->show_controller) {
+      m_controller_hud->draw(context);
+    }
 
-  if (g_config->show_player_pos) {
-    draw_player_pos(context);
+    if (g_config->show_player_pos) {
+      draw_player_pos(context);
+    }
+
+    if (g_debug.show_profiler) {
+      draw_profiler(context);
+    }
   }
 
   // render everything
   compositor.render();
+
+  m_last_draw_count = compositor.get_draw_count();
+  m_last_request_count = compositor.get_request_count();
 }
 
 void
 ScreenManager::update_gamelogic(float dt_sec)
 {
+  PROFILE_ZONE("ScreenManager::update_gamelogic");
+
   const Controller& controller = m_input_manager.get_controller();
 
   SquirrelVirtualMachine::current()->update(g_game_time);
@@ -443,6 +529,12 @@ ScreenManager::handle_screen_switch()
 void
 ScreenManager::run()
 {
+  if (auto benchmark = Benchmark::current())
+  {
+    run_benchmark(*benchmark);
+    return;
+  }
+
   Uint32 last_ticks = 0;
   Uint32 elapsed_ticks = 0;
   const Uint32 ms_per_step = static_cast<Uint32>(1000.0f / LOGICAL_FPS);
@@ -469,6 +561,8 @@ ScreenManager::run()
       continue;
     }
 
+    PROFILE_FRAME();
+
     g_real_time = static_cast<float>(ticks) / 1000.0f;
 
     float speed_multiplier = 1.0f / g_debug.get_game_speed_multiplier();
@@ -515,6 +609,51 @@ ScreenManager::run()
 
     SoundManager::current()->update();
 
+    SpriteManager::current()->process_preloads();
+    if (auto texture_manager = TextureManager::current()) {
+      texture_manager->process_preloads(PRELOAD_BUDGET);
+    }
+
+    handle_screen_switch();
+  }
+}
+
+void
+ScreenManager::run_benchmark(Benchmark& benchmark)
+{
+  // Same fixed step as run(), but without waiting for real time to
+  // pass, every step is followed by exactly one frame
+  const Uint32 ms_per_step = static_cast<Uint32>(1000.0f / LOGICAL_FPS);
+  const float seconds_per_step = static_cast<float>(ms_per_step) / 1000.0f;
+  FPS_Stats fps_statistics;
+  bool finished = false;
+
+  handle_screen_switch();
+  while (!m_screen_stack.empty()) {
+    {
+      PROFILE_FRAME();
+
+      float dtime = seconds_per_step * m_speed;
+      g_game_time += dtime;
+      g_real_time += seconds_per_step;
+      process_events();
+      update_gamelogic(dtime);
+
+      if (!m_screen_stack.empty()) {
+        Compositor compositor(m_video_system);
+        draw(compositor, fps_statistics);
+      }
+    }
+    if (const auto* frame = Profiler::instance().get_last_frame()) {
+      benchmark.add_frame(*frame);
+    }
+
+    auto session = GameSession::current();
+    if (!finished && session && session->is_demo_finished()) {
+      finished = true;
+      quit();
+    }
+
     handle_screen_switch();
   }
 }
@@ -24,6 +24,7 @@
 #include "supertux/screen.hpp"
 #include "util/currenton.hpp"
 
+class Benchmark;
 class Compositor;
 class ControllerHUD;
 class DrawingContext;
@@ -57,10 +58,12 @@ private:
   struct FPS_Stats;
   void draw_fps(DrawingContext& context, FPS_Stats& fps_statistics);
   void draw_player_pos(DrawingContext& context);
+  void draw_profiler(DrawingContext& context);
   void draw(Compositor& compositor, FPS_Stats& fps_statistics);
   void update_gamelogic(float dt_sec);
   void process_events();
   void handle_screen_switch();
+  void run_benchmark(Benchmark& benchmark);
 
 private:
   VideoSystem& m_video_system;
@@ -70,6 +73,12 @@ private:
   std::unique_ptr<ControllerHUD> m_controller_hud;
 
   float m_speed;
+
+  /** draw calls and requests of the previous frame, the counts of
+      the current one are only known after it is rendered */
+  size_t m_last_draw_count;
+  size_t m_last_request_count;
+
   struct Action
   {
     enum Type { PUSH_ACTION, POP_ACTION, QUIT_ACTION };
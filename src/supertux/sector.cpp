@@ -44,6 +44,7 @@
 #include "object/vertical_stripes.hpp"
 #include "physfs/ifile_stream.hpp"
 #include "scripting/sector.hpp"
+#include "sprite/sprite_manager.hpp"
 #include "squirrel/squirrel_environment.hpp"
 #include "supertux/constants.hpp"
 #include "supertux/debug.hpp"
@@ -52,9 +53,14 @@
 #include "supertux/level.hpp"
 #include "supertux/player_status_hud.hpp"
 #include "supertux/savegame.hpp"
+#include "supertux/static_light_layer.hpp"
 #include "supertux/tile.hpp"
 #include "util/file_system.hpp"
+#include "util/parallel_for.hpp"
+#include "util/profiler.hpp"
+#include "util/worker_pool.hpp"
 #include "util/writer.hpp"
+#include "video/texture_manager.hpp"
 #include "video/video_system.hpp"
 #include "video/viewport.hpp"
 
@@ -64,6 +70,14 @@ namespace {
 
 PlayerStatus dummy_player_status;
 
+/** Threads for GameObjectManager::update_parallel(), only started
+    once parallel updates are turned on */
+ParallelFor& get_update_threads()
+{
+  static ParallelFor parallel_for(WorkerPool::get_default_thread_count());
+  return parallel_for;
+}
+
 } // namespace
 
 Sector::Sector(Level& parent) :
@@ -74,7 +88,10 @@ Sector::Sector(Level& parent) :
   m_foremost_layer(),
   m_squirrel_environment(new SquirrelEnvironment(SquirrelVirtualMachine::current()->get_vm(), "sector")),
   m_collision_system(new CollisionSystem(*this)),
-  m_gravity(10.0)
+  m_static_lights(new StaticLightLayer),
+  m_gravity(10.0),
+  m_prefetch_files(),
+  m_prefetched(false)
 {
   Savegame* savegame = (Editor::current() && Editor::is_active()) ?
     Editor::current()->m_savegame.get() :
@@ -205,6 +222,9 @@ Sector::activate(const Vector& player_pos)
     for (auto& object : get_objects()) {
       m_squirrel_environment->try_expose(*object);
     }
+
+    // usually done already by a door or the level intro
+    prefetch();
   }
 
   // The Sector object is called 'settings' as it is accessed as 'sector.settings'
@@ -261,6 +281,26 @@ Sector::activate(const Vector& player_pos)
   }
 }
 
+void
+Sector::prefetch()
+{
+  if (m_prefetched)
+    return;
+  m_prefetched = true;
+
+  if (auto sprite_manager = SpriteManager::current()) {
+    sprite_manager->preload(std::vector<std::string>(m_prefetch_files.sprites.begin(),
+                                                     m_prefetch_files.sprites.end()));
+  }
+  if (auto texture_manager = TextureManager::current()) {
+    texture_manager->preload(std::vector<std::string>(m_prefetch_files.images.begin(),
+                                                      m_prefetch_files.images.end()));
+  }
+  for (const auto& sound : m_prefetch_files.sounds) {
+    SoundManager::current()->preload(sound);
+  }
+}
+
 void
 Sector::deactivate()
 {
@@ -325,9 +365,23 @@ Sector::update(float dt_sec)
 
   BIND_SECTOR(*this);
 
+  PROFILE_ZONE("Sector::update");
+
   m_squirrel_environment->update(dt_sec);
 
-  GameObjectManager::update(dt_sec);
+  {
+    PROFILE_ZONE("GameObjectManager::update");
+    const bool sleeping = g_debug.use_object_sleeping && !Editor::is_active();
+    if (g_debug.use_parallel_update && !Editor::is_active()) {
+      const Rectf active_region = get_active_region();
+      GameObjectManager::update_parallel(dt_sec, sleeping ? &active_region : nullptr,
+                                         get_update_threads());
+    } else if (sleeping) {
+      GameObjectManager::update(dt_sec, get_active_region());
+    } else {
+      GameObjectManager::update(dt_sec);
+    }
+  }
 
   /* Handle all possible collisions. */
   m_collision_system->update();
@@ -389,6 +443,7 @@ Sector::draw(DrawingContext& context)
   context.set_translation(camera.get_translation());
 
   GameObjectManager::draw(context);
+  m_static_lights->draw(context);
 
   if (g_debug.show_collision_rects) {
     m_collision_system->draw(context);
@@ -425,17 +480,40 @@ Sector::free_line_of_sight(const Vector& line_start, const Vector& line_end, con
                                                 ignore_object ? ignore_object->get_collision_object() : nullptr);
 }
 
+size_t
+Sector::free_lines_of_sight(const std::vector<std::pair<Vector, Vector> >& lines, std::vector<bool>& results,
+                            const MovingObject* ignore_object, bool stop_at_first_free) const
+{
+  return m_collision_system->free_lines_of_sight(lines,
+                                                 ignore_object ? ignore_object->get_collision_object() : nullptr,
+                                                 results, stop_at_first_free);
+}
+
+size_t
+Sector::collide_particles(const std::vector<float>& x, const std::vector<float>& y,
+                          const std::vector<float>& speed, const Vector& direction,
+                          std::vector<ParticleHit>& hits) const
+{
+  return m_collision_system->collide_particles(x, y, speed, direction, hits);
+}
+
 bool
 Sector::can_see_player(const Vector& eye) const
 {
+  std::vector<std::pair<Vector, Vector> > lines;
+  std::vector<bool> results;
   for (auto player_ptr : get_objects_by_type_index(typeid(Player))) {
     Player& player = *static_cast<Player*>(player_ptr);
+    const Rectf& bbox = player.get_bbox();
     // test for free line of sight to any of all four corners and the middle of the player's bounding box
-    if (free_line_of_sight(eye, player.get_bbox().p1(), &player)) return true;
-    if (free_line_of_sight(eye, Vector(player.get_bbox().get_right(), player.get_bbox().get_top()), &player)) return true;
-    if (free_line_of_sight(eye, player.get_bbox().p2(), &player)) return true;
-    if (free_line_of_sight(eye, Vector(player.get_bbox().get_left(), player.get_bbox().get_bottom()), &player)) return true;
-    if (free_line_of_sight(eye, player.get_bbox().get_middle(), &player)) return true;
+    lines = {
+      std::make_pair(eye, bbox.p1()),
+      std::make_pair(eye, Vector(bbox.get_right(), bbox.get_top())),
+      std::make_pair(eye, bbox.p2()),
+      std::make_pair(eye, Vector(bbox.get_left(), bbox.get_bottom())),
+      std::make_pair(eye, bbox.get_middle())
+    };
+    if (free_lines_of_sight(lines, results, &player, true) > 0) return true;
   }
   return false;
 }
@@ -17,6 +17,8 @@
 #ifndef HEADER_SUPERTUX_SUPERTUX_SECTOR_HPP
 #define HEADER_SUPERTUX_SUPERTUX_SECTOR_HPP
 
+#include <set>
+#include <string>
 #include <vector>
 #include <stdint.h>
 
@@ -36,10 +38,12 @@ class DisplayEffect;
 class DrawingContext;
 class Level;
 class MovingObject;
+struct ParticleHit;
 class Player;
 class ReaderMapping;
 class Rectf;
 class Size;
+class StaticLightLayer;
 class TileMap;
 class Vector;
 class Writer;
@@ -60,6 +64,15 @@ public:
   static Sector& get() { assert(s_current != nullptr); return *s_current; }
   static Sector* current() { return s_current; }
 
+public:
+  /** Files named in the sector's part of the level, see prefetch() */
+  struct PrefetchFiles
+  {
+    std::set<std::string> sprites;
+    std::set<std::string> images;
+    std::set<std::string> sounds;
+  };
+
 public:
   Sector(Level& parent);
   ~Sector();
@@ -75,6 +88,15 @@ public:
   void activate(const Vector& player_pos);
   void deactivate();
 
+  void set_prefetch_files(PrefetchFiles files) { m_prefetch_files = std::move(files); }
+
+  /** Starts loading the sprites, images and sounds named in the
+      sector on the worker threads, so that scripts and objects that
+      use them later in the sector don't load them on the main thread.
+      Called ahead of the transition into the sector, only the first
+      call does anything. */
+  void prefetch();
+
   void update(float dt_sec);
 
   void draw(DrawingContext& context);
@@ -111,8 +133,17 @@ public:
   bool is_free_of_movingstatics(const Rectf& rect, const MovingObject* ignore_object = nullptr) const;
 
   bool free_line_of_sight(const Vector& line_start, const Vector& line_end, const MovingObject* ignore_object = nullptr) const;
+
+  /** Batched free_line_of_sight(), see CollisionSystem::free_lines_of_sight() */
+  size_t free_lines_of_sight(const std::vector<std::pair<Vector, Vector> >& lines, std::vector<bool>& results,
+                             const MovingObject* ignore_object = nullptr, bool stop_at_first_free = false) const;
   bool can_see_player(const Vector& eye) const;
 
+  /** Batched particle vs. tile collision, see CollisionSystem::collide_particles() */
+  size_t collide_particles(const std::vector<float>& x, const std::vector<float>& y,
+                           const std::vector<float>& speed, const Vector& direction,
+                           std::vector<ParticleHit>& hits) const;
+
   Player* get_nearest_player (const Vector& pos) const;
   Player* get_nearest_player (const Rectf& pos) const {
     return (get_nearest_player (get_anchor_pos (pos, ANCHOR_MIDDLE)));
@@ -140,6 +171,7 @@ public:
   void set_init_script(const std::string& init_script) {
     m_init_script = init_script;
   }
+  const std::string& get_init_script() const { return m_init_script; }
 
   void run_script(const std::string& script, const std::string& sourcename);
 
@@ -147,6 +179,9 @@ public:
   Player& get_player() const;
   DisplayEffect& get_effect() const;
 
+  /** Lights that don't move, drawn from retained light map tiles */
+  StaticLightLayer& get_static_lights() const { return *m_static_lights; }
+
 private:
   uint32_t collision_tile_attributes(const Rectf& dest, const Vector& mov) const;
 
@@ -173,9 +208,13 @@ private:
 
   std::unique_ptr<SquirrelEnvironment> m_squirrel_environment;
   std::unique_ptr<CollisionSystem> m_collision_system;
+  std::unique_ptr<StaticLightLayer> m_static_lights;
 
   float m_gravity;
 
+  PrefetchFiles m_prefetch_files;
+  bool m_prefetched;
+
 private:
   Sector(const Sector&) = delete;
   Sector& operator=(const Sector&) = delete;
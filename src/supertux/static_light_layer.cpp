@@ -0,0 +1,320 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "supertux/static_light_layer.hpp"
+
+#include <math.h>
+
+#include "math/rectf.hpp"
+#include "supertux/debug.hpp"
+#include "supertux/sector.hpp"
+#include "video/compositor.hpp"
+#include "video/drawing_context.hpp"
+#include "video/drawing_request.hpp"
+#include "video/paint_style.hpp"
+#include "video/painter.hpp"
+#include "video/renderer.hpp"
+#include "video/surface.hpp"
+#include "video/video_system.hpp"
+
+namespace {
+
+/** Same downscale as the lightmap the tiles are composited into */
+const int LIGHTMAP_DOWNSCALE = 5;
+
+/** Tiles this far outside of the view are kept and rendered ahead of
+    time, so that a camera moving back and forth over a tile edge
+    doesn't render them again and tiles coming into view are ready */
+const int TILE_MARGIN = 1;
+
+} // namespace
+
+const int StaticLightLayer::TILE_SIZE = 640;
+
+StaticLightLayer::StaticLightLayer() :
+  m_lights(),
+  m_free(),
+  m_grid(static_cast<float>(TILE_SIZE)),
+  m_tiles(),
+  m_spare_renderers(),
+  m_pending(),
+  m_query()
+{
+}
+
+StaticLightLayer::~StaticLightLayer()
+{
+}
+
+int
+StaticLightLayer::add(const SurfacePtr& surface, const Vector& pos, const Color& color)
+{
+  int handle;
+  if (m_free.empty()) {
+    handle = static_cast<int>(m_lights.size());
+    m_lights.push_back(Light{surface, pos, color});
+  } else {
+    handle = m_free.back();
+    m_free.pop_back();
+    m_lights[handle] = Light{surface, pos, color};
+  }
+
+  const Rectf rect = get_rect(m_lights[handle]);
+  m_grid.add(handle, rect);
+  mark_dirty(rect);
+  return handle;
+}
+
+void
+StaticLightLayer::update(int handle, const SurfacePtr& surface, const Vector& pos, const Color& color)
+{
+  Light& light = m_lights[handle];
+  mark_dirty(get_rect(light));
+
+  light = Light{surface, pos, color};
+
+  const Rectf rect = get_rect(light);
+  m_grid.update(handle, rect);
+  mark_dirty(rect);
+}
+
+void
+StaticLightLayer::remove(int handle)
+{
+  Light& light = m_lights[handle];
+  mark_dirty(get_rect(light));
+  m_grid.remove(handle);
+
+  light.surface.reset();
+  m_free.push_back(handle);
+}
+
+void
+StaticLightLayer::draw(DrawingContext& context)
+{
+  // nothing is composited without a lightmap, the tiles are rendered
+  // once it is used again
+  if (!g_debug.use_static_lights || !context.use_lightmap() || !Compositor::s_render_lighting)
+    return;
+
+  const Rectf view = context.get_cliprect();
+  const int left = static_cast<int>(floorf(view.get_left() / static_cast<float>(TILE_SIZE)));
+  const int top = static_cast<int>(floorf(view.get_top() / static_cast<float>(TILE_SIZE)));
+  const int right = static_cast<int>(floorf(view.get_right() / static_cast<float>(TILE_SIZE)));
+  const int bottom = static_cast<int>(floorf(view.get_bottom() / static_cast<float>(TILE_SIZE)));
+
+  // Recycle the renderers of tiles that went out of view
+  for (auto it = m_tiles.begin(); it != m_tiles.end();) {
+    if (it->first.first < left - TILE_MARGIN || it->first.first > right + TILE_MARGIN ||
+        it->first.second < top - TILE_MARGIN || it->first.second > bottom + TILE_MARGIN) {
+      if (it->second.renderer) {
+        m_spare_renderers.push_back(std::move(it->second.renderer));
+      }
+      it = m_tiles.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  // Rendering the tiles binds other render targets, so it is left to
+  // Compositor::render(), tiles that get their first texture there are
+  // drawn from the next frame on
+  m_pending.clear();
+  for (int y = top - TILE_MARGIN; y <= bottom + TILE_MARGIN; ++y) {
+    for (int x = left - TILE_MARGIN; x <= right + TILE_MARGIN; ++x) {
+      const TileKey key(x, y);
+      auto it = m_tiles.find(key);
+      if (it == m_tiles.end()) {
+        it = m_tiles.insert(std::make_pair(key, Tile{nullptr, SurfacePtr(), true})).first;
+      }
+
+      if (it->second.dirty) {
+        m_pending.push_back(key);
+      }
+    }
+  }
+
+  if (!m_pending.empty()) {
+    context.add_prerender_job([this]{ render_pending(); });
+  }
+
+  for (int y = top; y <= bottom; ++y) {
+    for (int x = left; x <= right; ++x) {
+      const Tile& tile = m_tiles[TileKey(x, y)];
+      if (tile.surface) {
+        const Rectf rect(static_cast<float>(x * TILE_SIZE), static_cast<float>(y * TILE_SIZE),
+                         static_cast<float>((x + 1) * TILE_SIZE), static_cast<float>((y + 1) * TILE_SIZE));
+        context.light().draw_surface_scaled(tile.surface, rect, 0,
+                                            PaintStyle().set_blend(Blend::ADD));
+      }
+    }
+  }
+}
+
+Rectf
+StaticLightLayer::get_rect(const Light& light)
+{
+  return Rectf(light.pos, Sizef(static_cast<float>(light.surface->get_width()),
+                                static_cast<float>(light.surface->get_height())));
+}
+
+void
+StaticLightLayer::mark_dirty(const Rectf& rect)
+{
+  const int left = static_cast<int>(floorf(rect.get_left() / static_cast<float>(TILE_SIZE)));
+  const int top = static_cast<int>(floorf(rect.get_top() / static_cast<float>(TILE_SIZE)));
+  const int right = static_cast<int>(floorf(rect.get_right() / static_cast<float>(TILE_SIZE)));
+  const int bottom = static_cast<int>(floorf(rect.get_bottom() / static_cast<float>(TILE_SIZE)));
+
+  for (int y = top; y <= bottom; ++y) {
+    for (int x = left; x <= right; ++x) {
+      const auto it = m_tiles.find(TileKey(x, y));
+      if (it != m_tiles.end()) {
+        it->second.dirty = true;
+      }
+    }
+  }
+}
+
+void
+StaticLightLayer::render_pending()
+{
+  for (const auto& key : m_pending) {
+    const auto it = m_tiles.find(key);
+    if (it != m_tiles.end() && it->second.dirty) {
+      render(key, it->second);
+    }
+  }
+  m_pending.clear();
+}
+
+void
+StaticLightLayer::render(const TileKey& key, Tile& tile)
+{
+  tile.dirty = false;
+
+  const Vector origin(static_cast<float>(key.first * TILE_SIZE),
+                      static_cast<float>(key.second * TILE_SIZE));
+
+  // Shrink the query by a pixel so that lights in the neighbouring
+  // tiles don't count as touching this one
+  m_query.clear();
+  m_grid.query(Rectf(origin, Sizef(static_cast<float>(TILE_SIZE - 1),
+                                   static_cast<float>(TILE_SIZE - 1))), m_query);
+
+  if (m_query.empty()) {
+    if (tile.renderer) {
+      m_spare_renderers.push_back(std::move(tile.renderer));
+    }
+    tile.surface.reset();
+    return;
+  }
+
+  if (!tile.renderer) {
+    if (m_spare_renderers.empty()) {
+      tile.renderer = VideoSystem::current()->new_texture_renderer(Size(TILE_SIZE, TILE_SIZE),
+                                                                   LIGHTMAP_DOWNSCALE);
+    } else {
+      tile.renderer = std::move(m_spare_renderers.back());
+      m_spare_renderers.pop_back();
+    }
+  }
+
+  Renderer& renderer = *tile.renderer;
+  renderer.start_draw();
+  Painter& painter = renderer.get_painter();
+  for (const int handle : m_query) {
+    const Light& light = m_lights[handle];
+
+    TextureRequest request;
+    request.layer = 0;
+    request.flip = light.surface->get_flip();
+    request.alpha = 1.0f;
+    request.blend = Blend::ADD;
+    request.srcrects.emplace_back(Rectf(light.surface->get_region()));
+    request.dstrects.emplace_back(Rectf(light.pos - origin,
+                                        Sizef(static_cast<float>(light.surface->get_width()),
+                                              static_cast<float>(light.surface->get_height()))));
+    request.angles.emplace_back(0.0f);
+    request.texture = light.surface->get_texture().get();
+    request.displacement_texture = nullptr;
+    request.color = light.color;
+
+    painter.draw_texture(request);
+  }
+  renderer.end_draw();
+
+  const TexturePtr texture = renderer.get_texture();
+  if (texture) {
+    tile.surface = Surface::from_texture(texture);
+  } else {
+    tile.surface.reset();
+  }
+}
+
+StaticLight::StaticLight() :
+  m_layer(nullptr),
+  m_handle(-1),
+  m_surface(),
+  m_pos(),
+  m_color()
+{
+}
+
+StaticLight::~StaticLight()
+{
+  reset();
+}
+
+void
+StaticLight::draw(DrawingContext& context, const SurfacePtr& surface, const Vector& pos, const Color& color)
+{
+  if (!surface)
+    return;
+
+  Sector* sector = Sector::current();
+  if (!g_debug.use_static_lights || !sector) {
+    reset();
+    context.light().draw_surface(surface, pos, 0.0f, color, Blend::ADD, 0);
+    return;
+  }
+
+  StaticLightLayer& layer = sector->get_static_lights();
+  if (m_layer != &layer) {
+    reset();
+    m_layer = &layer;
+    m_handle = layer.add(surface, pos, color);
+  } else if (surface != m_surface || pos != m_pos || color != m_color) {
+    layer.update(m_handle, surface, pos, color);
+  }
+
+  m_surface = surface;
+  m_pos = pos;
+  m_color = color;
+}
+
+void
+StaticLight::reset()
+{
+  if (m_layer) {
+    m_layer->remove(m_handle);
+    m_layer = nullptr;
+    m_handle = -1;
+  }
+}
+
+/* EOF */
@@ -0,0 +1,139 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_SUPERTUX_STATIC_LIGHT_LAYER_HPP
+#define HEADER_SUPERTUX_SUPERTUX_STATIC_LIGHT_LAYER_HPP
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "collision/spatial_hash.hpp"
+#include "math/vector.hpp"
+#include "video/color.hpp"
+#include "video/surface_ptr.hpp"
+
+class DrawingContext;
+class Renderer;
+class StaticLightLayer;
+
+/** Retained light map for lights that don't move. The lights are
+    accumulated once into world-space tiles around the camera, a tile
+    is only rendered again when a light touching it is added, changed
+    or removed. */
+class StaticLightLayer final
+{
+public:
+  /** Edge length of a tile in world pixels */
+  static const int TILE_SIZE;
+
+public:
+  StaticLightLayer();
+  ~StaticLightLayer();
+
+  /** Adds surface, drawn at pos with additive blending, and returns
+      a handle for update() and remove() */
+  int add(const SurfacePtr& surface, const Vector& pos, const Color& color);
+  void update(int handle, const SurfacePtr& surface, const Vector& pos, const Color& color);
+  void remove(int handle);
+
+  /** Draws all tiles in view into the light canvas of context and
+      queues the tiles that changed to be rendered before the
+      lightmap, does nothing when context doesn't use a lightmap */
+  void draw(DrawingContext& context);
+
+  int get_light_count() const { return static_cast<int>(m_lights.size() - m_free.size()); }
+
+private:
+  struct Light
+  {
+    SurfacePtr surface;
+    Vector pos;
+    Color color;
+  };
+
+  struct Tile
+  {
+    std::unique_ptr<Renderer> renderer;
+    SurfacePtr surface;
+    bool dirty;
+  };
+
+  typedef std::pair<int, int> TileKey;
+
+private:
+  static Rectf get_rect(const Light& light);
+  void mark_dirty(const Rectf& rect);
+
+  /** Renders the tiles queued by draw(), run by Compositor::render() */
+  void render_pending();
+  void render(const TileKey& key, Tile& tile);
+
+private:
+  /** Lights indexed by handle, removed lights have no surface */
+  std::vector<Light> m_lights;
+  std::vector<int> m_free;
+  SpatialHash<int> m_grid;
+
+  /** Tiles around the camera, tiles that go more than a tile out of
+      view give their renderer back to m_spare_renderers */
+  std::map<TileKey, Tile> m_tiles;
+  std::vector<std::unique_ptr<Renderer> > m_spare_renderers;
+
+  /** Dirty tiles in and around the view of the last draw() */
+  std::vector<TileKey> m_pending;
+
+  /** Scratch buffer for the lights of a tile */
+  std::vector<int> m_query;
+
+private:
+  StaticLightLayer(const StaticLightLayer&) = delete;
+  StaticLightLayer& operator=(const StaticLightLayer&) = delete;
+};
+
+/** A light owned by a game object that goes on the StaticLightLayer
+    of the current sector. Falls back to drawing the light every frame
+    when there is no sector or the layer is disabled. */
+class StaticLight final
+{
+public:
+  StaticLight();
+  ~StaticLight();
+
+  /** Draws surface at pos, the layer is only touched when the light
+      changed since the last call */
+  void draw(DrawingContext& context, const SurfacePtr& surface, const Vector& pos, const Color& color);
+
+  /** Takes the light off the layer, e.g. before drawing it dynamically */
+  void reset();
+
+private:
+  StaticLightLayer* m_layer;
+  int m_handle;
+  SurfacePtr m_surface;
+  Vector m_pos;
+  Color m_color;
+
+private:
+  StaticLight(const StaticLight&) = delete;
+  StaticLight& operator=(const StaticLight&) = delete;
+};
+
+#endif
+
+/* EOF */
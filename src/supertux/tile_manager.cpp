@@ -42,4 +42,12 @@ TileManager::get_tileset(const std::string &filename)
   }
 }
 
+void
+TileManager::update_animations()
+{
+  for (auto& tileset : m_tilesets) {
+    tileset.second->update_animations();
+  }
+}
+
 /* EOF */
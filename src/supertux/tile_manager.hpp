@@ -34,6 +34,10 @@ public:
   TileManager();
 
   TileSet* get_tileset(const std::string &filename);
+
+  /** Advances the animated tiles of all loaded tilesets to the
+      current frame */
+  void update_animations();
 };
 
 #endif
@@ -16,6 +16,8 @@
 
 #include "supertux/tile_set.hpp"
 
+#include <algorithm>
+
 #include "editor/editor.hpp"
 #include "supertux/resources.hpp"
 #include "supertux/tile.hpp"
@@ -47,7 +49,10 @@ TileSet::from_file(const std::string& filename)
 
 TileSet::TileSet() :
   m_tiles(1),
-  m_tilegroups()
+  m_tilegroups(),
+  m_surfaces(1),
+  m_editor_surfaces(1),
+  m_animated_tiles()
 {
   m_tiles[0] = std::make_unique<Tile>();
 }
@@ -57,12 +62,22 @@ TileSet::add_tile(int id, std::unique_ptr<Tile> tile)
 {
   if (id >= static_cast<int>(m_tiles.size())) {
     m_tiles.resize(id + 1);
+    m_surfaces.resize(id + 1);
+    m_editor_surfaces.resize(id + 1);
   }
 
   if (m_tiles[id]) {
     log_warning << "Tile with ID " << id << " redefined" << std::endl;
   } else {
     m_tiles[id] = std::move(tile);
+    m_surfaces[id] = m_tiles[id]->get_current_surface();
+    m_editor_surfaces[id] = m_tiles[id]->get_current_editor_surface();
+
+    if (m_tiles[id]->is_animated()) {
+      const uint32_t tile_id = static_cast<uint32_t>(id);
+      m_animated_tiles.insert(std::lower_bound(m_animated_tiles.begin(), m_animated_tiles.end(), tile_id),
+                              tile_id);
+    }
   }
 }
 
@@ -84,6 +99,27 @@ TileSet::get(const uint32_t id) const
   }
 }
 
+void
+TileSet::update_animations()
+{
+  for (const uint32_t id : m_animated_tiles) {
+    const Tile& tile = *m_tiles[id];
+    m_surfaces[id] = tile.get_current_surface();
+    m_editor_surfaces[id] = tile.get_current_editor_surface();
+  }
+}
+
+const SurfacePtr&
+TileSet::get_current_surface(uint32_t id, bool editor) const
+{
+  const auto& surfaces = editor ? m_editor_surfaces : m_surfaces;
+  if (id >= surfaces.size()) {
+    return surfaces[0];
+  } else {
+    return surfaces[id];
+  }
+}
+
 void
 TileSet::add_unassigned_tilegroup()
 {
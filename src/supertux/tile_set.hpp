@@ -20,6 +20,7 @@
 #include <memory>
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 #include "video/color.hpp"
 #include "video/surface_ptr.hpp"
@@ -57,6 +58,17 @@ public:
 
   const Tile& get(const uint32_t id) const;
 
+  /** Resolves the current frame of every animated tile into the
+      frame table, called once per frame before anything is drawn */
+  void update_animations();
+
+  /** Returns the surface of tile id as of the last
+      update_animations(), editor selects the editor images */
+  const SurfacePtr& get_current_surface(uint32_t id, bool editor) const;
+
+  /** Sorted ids of the tiles whose surface changes over time */
+  const std::vector<uint32_t>& get_animated_tiles() const { return m_animated_tiles; }
+
   uint32_t get_max_tileid() const {
     return static_cast<uint32_t>(m_tiles.size());
   }
@@ -71,6 +83,12 @@ private:
   std::vector<std::unique_ptr<Tile> > m_tiles;
   std::vector<Tilegroup> m_tilegroups;
 
+  /** Frame table indexed by tile id, filled by add_tile() for static
+      tiles and by update_animations() for animated ones */
+  std::vector<SurfacePtr> m_surfaces;
+  std::vector<SurfacePtr> m_editor_surfaces;
+  std::vector<uint32_t> m_animated_tiles;
+
 private:
   TileSet(const TileSet&) = delete;
   TileSet& operator=(const TileSet&) = delete;
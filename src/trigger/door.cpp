@@ -22,10 +22,18 @@
 #include "sprite/sprite_manager.hpp"
 #include "supertux/fadetoblack.hpp"
 #include "supertux/game_session.hpp"
+#include "supertux/level.hpp"
 #include "supertux/screen_manager.hpp"
 #include "supertux/sector.hpp"
 #include "util/reader_mapping.hpp"
 
+namespace {
+
+/** Start loading the target sector when a player comes this close */
+const float PREFETCH_DISTANCE = 320.0f;
+
+} // namespace
+
 Door::Door(const ReaderMapping& mapping) :
   TriggerBase(mapping),
   state(CLOSED),
@@ -33,7 +41,8 @@ Door::Door(const ReaderMapping& mapping) :
   target_spawnpoint(),
   script(),
   sprite(SpriteManager::current()->create("images/objects/door/door.sprite")),
-  stay_open_timer()
+  stay_open_timer(),
+  prefetched(false)
 {
   mapping.get("x", m_col.m_bbox.get_left());
   mapping.get("y", m_col.m_bbox.get_top());
@@ -43,7 +52,7 @@ Door::Door(const ReaderMapping& mapping) :
   mapping.get("script", script);
 
   sprite->set_action("closed");
-  m_col.m_bbox.set_size(sprite->get_current_hitbox_width(), sprite->get_current_hitbox_height());
+  m_col.set_size(sprite->get_current_hitbox_width(), sprite->get_current_hitbox_height());
 
   SoundManager::current()->preload("sounds/door.wav");
 }
@@ -55,12 +64,13 @@ Door::Door(int x, int y, const std::string& sector, const std::string& spawnpoin
   target_spawnpoint(spawnpoint),
   script(),
   sprite(SpriteManager::current()->create("images/objects/door/door.sprite")),
-  stay_open_timer()
+  stay_open_timer(),
+  prefetched(false)
 {
-  m_col.m_bbox.set_pos(Vector(static_cast<float>(x), static_cast<float>(y)));
+  m_col.set_pos(Vector(static_cast<float>(x), static_cast<float>(y)));
 
   sprite->set_action("closed");
-  m_col.m_bbox.set_size(sprite->get_current_hitbox_width(), sprite->get_current_hitbox_height());
+  m_col.set_size(sprite->get_current_hitbox_width(), sprite->get_current_hitbox_height());
 
   SoundManager::current()->preload("sounds/door.wav");
 }
@@ -86,6 +96,16 @@ Door::~Door()
 void
 Door::update(float )
 {
+  if (!prefetched && !target_sector.empty()) {
+    const Player* player = Sector::get().get_nearest_player(m_col.m_bbox);
+    if (player && (player->get_bbox().get_middle() - m_col.m_bbox.get_middle()).norm() < PREFETCH_DISTANCE) {
+      prefetched = true;
+      if (Sector* sector = Sector::get().get_level().get_sector(target_sector)) {
+        sector->prefetch();
+      }
+    }
+  }
+
   switch (state) {
     case CLOSED:
       break;
@@ -55,6 +55,7 @@ private:
   std::string script;
   SpritePtr sprite; /**< "door" sprite to render */
   Timer stay_open_timer; /**< time until door will close again */
+  bool prefetched; /**< true once the target sector has been prefetched */
 
 private:
   Door(const Door&) = delete;
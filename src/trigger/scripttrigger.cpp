@@ -36,7 +36,7 @@ ScriptTrigger::ScriptTrigger(const ReaderMapping& reader) :
   float w = 32, h = 32;
   reader.get("width", w);
   reader.get("height", h);
-  m_col.m_bbox.set_size(w, h);
+  m_col.set_size(w, h);
   new_size.x = w;
   new_size.y = h;
   reader.get("script", script);
@@ -60,8 +60,8 @@ ScriptTrigger::ScriptTrigger(const Vector& pos, const std::string& script_) :
   oneshot(false),
   runcount(0)
 {
-  m_col.m_bbox.set_pos(pos);
-  m_col.m_bbox.set_size(32, 32);
+  m_col.set_pos(pos);
+  m_col.set_size(32, 32);
 }
 
 ObjectSettings
@@ -88,7 +88,7 @@ ScriptTrigger::get_settings()
 
 void
 ScriptTrigger::after_editor_set() {
-  m_col.m_bbox.set_size(new_size.x, new_size.y);
+  m_col.set_size(new_size.x, new_size.y);
   if (must_activate) {
     triggerevent = EVENT_ACTIVATE;
   } else {
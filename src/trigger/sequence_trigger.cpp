@@ -36,7 +36,7 @@ SequenceTrigger::SequenceTrigger(const ReaderMapping& reader) :
   float w, h;
   reader.get("width", w, 32.0f);
   reader.get("height", h, 32.0f);
-  m_col.m_bbox.set_size(w, h);
+  m_col.set_size(w, h);
   new_size.x = w;
   new_size.y = h;
   std::string sequence_name;
@@ -57,8 +57,8 @@ SequenceTrigger::SequenceTrigger(const Vector& pos, const std::string& sequence_
   fade_tilemap(),
   fade()
 {
-  m_col.m_bbox.set_pos(pos);
-  m_col.m_bbox.set_size(32, 32);
+  m_col.set_pos(pos);
+  m_col.set_size(32, 32);
 }
 
 ObjectSettings
@@ -91,7 +91,7 @@ SequenceTrigger::get_settings()
 void
 SequenceTrigger::after_editor_set()
 {
-  m_col.m_bbox.set_size(new_size.x, new_size.y);
+  m_col.set_size(new_size.x, new_size.y);
 }
 
 void
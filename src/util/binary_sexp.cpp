@@ -0,0 +1,293 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "util/binary_sexp.hpp"
+
+#include <stdexcept>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+namespace binary_sexp {
+
+namespace {
+
+enum Tag : uint8_t
+{
+  TAG_NIL,
+  TAG_FALSE,
+  TAG_TRUE,
+  TAG_INTEGER,
+  TAG_REAL,
+  TAG_STRING,
+  TAG_SYMBOL,
+  TAG_CONS,
+  TAG_ARRAY,
+
+  /** an array whose elements after the first are all integers */
+  TAG_INTEGER_ARRAY
+};
+
+/** Integer lists shorter than this are written element by element */
+const size_t MIN_INTEGER_ARRAY = 4;
+
+void write_uint32(std::ostream& out, uint32_t value)
+{
+  const char bytes[4] = {
+    static_cast<char>(value & 0xff),
+    static_cast<char>((value >> 8) & 0xff),
+    static_cast<char>((value >> 16) & 0xff),
+    static_cast<char>((value >> 24) & 0xff)
+  };
+  out.write(bytes, sizeof(bytes));
+}
+
+void write_string(std::ostream& out, const std::string& str)
+{
+  write_uint32(out, static_cast<uint32_t>(str.size()));
+  out.write(str.data(), str.size());
+}
+
+bool is_integer_array(const std::vector<sexp::Value>& arr)
+{
+  if (arr.size() < MIN_INTEGER_ARRAY + 1)
+    return false;
+
+  for (size_t i = 1; i < arr.size(); ++i) {
+    if (!arr[i].is_integer())
+      return false;
+  }
+  return true;
+}
+
+class Decoder final
+{
+public:
+  Decoder(const char* data, size_t size) :
+    m_data(reinterpret_cast<const uint8_t*>(data)),
+    m_size(size),
+    m_pos(0)
+  {}
+
+  sexp::Value read_value()
+  {
+    switch (read_byte())
+    {
+      case TAG_NIL:
+        return sexp::Value::nil();
+
+      case TAG_FALSE:
+        return sexp::Value::boolean(false);
+
+      case TAG_TRUE:
+        return sexp::Value::boolean(true);
+
+      case TAG_INTEGER:
+        return sexp::Value::integer(static_cast<int32_t>(read_uint32()));
+
+      case TAG_REAL: {
+        const uint32_t bits = read_uint32();
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return sexp::Value::real(value);
+      }
+
+      case TAG_STRING:
+        return sexp::Value::string(read_string());
+
+      case TAG_SYMBOL:
+        return sexp::Value::symbol(read_string());
+
+      case TAG_CONS: {
+        sexp::Value car = read_value();
+        sexp::Value cdr = read_value();
+        return sexp::Value::cons(std::move(car), std::move(cdr));
+      }
+
+      case TAG_ARRAY: {
+        const uint32_t count = read_count(1);
+        std::vector<sexp::Value> arr;
+        arr.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+          arr.push_back(read_value());
+        }
+        return sexp::Value::array(std::move(arr));
+      }
+
+      case TAG_INTEGER_ARRAY: {
+        std::vector<sexp::Value> arr;
+        sexp::Value head = read_value();
+        const uint32_t count = read_count(4);
+        arr.reserve(count + 1);
+        arr.push_back(std::move(head));
+
+        // the integers are one contiguous block, decode it in one go
+        const uint8_t* block = m_data + m_pos;
+        for (uint32_t i = 0; i < count; ++i) {
+          const uint8_t* p = block + i * 4;
+          const uint32_t value = static_cast<uint32_t>(p[0]) |
+            (static_cast<uint32_t>(p[1]) << 8) |
+            (static_cast<uint32_t>(p[2]) << 16) |
+            (static_cast<uint32_t>(p[3]) << 24);
+          arr.push_back(sexp::Value::integer(static_cast<int32_t>(value)));
+        }
+        m_pos += count * 4;
+        return sexp::Value::array(std::move(arr));
+      }
+
+      default:
+        throw std::runtime_error("binary sexp: unknown tag");
+    }
+  }
+
+  bool at_end() const { return m_pos == m_size; }
+
+private:
+  void need(size_t count) const
+  {
+    if (m_size - m_pos < count)
+      throw std::runtime_error("binary sexp: unexpected end of data");
+  }
+
+  uint8_t read_byte()
+  {
+    need(1);
+    return m_data[m_pos++];
+  }
+
+  uint32_t read_uint32()
+  {
+    need(4);
+    const uint8_t* p = m_data + m_pos;
+    m_pos += 4;
+    return static_cast<uint32_t>(p[0]) |
+      (static_cast<uint32_t>(p[1]) << 8) |
+      (static_cast<uint32_t>(p[2]) << 16) |
+      (static_cast<uint32_t>(p[3]) << 24);
+  }
+
+  /** Reads an element count and checks that the data can hold that
+      many elements of at least element_size bytes */
+  uint32_t read_count(size_t element_size)
+  {
+    const uint32_t count = read_uint32();
+    need(static_cast<size_t>(count) * element_size);
+    return count;
+  }
+
+  std::string read_string()
+  {
+    const uint32_t length = read_count(1);
+    std::string result(reinterpret_cast<const char*>(m_data + m_pos), length);
+    m_pos += length;
+    return result;
+  }
+
+private:
+  const uint8_t* m_data;
+  size_t m_size;
+  size_t m_pos;
+
+private:
+  Decoder(const Decoder&) = delete;
+  Decoder& operator=(const Decoder&) = delete;
+};
+
+} // namespace
+
+void write(std::ostream& out, const sexp::Value& sx)
+{
+  switch (sx.get_type())
+  {
+    case sexp::Value::Type::NIL:
+      out.put(static_cast<char>(TAG_NIL));
+      break;
+
+    case sexp::Value::Type::BOOLEAN:
+      out.put(static_cast<char>(sx.as_bool() ? TAG_TRUE : TAG_FALSE));
+      break;
+
+    case sexp::Value::Type::INTEGER:
+      out.put(static_cast<char>(TAG_INTEGER));
+      write_uint32(out, static_cast<uint32_t>(sx.as_int()));
+      break;
+
+    case sexp::Value::Type::REAL: {
+      const float value = sx.as_float();
+      uint32_t bits;
+      memcpy(&bits, &value, sizeof(bits));
+      out.put(static_cast<char>(TAG_REAL));
+      write_uint32(out, bits);
+      break;
+    }
+
+    case sexp::Value::Type::STRING:
+      out.put(static_cast<char>(TAG_STRING));
+      write_string(out, sx.as_string());
+      break;
+
+    case sexp::Value::Type::SYMBOL:
+      out.put(static_cast<char>(TAG_SYMBOL));
+      write_string(out, sx.as_string());
+      break;
+
+    case sexp::Value::Type::CONS:
+      out.put(static_cast<char>(TAG_CONS));
+      write(out, sx.get_car());
+      write(out, sx.get_cdr());
+      break;
+
+    case sexp::Value::Type::ARRAY: {
+      const auto& arr = sx.as_array();
+      if (is_integer_array(arr)) {
+        out.put(static_cast<char>(TAG_INTEGER_ARRAY));
+        write(out, arr[0]);
+        write_uint32(out, static_cast<uint32_t>(arr.size() - 1));
+
+        std::vector<char> block((arr.size() - 1) * 4);
+        for (size_t i = 1; i < arr.size(); ++i) {
+          const uint32_t value = static_cast<uint32_t>(arr[i].as_int());
+          char* p = block.data() + (i - 1) * 4;
+          p[0] = static_cast<char>(value & 0xff);
+          p[1] = static_cast<char>((value >> 8) & 0xff);
+          p[2] = static_cast<char>((value >> 16) & 0xff);
+          p[3] = static_cast<char>((value >> 24) & 0xff);
+        }
+        out.write(block.data(), block.size());
+      } else {
+        out.put(static_cast<char>(TAG_ARRAY));
+        write_uint32(out, static_cast<uint32_t>(arr.size()));
+        for (const auto& value : arr) {
+          write(out, value);
+        }
+      }
+      break;
+    }
+  }
+}
+
+sexp::Value read(const char* data, size_t size)
+{
+  Decoder decoder(data, size);
+  sexp::Value sx = decoder.read_value();
+  if (!decoder.at_end())
+    throw std::runtime_error("binary sexp: trailing data");
+  return sx;
+}
+
+} // namespace binary_sexp
+
+/* EOF */
@@ -0,0 +1,40 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_UTIL_BINARY_SEXP_HPP
+#define HEADER_SUPERTUX_UTIL_BINARY_SEXP_HPP
+
+#include <ostream>
+#include <sexp/value.hpp>
+#include <stddef.h>
+
+/** Compact binary encoding of sexp trees, which is a lot faster to
+    load than the text format. Values are tagged, strings and symbols
+    are length prefixed and lists of integers, like the tiles of a
+    tilemap, are stored as one block of little-endian int32. */
+namespace binary_sexp {
+
+void write(std::ostream& out, const sexp::Value& sx);
+
+/** Reads a value written by write(), throws std::runtime_error on
+    malformed data */
+sexp::Value read(const char* data, size_t size);
+
+} // namespace binary_sexp
+
+#endif
+
+/* EOF */
@@ -1,5 +1,5 @@
 //  SuperTux
-//  Copyright (C) 2018 Ingo Ruhnke <grumbel@gmail.com>
+//  Copyright (C) 2020 SuperTux Devel Team
 //
 //  This program is free software: you can redistribute it and/or modify
 //  it under the terms of the GNU General Public License as published by
@@ -14,27 +14,21 @@
 //  You should have received a copy of the GNU General Public License
 //  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
-#ifndef HEADER_SUPERTUX_UTIL_TIMELOG_HPP
-#define HEADER_SUPERTUX_UTIL_TIMELOG_HPP
 
-#include <SDL.h>
+#include "util/command_queue.hpp"
 
-class Timelog
-{
-public:
-  Timelog();
-
-  void log(const char* component = nullptr);
-
-private:
-  Uint32 m_last_ticks;
-  const char* m_last_component = nullptr;
+thread_local CommandQueue* CommandQueue::s_current = nullptr;
 
-private:
-  Timelog(const Timelog&) = delete;
-  Timelog& operator=(const Timelog&) = delete;
-};
+CommandQueue::CommandQueue() :
+  m_index(0),
+  m_commands()
+{
+}
 
-#endif
+void
+CommandQueue::push(std::function<void ()> command)
+{
+  m_commands.push_back(Command(m_index, std::move(command)));
+}
 
 /* EOF */
@@ -0,0 +1,69 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_UTIL_COMMAND_QUEUE_HPP
+#define HEADER_SUPERTUX_UTIL_COMMAND_QUEUE_HPP
+
+#include <functional>
+#include <stddef.h>
+#include <utility>
+#include <vector>
+
+/** Collects side effects, like spawning objects or playing sounds,
+    of work that ParallelFor runs on several threads. Every command is
+    tagged with the index of the work item that pushed it, so that the
+    commands of all threads can be run later in the same order a
+    serial loop would have produced them. */
+class CommandQueue final
+{
+public:
+  typedef std::pair<size_t, std::function<void ()> > Command;
+
+public:
+  /** Returns the queue of the calling thread while it runs work items
+      of a ParallelFor, nullptr otherwise. Code that can't run off the
+      main thread pushes itself here instead. */
+  static CommandQueue* current() { return s_current; }
+
+  /** Makes queue the queue of the calling thread, nullptr to unset */
+  static void set_current(CommandQueue* queue) { s_current = queue; }
+
+public:
+  CommandQueue();
+
+  /** Sets the work item index that pushed commands are tagged with */
+  void set_index(size_t index) { m_index = index; }
+
+  void push(std::function<void ()> command);
+
+  std::vector<Command>& get_commands() { return m_commands; }
+
+private:
+  static thread_local CommandQueue* s_current;
+
+private:
+  size_t m_index;
+  std::vector<Command> m_commands;
+
+private:
+  CommandQueue(const CommandQueue&) = delete;
+  CommandQueue& operator=(const CommandQueue&) = delete;
+};
+
+#endif
+
+/* EOF */
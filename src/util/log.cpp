@@ -18,6 +18,7 @@
 #include "util/log.hpp"
 
 #include <iostream>
+#include <thread>
 
 #include "math/rectf.hpp"
 #include "supertux/console.hpp"
@@ -26,9 +27,19 @@
 
 LogLevel g_log_level = LOG_WARNING;
 
+/** Static initialization runs on the main thread. Worker threads log
+    straight to std::cerr, as the ConsoleBuffer and the Console are
+    only safe to use from the main thread. */
+static const std::thread::id s_main_thread = std::this_thread::get_id();
+
+static bool is_main_thread()
+{
+  return std::this_thread::get_id() == s_main_thread;
+}
+
 static std::ostream& get_logging_instance (bool use_console_buffer = true)
 {
-  if (ConsoleBuffer::current() && use_console_buffer)
+  if (ConsoleBuffer::current() && use_console_buffer && is_main_thread())
     return (ConsoleBuffer::output);
   else
     return (std::cerr);
@@ -52,7 +63,7 @@ std::ostream& log_info_f(const char* file, int line)
 
 std::ostream& log_warning_f(const char* file, int line)
 {
-  if (g_config && g_config->developer_mode &&
+  if (g_config && g_config->developer_mode && is_main_thread() &&
      Console::current() && !Console::current()->hasFocus()) {
     Console::current()->open();
   }
@@ -61,7 +72,7 @@ std::ostream& log_warning_f(const char* file, int line)
 
 std::ostream& log_fatal_f(const char* file, int line)
 {
-  if (g_config && g_config->developer_mode &&
+  if (g_config && g_config->developer_mode && is_main_thread() &&
      Console::current() && !Console::current()->hasFocus()) {
     Console::current()->open();
   }
@@ -0,0 +1,67 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "util/object_pool.hpp"
+
+#include <algorithm>
+#include <boost/core/demangle.hpp>
+#include <mutex>
+
+namespace {
+
+std::vector<const ObjectPoolStats*>& get_registry()
+{
+  static std::vector<const ObjectPoolStats*> registry;
+  return registry;
+}
+
+/** Pools are created on first use, which may happen on any thread */
+std::mutex s_registry_mutex;
+
+} // namespace
+
+const std::vector<const ObjectPoolStats*>&
+ObjectPoolStats::get_all()
+{
+  return get_registry();
+}
+
+ObjectPoolStats::ObjectPoolStats(const std::type_info& type) :
+  allocations(0),
+  reuses(0),
+  live(0),
+  free(0),
+  m_type(type)
+{
+  std::lock_guard<std::mutex> lock(s_registry_mutex);
+  get_registry().push_back(this);
+}
+
+ObjectPoolStats::~ObjectPoolStats()
+{
+  std::lock_guard<std::mutex> lock(s_registry_mutex);
+  auto& registry = get_registry();
+  registry.erase(std::remove(registry.begin(), registry.end(), this), registry.end());
+}
+
+std::string
+ObjectPoolStats::get_name() const
+{
+  return boost::core::demangle(m_type.name());
+}
+
+/* EOF */
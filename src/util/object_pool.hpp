@@ -0,0 +1,140 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_UTIL_OBJECT_POOL_HPP
+#define HEADER_SUPERTUX_UTIL_OBJECT_POOL_HPP
+
+#include <assert.h>
+#include <mutex>
+#include <new>
+#include <stddef.h>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+/** Allocation counters of one pooled class, all live instances are
+    listed by get_all() for the debug menu */
+class ObjectPoolStats final
+{
+public:
+  static const std::vector<const ObjectPoolStats*>& get_all();
+
+public:
+  ObjectPoolStats(const std::type_info& type);
+  ~ObjectPoolStats();
+
+  /** Returns the demangled name of the pooled class */
+  std::string get_name() const;
+
+public:
+  /** Number of objects allocated in total */
+  int allocations;
+
+  /** Number of allocations served from the free list */
+  int reuses;
+
+  /** Number of objects currently alive */
+  int live;
+
+  /** Number of blocks waiting on the free list */
+  int free;
+
+private:
+  const std::type_info& m_type;
+
+private:
+  ObjectPoolStats(const ObjectPoolStats&) = delete;
+  ObjectPoolStats& operator=(const ObjectPoolStats&) = delete;
+};
+
+/** Gives T a class-specific operator new and delete that recycle
+    memory through a free list instead of going to the heap, meant for
+    objects that are spawned and destroyed all the time. Derive T from
+    Pooled<T>; T should be final so that every block has the same
+    size. The free list is locked, as objects that are updated in
+    parallel may spawn pooled objects. */
+template<class T>
+class Pooled
+{
+public:
+  /** Blocks beyond this are returned to the heap */
+  static const size_t MAX_FREE = 256;
+
+public:
+  static void* operator new(size_t size)
+  {
+    Pool& pool = get_pool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.stats.allocations += 1;
+    pool.stats.live += 1;
+
+    if (size != sizeof(T) || pool.blocks.empty())
+      return ::operator new(size);
+
+    void* ptr = pool.blocks.back();
+    pool.blocks.pop_back();
+    pool.stats.reuses += 1;
+    pool.stats.free = static_cast<int>(pool.blocks.size());
+    return ptr;
+  }
+
+  static void operator delete(void* ptr, size_t size)
+  {
+    if (!ptr)
+      return;
+
+    Pool& pool = get_pool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    assert(pool.stats.live > 0);
+    pool.stats.live -= 1;
+
+    if (size != sizeof(T) || pool.blocks.size() >= MAX_FREE) {
+      ::operator delete(ptr);
+    } else {
+      pool.blocks.push_back(ptr);
+      pool.stats.free = static_cast<int>(pool.blocks.size());
+    }
+  }
+
+  static const ObjectPoolStats& get_pool_stats() { return get_pool().stats; }
+
+private:
+  struct Pool
+  {
+    Pool() : stats(typeid(T)), blocks(), mutex() {}
+    ~Pool()
+    {
+      for (void* ptr : blocks) {
+        ::operator delete(ptr);
+      }
+    }
+
+    ObjectPoolStats stats;
+    std::vector<void*> blocks;
+    std::mutex mutex;
+  };
+
+  static Pool& get_pool()
+  {
+    static Pool pool;
+    return pool;
+  }
+};
+
+#endif
+
+/* EOF */
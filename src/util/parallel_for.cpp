@@ -0,0 +1,153 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "util/parallel_for.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <iterator>
+
+#include "util/worker_pool.hpp"
+
+namespace {
+
+uint64_t make_range(size_t begin, size_t end)
+{
+  return (static_cast<uint64_t>(begin) << 32) | static_cast<uint64_t>(end);
+}
+
+size_t get_begin(uint64_t range) { return static_cast<size_t>(range >> 32); }
+size_t get_end(uint64_t range) { return static_cast<size_t>(range & 0xffffffff); }
+
+} // namespace
+
+ParallelFor::ParallelFor(int num_threads) :
+  m_workers(new WorkerPool(num_threads)),
+  m_slots(),
+  m_commands()
+{
+  for (int i = 0; i < num_threads + 1; ++i) {
+    m_slots.push_back(std::make_unique<Slot>());
+  }
+}
+
+ParallelFor::~ParallelFor()
+{
+}
+
+void
+ParallelFor::run(size_t count, const std::function<void (size_t)>& func)
+{
+  assert(count <= 0xffffffff);
+
+  const size_t num_slots = m_slots.size();
+  for (size_t i = 0; i < num_slots; ++i) {
+    m_slots[i]->range = make_range(count * i / num_slots, count * (i + 1) / num_slots);
+  }
+
+  for (size_t i = 1; i < num_slots; ++i) {
+    m_workers->add([this, i, &func]{ work(i, func); });
+  }
+  work(0, func);
+  m_workers->wait();
+
+  // The iterations of one index all ran on the same thread, so a
+  // stable sort by index restores the serial order of the commands
+  for (auto& slot : m_slots) {
+    auto& commands = slot->queue.get_commands();
+    std::move(commands.begin(), commands.end(), std::back_inserter(m_commands));
+    commands.clear();
+  }
+  std::stable_sort(m_commands.begin(), m_commands.end(),
+                   [](const CommandQueue::Command& lhs, const CommandQueue::Command& rhs) {
+                     return lhs.first < rhs.first;
+                   });
+
+  for (const auto& command : m_commands) {
+    command.second();
+  }
+  m_commands.clear();
+}
+
+void
+ParallelFor::work(size_t slot, const std::function<void (size_t)>& func)
+{
+  Slot& own = *m_slots[slot];
+  CommandQueue::set_current(&own.queue);
+
+  while (true)
+  {
+    size_t index;
+    if (!pop(own, index))
+    {
+      if (!steal(slot))
+        break;
+      continue;
+    }
+
+    own.queue.set_index(index);
+    func(index);
+  }
+
+  CommandQueue::set_current(nullptr);
+}
+
+bool
+ParallelFor::pop(Slot& slot, size_t& index)
+{
+  uint64_t range = slot.range.load();
+  while (true)
+  {
+    const size_t begin = get_begin(range);
+    const size_t end = get_end(range);
+    if (begin >= end)
+      return false;
+
+    if (slot.range.compare_exchange_weak(range, make_range(begin + 1, end))) {
+      index = begin;
+      return true;
+    }
+  }
+}
+
+bool
+ParallelFor::steal(size_t slot)
+{
+  const size_t num_slots = m_slots.size();
+  for (size_t i = 1; i < num_slots; ++i)
+  {
+    Slot& victim = *m_slots[(slot + i) % num_slots];
+    uint64_t range = victim.range.load();
+    while (true)
+    {
+      const size_t begin = get_begin(range);
+      const size_t end = get_end(range);
+      if (begin >= end)
+        break;
+
+      // take the back half, the owner keeps popping from the front
+      const size_t mid = end - (end - begin + 1) / 2;
+      if (victim.range.compare_exchange_weak(range, make_range(begin, mid))) {
+        m_slots[slot]->range = make_range(mid, end);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/* EOF */
@@ -0,0 +1,87 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_UTIL_PARALLEL_FOR_HPP
+#define HEADER_SUPERTUX_UTIL_PARALLEL_FOR_HPP
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+#include "util/command_queue.hpp"
+
+class WorkerPool;
+
+/** Spreads the iterations of a loop over a WorkerPool and the calling
+    thread. Every thread starts with an equal share of the indices and
+    steals half of the remaining indices of another thread once its own
+    share is done, so a few expensive iterations don't hold up the
+    loop. */
+class ParallelFor final
+{
+public:
+  /** num_threads is the number of threads in addition to the calling
+      thread, with 0 every loop runs on the calling thread alone */
+  ParallelFor(int num_threads);
+  ~ParallelFor();
+
+  /** Calls func(i) for every i in [0, count) and returns once all
+      calls are done. The commands func pushed to
+      CommandQueue::current() are then run on the calling thread,
+      ordered by i. func must not throw. */
+  void run(size_t count, const std::function<void (size_t)>& func);
+
+  /** Returns the number of threads including the calling thread */
+  int get_thread_count() const { return static_cast<int>(m_slots.size()); }
+
+private:
+  struct Slot
+  {
+    Slot() : range(0), queue() {}
+
+    /** Indices that are left, begin in the upper and end in the lower
+        32 bits, so that owner and thieves can update both at once */
+    std::atomic<uint64_t> range;
+
+    CommandQueue queue;
+  };
+
+private:
+  void work(size_t slot, const std::function<void (size_t)>& func);
+
+  /** Takes the first index of the range of slot */
+  bool pop(Slot& slot, size_t& index);
+
+  /** Moves half of the indices of some other slot into the (empty)
+      range of slot, returns false when there is nothing left */
+  bool steal(size_t slot);
+
+private:
+  std::unique_ptr<WorkerPool> m_workers;
+  std::vector<std::unique_ptr<Slot> > m_slots;
+  std::vector<CommandQueue::Command> m_commands;
+
+private:
+  ParallelFor(const ParallelFor&) = delete;
+  ParallelFor& operator=(const ParallelFor&) = delete;
+};
+
+#endif
+
+/* EOF */
@@ -0,0 +1,321 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "util/profiler.hpp"
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+#include "util/log.hpp"
+
+namespace {
+
+void write_json_string(std::ostream& out, const char* text)
+{
+  out << '"';
+  for (const char* c = text; *c; ++c)
+  {
+    if (*c == '"' || *c == '\\')
+      out << '\\';
+    out << *c;
+  }
+  out << '"';
+}
+
+void write_trace_event(std::ostream& out, const char* name, int64_t start, int64_t end)
+{
+  // timestamps are in microseconds
+  char times[64];
+  snprintf(times, sizeof(times), ",\"ts\":%.3f,\"dur\":%.3f",
+           static_cast<double>(start) / 1000.0,
+           static_cast<double>(end - start) / 1000.0);
+
+  out << "{\"name\":";
+  write_json_string(out, name);
+  out << ",\"ph\":\"X\",\"pid\":1,\"tid\":1" << times << "}";
+}
+
+} // namespace
+
+const int Profiler::FRAME_HISTORY;
+
+Profiler&
+Profiler::instance()
+{
+  static Profiler s_profiler;
+  return s_profiler;
+}
+
+Profiler::Profiler() :
+  m_epoch(std::chrono::steady_clock::now()),
+  m_thread_id(),
+  m_frames(FRAME_HISTORY),
+  m_frame_count(0),
+  m_in_frame(false),
+  m_current(),
+  m_depth(0),
+  m_phase_handle(-1)
+{
+}
+
+int64_t
+Profiler::now() const
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_epoch).count();
+}
+
+void
+Profiler::bind_thread()
+{
+  // only written when the binding changes, which happens at startup
+  // before other threads look at it
+  const std::thread::id thread_id = std::this_thread::get_id();
+  if (m_thread_id != thread_id)
+    m_thread_id = thread_id;
+}
+
+void
+Profiler::begin_frame()
+{
+  bind_thread();
+
+  // frames can't start inside of a zone, as that would invalidate
+  // the handles of the open zones
+  if (m_depth != 0)
+    return;
+
+  m_in_frame = true;
+  m_current.events.clear();
+  m_current.start = now();
+}
+
+void
+Profiler::end_frame()
+{
+  if (!m_in_frame || std::this_thread::get_id() != m_thread_id)
+    return;
+
+  m_in_frame = false;
+  m_current.end = now();
+
+  // swap so that the event storage of old frames gets reused
+  std::swap(m_frames[m_frame_count % FRAME_HISTORY], m_current);
+  m_frame_count += 1;
+  m_current.events.clear();
+}
+
+int
+Profiler::begin_zone(const char* name)
+{
+  if (std::this_thread::get_id() != m_thread_id)
+    return -1;
+
+  const int handle = static_cast<int>(m_current.events.size());
+  m_current.events.push_back(Event{name, m_depth, now(), 0});
+  m_depth += 1;
+  return handle;
+}
+
+void
+Profiler::end_zone(int handle)
+{
+  if (handle < 0 || handle >= static_cast<int>(m_current.events.size()))
+    return;
+
+  m_current.events[handle].end = now();
+  m_depth -= 1;
+
+  // zones outside of frames are only kept while a phase is running
+  if (!m_in_frame && m_depth == 0 && m_phase_handle < 0)
+    m_current.events.clear();
+}
+
+void
+Profiler::next_phase(const char* name)
+{
+  bind_thread();
+
+  if (m_phase_handle >= 0)
+  {
+    end_zone(m_phase_handle);
+
+    const Event& phase = m_current.events[m_phase_handle];
+    log_info << "Component '" << phase.name << "' finished after "
+             << static_cast<double>(phase.end - phase.start) / 1.0e9 << " seconds"
+             << std::endl;
+
+    m_phase_handle = -1;
+    if (!m_in_frame && m_depth == 0)
+      m_current.events.clear();
+  }
+
+  if (name != nullptr)
+  {
+    m_phase_handle = begin_zone(name);
+  }
+}
+
+int
+Profiler::get_frame_count() const
+{
+  return std::min(m_frame_count, FRAME_HISTORY);
+}
+
+const Profiler::Frame*
+Profiler::get_last_frame() const
+{
+  if (m_frame_count == 0)
+    return nullptr;
+
+  return &m_frames[(m_frame_count - 1) % FRAME_HISTORY];
+}
+
+const Profiler::Frame&
+Profiler::get_frame(int index) const
+{
+  // index 0 is the oldest recorded frame
+  return m_frames[(m_frame_count - get_frame_count() + index) % FRAME_HISTORY];
+}
+
+float
+Profiler::get_average_frame_time() const
+{
+  const int count = get_frame_count();
+  if (count == 0)
+    return 0.0f;
+
+  int64_t total = 0;
+  for (int i = 0; i < count; ++i)
+  {
+    const Frame& frame = get_frame(i);
+    total += frame.end - frame.start;
+  }
+  return static_cast<float>(total) / 1.0e6f / static_cast<float>(count);
+}
+
+std::vector<Profiler::ZoneStats>
+Profiler::get_zone_stats() const
+{
+  struct Node
+  {
+    const char* name;
+    int parent;
+    int depth;
+    int calls;
+    int64_t total;
+    int64_t max;
+    int64_t frame_total;
+  };
+
+  std::vector<Node> nodes;
+  std::vector<int> stack;
+
+  const int count = get_frame_count();
+  for (int i = 0; i < count; ++i)
+  {
+    for (const auto& event : get_frame(i).events)
+    {
+      if (event.end == 0)
+        continue;
+
+      stack.resize(event.depth);
+      const int parent = event.depth > 0 ? stack.back() : -1;
+
+      auto it = std::find_if(nodes.begin(), nodes.end(),
+                             [&event, parent](const Node& node) {
+                               return node.parent == parent && strcmp(node.name, event.name) == 0;
+                             });
+      if (it == nodes.end())
+      {
+        nodes.push_back(Node{event.name, parent, event.depth, 0, 0, 0, 0});
+        it = nodes.end() - 1;
+      }
+
+      it->calls += 1;
+      it->frame_total += event.end - event.start;
+      stack.push_back(static_cast<int>(it - nodes.begin()));
+    }
+
+    for (auto& node : nodes)
+    {
+      node.total += node.frame_total;
+      node.max = std::max(node.max, node.frame_total);
+      node.frame_total = 0;
+    }
+  }
+
+  // walk the tree in pre-order, children come in the order they were
+  // first seen, which is the order in which they usually run
+  std::vector<ZoneStats> result;
+  std::vector<int> todo;
+  for (int i = static_cast<int>(nodes.size()) - 1; i >= 0; --i)
+  {
+    if (nodes[i].parent == -1)
+      todo.push_back(i);
+  }
+
+  while (!todo.empty())
+  {
+    const int index = todo.back();
+    todo.pop_back();
+
+    const Node& node = nodes[index];
+    result.push_back(ZoneStats{node.name, node.depth,
+                               static_cast<float>(node.calls) / static_cast<float>(count),
+                               static_cast<float>(node.total) / 1.0e6f / static_cast<float>(count),
+                               static_cast<float>(node.max) / 1.0e6f});
+
+    for (int i = static_cast<int>(nodes.size()) - 1; i > index; --i)
+    {
+      if (nodes[i].parent == index)
+        todo.push_back(i);
+    }
+  }
+
+  return result;
+}
+
+void
+Profiler::write_chrome_trace(std::ostream& out) const
+{
+  out << "{\"traceEvents\":[\n";
+
+  bool first = true;
+  const int count = get_frame_count();
+  for (int i = 0; i < count; ++i)
+  {
+    const Frame& frame = get_frame(i);
+
+    if (!first)
+      out << ",\n";
+    first = false;
+    write_trace_event(out, "Frame", frame.start, frame.end);
+
+    for (const auto& event : frame.events)
+    {
+      if (event.end == 0)
+        continue;
+
+      out << ",\n";
+      write_trace_event(out, event.name, event.start, event.end);
+    }
+  }
+
+  out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+/* EOF */
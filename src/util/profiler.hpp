@@ -0,0 +1,170 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_UTIL_PROFILER_HPP
+#define HEADER_SUPERTUX_UTIL_PROFILER_HPP
+
+#include <chrono>
+#include <ostream>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+/** Records nested, named zones per frame and keeps the last
+    FRAME_HISTORY frames around for statistics and trace export. Only
+    zones on the thread that runs the frames and phases are recorded,
+    begin_frame() and next_phase() bind the profiler to the calling
+    thread. Zone names must be string literals or otherwise outlive
+    the profiler. */
+class Profiler final
+{
+public:
+  static const int FRAME_HISTORY = 300;
+
+  struct Event
+  {
+    const char* name;
+    int depth;
+    int64_t start; // nanoseconds since the profiler was created
+    int64_t end;
+  };
+
+  struct Frame
+  {
+    int64_t start;
+    int64_t end;
+    std::vector<Event> events;
+  };
+
+  /** Zone timings averaged over the recorded frames, ordered as a
+      pre-order walk of the zone tree */
+  struct ZoneStats
+  {
+    const char* name;
+    int depth;
+    float calls; // per frame
+    float avg_msec; // per frame
+    float max_msec; // in a single frame
+  };
+
+public:
+  static Profiler& instance();
+
+public:
+  Profiler();
+
+  void begin_frame();
+  void end_frame();
+
+  /** Returns a handle for end_zone() or -1 when the zone isn't
+      recorded */
+  int begin_zone(const char* name);
+  void end_zone(int handle);
+
+  /** Ends the previous phase and begins the next one, phases are top
+      level zones outside of frames whose times get logged, used for
+      the startup sequence. Pass nullptr to end the last phase. */
+  void next_phase(const char* name);
+
+  int get_frame_count() const;
+
+  /** Returns the most recently finished frame, nullptr if there is
+      none */
+  const Frame* get_last_frame() const;
+  float get_average_frame_time() const;
+  std::vector<ZoneStats> get_zone_stats() const;
+
+  /** Writes the recorded frames in the Chrome trace event format,
+      viewable in chrome://tracing */
+  void write_chrome_trace(std::ostream& out) const;
+
+private:
+  void bind_thread();
+  int64_t now() const;
+  const Frame& get_frame(int index) const;
+
+private:
+  std::chrono::steady_clock::time_point m_epoch;
+  std::thread::id m_thread_id;
+
+  /** Ring buffer of finished frames */
+  std::vector<Frame> m_frames;
+  int m_frame_count;
+
+  bool m_in_frame;
+  Frame m_current;
+  int m_depth;
+
+  int m_phase_handle;
+
+private:
+  Profiler(const Profiler&) = delete;
+  Profiler& operator=(const Profiler&) = delete;
+};
+
+/** Records the enclosing scope as a zone */
+class ProfileZone final
+{
+public:
+  ProfileZone(const char* name) :
+    m_handle(Profiler::instance().begin_zone(name))
+  {
+  }
+
+  ~ProfileZone()
+  {
+    if (m_handle >= 0)
+      Profiler::instance().end_zone(m_handle);
+  }
+
+private:
+  int m_handle;
+
+private:
+  ProfileZone(const ProfileZone&) = delete;
+  ProfileZone& operator=(const ProfileZone&) = delete;
+};
+
+/** Records the enclosing scope as a frame */
+class ProfileFrame final
+{
+public:
+  ProfileFrame() { Profiler::instance().begin_frame(); }
+  ~ProfileFrame() { Profiler::instance().end_frame(); }
+
+private:
+  ProfileFrame(const ProfileFrame&) = delete;
+  ProfileFrame& operator=(const ProfileFrame&) = delete;
+};
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef ENABLE_PROFILER
+#  define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profile_zone_, __LINE__)(name)
+#  define PROFILE_FRAME() ProfileFrame PROFILE_CONCAT(profile_frame_, __LINE__)
+#else
+#  define PROFILE_ZONE(name)
+#  define PROFILE_FRAME()
+#endif
+
+/** Startup phases are always timed and logged, also without
+    ENABLE_PROFILER */
+#define PROFILE_PHASE(name) Profiler::instance().next_phase(name)
+
+#endif
+
+/* EOF */
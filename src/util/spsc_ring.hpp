@@ -0,0 +1,92 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_UTIL_SPSC_RING_HPP
+#define HEADER_SUPERTUX_UTIL_SPSC_RING_HPP
+
+#include <atomic>
+#include <stddef.h>
+#include <vector>
+
+/** Lock-free ring of preallocated slots for exactly one producer and
+    one consumer thread. The producer fills the slot returned by
+    write_slot() and publishes it with commit_write(), the consumer
+    reads read_slot() and hands it back with commit_read(). Slots are
+    reused, so buffers inside them are only allocated once. */
+template<typename T>
+class SPSCRing final
+{
+public:
+  SPSCRing(std::vector<T> slots) :
+    m_slots(std::move(slots)),
+    m_read(0),
+    m_write(0)
+  {
+  }
+
+  /** Producer side, returns nullptr when the ring is full */
+  T* write_slot()
+  {
+    const size_t write = m_write.load(std::memory_order_relaxed);
+    if (write - m_read.load(std::memory_order_acquire) == m_slots.size())
+      return nullptr;
+    return &m_slots[write % m_slots.size()];
+  }
+
+  void commit_write()
+  {
+    m_write.store(m_write.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  /** Consumer side, returns nullptr when the ring is empty */
+  T* read_slot()
+  {
+    const size_t read = m_read.load(std::memory_order_relaxed);
+    if (m_write.load(std::memory_order_acquire) == read)
+      return nullptr;
+    return &m_slots[read % m_slots.size()];
+  }
+
+  void commit_read()
+  {
+    m_read.store(m_read.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  /** Drops all published slots, only call this while neither side is
+      running */
+  void clear()
+  {
+    m_read.store(0);
+    m_write.store(0);
+  }
+
+  size_t size() const { return m_slots.size(); }
+
+private:
+  std::vector<T> m_slots;
+
+  /** number of slots read and written so far, they only ever grow */
+  std::atomic<size_t> m_read;
+  std::atomic<size_t> m_write;
+
+private:
+  SPSCRing(const SPSCRing&) = delete;
+  SPSCRing& operator=(const SPSCRing&) = delete;
+};
+
+#endif
+
+/* EOF */
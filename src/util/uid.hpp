@@ -23,6 +23,7 @@
 #include <iosfwd>
 
 class UID;
+template<typename T> class UIDTable;
 
 namespace std {
 
@@ -37,6 +38,7 @@ struct hash<UID>
 class UID
 {
   friend class UIDGenerator;
+  template<typename T> friend class UIDTable;
   friend std::ostream& operator<<(std::ostream& os, const UID& uid);
   friend size_t std::hash<UID>::operator()(const UID&) const;
 
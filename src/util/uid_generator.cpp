@@ -20,14 +20,21 @@
 
 uint8_t UIDGenerator::s_magic_counter = 1;
 
-UIDGenerator::UIDGenerator() :
-  m_magic(s_magic_counter++),
-  m_id_counter()
+uint8_t
+UIDGenerator::next_magic()
 {
+  const uint8_t magic = s_magic_counter++;
   if (s_magic_counter == 0)
   {
     s_magic_counter = 1;
   }
+  return magic;
+}
+
+UIDGenerator::UIDGenerator() :
+  m_magic(next_magic()),
+  m_id_counter()
+{
 }
 
 UID
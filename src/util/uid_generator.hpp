@@ -24,6 +24,11 @@ class UIDGenerator
 private:
   static uint8_t s_magic_counter;
 
+public:
+  /** Returns the magic for the next generator or UIDTable, so that
+      their UIDs don't collide */
+  static uint8_t next_magic();
+
 public:
   UIDGenerator();
 
@@ -0,0 +1,161 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef HEADER_SUPERTUX_UTIL_UID_TABLE_HPP
+#define HEADER_SUPERTUX_UTIL_UID_TABLE_HPP
+
+#include <stdexcept>
+#include <stdint.h>
+#include <vector>
+
+#include "util/log.hpp"
+#include "util/uid.hpp"
+#include "util/uid_generator.hpp"
+
+/** Slot map that hands out UIDs which double as generational handles
+    into its slots, so insert(), get() and erase() are O(1) without
+    hashing. A UID packs the magic of the table, the generation of the
+    slot and the slot index. A slot is retired once its generation is
+    used up, so a stale UID never finds a newer value. */
+template<typename T>
+class UIDTable final
+{
+public:
+  static const int INDEX_BITS = 18;
+  static const int GENERATION_BITS = 6;
+  static const uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+  static const uint32_t GENERATION_MASK = (1u << GENERATION_BITS) - 1;
+
+private:
+  struct Slot
+  {
+    T value;
+    uint32_t generation;
+    bool used;
+  };
+
+public:
+  UIDTable() :
+    m_magic(UIDGenerator::next_magic()),
+    m_slots(),
+    m_free(),
+    m_retired(),
+    m_size(0)
+  {
+  }
+
+  /** Stores value and returns the UID to get it back with */
+  UID insert(const T& value)
+  {
+    if (m_free.empty() && m_slots.size() > INDEX_MASK)
+    {
+      // Like UIDGenerator, start over when running out of ids
+      log_warning << "UIDTable overflow" << std::endl;
+      for (const uint32_t index : m_retired) {
+        m_slots[index].generation = 0;
+        m_free.push_back(index);
+      }
+      m_retired.clear();
+
+      if (m_free.empty())
+        throw std::runtime_error("UIDTable: too many values");
+    }
+
+    uint32_t index;
+    if (m_free.empty()) {
+      index = static_cast<uint32_t>(m_slots.size());
+      m_slots.push_back(Slot{value, 0, true});
+    } else {
+      index = m_free.back();
+      m_free.pop_back();
+      m_slots[index].value = value;
+      m_slots[index].used = true;
+    }
+
+    m_size += 1;
+    return UID((static_cast<uint32_t>(m_magic) << 24) |
+               (m_slots[index].generation << INDEX_BITS) |
+               index);
+  }
+
+  /** Returns the value stored under uid, or T() if uid was erased or
+      belongs to a different table */
+  T get(const UID& uid) const
+  {
+    const Slot* slot = find(uid);
+    return slot ? slot->value : T();
+  }
+
+  void erase(const UID& uid)
+  {
+    Slot* slot = const_cast<Slot*>(find(uid));
+    if (!slot)
+      return;
+
+    const uint32_t index = uid.m_value & INDEX_MASK;
+    slot->value = T();
+    slot->used = false;
+    m_size -= 1;
+
+    if (slot->generation == GENERATION_MASK) {
+      m_retired.push_back(index);
+    } else {
+      slot->generation += 1;
+      m_free.push_back(index);
+    }
+  }
+
+  size_t size() const { return m_size; }
+
+private:
+  const Slot* find(const UID& uid) const
+  {
+    if ((uid.m_value >> 24) != m_magic)
+      return nullptr;
+
+    const uint32_t index = uid.m_value & INDEX_MASK;
+    const uint32_t generation = (uid.m_value >> INDEX_BITS) & GENERATION_MASK;
+    if (index >= m_slots.size())
+      return nullptr;
+
+    const Slot& slot = m_slots[index];
+    if (!slot.used || slot.generation != generation)
+      return nullptr;
+
+    return &slot;
+  }
+
+private:
+  uint8_t m_magic;
+  std::vector<Slot> m_slots;
+
+  /** Indices of unused slots */
+  std::vector<uint32_t> m_free;
+
+  /** Indices of slots whose generation is used up */
+  std::vector<uint32_t> m_retired;
+
+  size_t m_size;
+
+private:
+  UIDTable(const UIDTable&) = delete;
+  UIDTable& operator=(const UIDTable&) = delete;
+};
+
+#endif
+
+/* EOF */
@@ -0,0 +1,102 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "util/worker_pool.hpp"
+
+#include <algorithm>
+
+#include "math/random.hpp"
+
+int
+WorkerPool::get_default_thread_count()
+{
+  const int cores = static_cast<int>(std::thread::hardware_concurrency());
+  return std::max(1, std::min(cores - 1, 4));
+}
+
+WorkerPool::WorkerPool(int num_threads) :
+  m_threads(),
+  m_jobs(),
+  m_mutex(),
+  m_job_added(),
+  m_job_done(),
+  m_running(0),
+  m_quit(false)
+{
+  // without a seed of their own all threads would produce the same
+  // graphicsRandom sequence
+  for (int i = 0; i < num_threads; ++i) {
+    m_threads.emplace_back(&WorkerPool::run, this, graphicsRandom.rand());
+  }
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quit = true;
+    m_jobs.clear();
+  }
+  m_job_added.notify_all();
+
+  for (auto& thread : m_threads) {
+    thread.join();
+  }
+}
+
+void
+WorkerPool::add(std::function<void ()> job)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobs.push_back(std::move(job));
+  }
+  m_job_added.notify_one();
+}
+
+void
+WorkerPool::wait()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_job_done.wait(lock, [this]{ return m_jobs.empty() && m_running == 0; });
+}
+
+void
+WorkerPool::run(int seed)
+{
+  graphicsRandom.seed(seed);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true)
+  {
+    m_job_added.wait(lock, [this]{ return m_quit || !m_jobs.empty(); });
+    if (m_quit)
+      return;
+
+    std::function<void ()> job = std::move(m_jobs.front());
+    m_jobs.pop_front();
+    m_running += 1;
+
+    lock.unlock();
+    job();
+    lock.lock();
+
+    m_running -= 1;
+    m_job_done.notify_all();
+  }
+}
+
+/* EOF */
@@ -0,0 +1,69 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_UTIL_WORKER_POOL_HPP
+#define HEADER_SUPERTUX_UTIL_WORKER_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** Runs jobs on a fixed set of background threads, in the order they
+    were added. Jobs must not throw. */
+class WorkerPool final
+{
+public:
+  /** Returns a thread count that leaves one core to the main thread */
+  static int get_default_thread_count();
+
+public:
+  WorkerPool(int num_threads);
+
+  /** Waits for the running jobs, jobs that haven't started yet are
+      dropped */
+  ~WorkerPool();
+
+  void add(std::function<void ()> job);
+
+  /** Blocks until all jobs have finished */
+  void wait();
+
+private:
+  /** seed is used for the graphicsRandom of the thread */
+  void run(int seed);
+
+private:
+  std::vector<std::thread> m_threads;
+  std::deque<std::function<void ()> > m_jobs;
+  std::mutex m_mutex;
+  std::condition_variable m_job_added;
+  std::condition_variable m_job_done;
+
+  /** number of jobs that are currently running */
+  int m_running;
+  bool m_quit;
+
+private:
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+};
+
+#endif
+
+/* EOF */
@@ -21,16 +21,37 @@
 #include "supertux/globals.hpp"
 #include "util/log.hpp"
 #include "util/obstackpp.hpp"
+#include "util/profiler.hpp"
 #include "video/drawing_request.hpp"
 #include "video/painter.hpp"
 #include "video/renderer.hpp"
 #include "video/surface.hpp"
 #include "video/video_system.hpp"
 
+namespace {
+
+bool can_merge(const TextureRequest& lhs, const TextureRequest& rhs)
+{
+  // referenced arrays belong to the caller and can't be appended to
+  return (!lhs.ref_srcrects && !rhs.ref_srcrects &&
+          lhs.layer == rhs.layer &&
+          lhs.texture == rhs.texture &&
+          lhs.displacement_texture == rhs.displacement_texture &&
+          lhs.blend == rhs.blend &&
+          lhs.flip == rhs.flip &&
+          lhs.alpha == rhs.alpha &&
+          lhs.color == rhs.color);
+}
+
+} // namespace
+
 Canvas::Canvas(DrawingContext& context, obstack& obst) :
   m_context(context),
   m_obst(obst),
-  m_requests()
+  m_requests(),
+  m_merged(false),
+  m_request_count(0),
+  m_draw_count(0)
 {
 }
 
@@ -47,11 +68,17 @@ Canvas::clear()
     request->~DrawingRequest();
   }
   m_requests.clear();
+
+  m_merged = false;
+  m_request_count = 0;
+  m_draw_count = 0;
 }
 
 void
 Canvas::render(Renderer& renderer, Filter filter)
 {
+  PROFILE_ZONE("Canvas::render");
+
   // On a regular level, each frame has around 50-250 requests (before
   // batching it was 1000-3000), the sort comparator function is
   // called approximatly 3-7 times for each request.
@@ -60,6 +87,13 @@ Canvas::render(Renderer& renderer, Filter filter)
                      return r1->layer < r2->layer;
                    });
 
+  if (!m_merged) {
+    m_request_count = m_requests.size();
+    merge_requests();
+    m_draw_count = m_requests.size();
+    m_merged = true;
+  }
+
   Painter& painter = renderer.get_painter();
 
   for (const auto& i : m_requests) {
@@ -164,7 +198,10 @@ Canvas::draw_surface_part(const SurfacePtr& surface, const Rectf& srcrect, const
   request->alpha = m_context.transform().alpha * style.get_alpha();
   request->blend = style.get_blend();
 
-  request->srcrects.emplace_back(srcrect);
+  // srcrect is relative to the surface, which may be a region of a larger texture
+  const Rect& region = surface->get_region();
+  request->srcrects.emplace_back(srcrect.moved(Vector(static_cast<float>(region.left),
+                                                      static_cast<float>(region.top))));
   request->dstrects.emplace_back(apply_translate(dstrect.p1()), dstrect.get_size());
   request->angles.emplace_back(0.0f);
   request->texture = surface->get_texture().get();
@@ -176,8 +213,8 @@ Canvas::draw_surface_part(const SurfacePtr& surface, const Rectf& srcrect, const
 
 void
 Canvas::draw_surface_batch(const SurfacePtr& surface,
-                           std::vector<Rectf> srcrects,
-                           std::vector<Rectf> dstrects,
+                           std::vector<Rectf>&& srcrects,
+                           std::vector<Rectf>&& dstrects,
                            const Color& color,
                            int layer)
 {
@@ -191,9 +228,9 @@ Canvas::draw_surface_batch(const SurfacePtr& surface,
 
 void
 Canvas::draw_surface_batch(const SurfacePtr& surface,
-                           std::vector<Rectf> srcrects,
-                           std::vector<Rectf> dstrects,
-                           std::vector<float> angles,
+                           std::vector<Rectf>&& srcrects,
+                           std::vector<Rectf>&& dstrects,
+                           std::vector<float>&& angles,
                            const Color& color,
                            int layer)
 {
@@ -222,6 +259,33 @@ Canvas::draw_surface_batch(const SurfacePtr& surface,
   m_requests.push_back(request);
 }
 
+void
+Canvas::draw_surface_batch_ref(const SurfacePtr& surface,
+                               const std::vector<Rectf>& srcrects,
+                               const std::vector<Rectf>& dstrects,
+                               const Color& color,
+                               int layer)
+{
+  if (!surface) return;
+
+  auto request = new(m_obst) TextureRequest();
+
+  request->type = TEXTURE;
+  request->layer = layer;
+  request->flip = m_context.transform().flip ^ surface->get_flip();
+  request->alpha = m_context.transform().alpha;
+  request->color = color;
+
+  request->ref_srcrects = &srcrects;
+  request->ref_dstrects = &dstrects;
+  request->ref_offset = apply_translate(Vector(0.0f, 0.0f));
+
+  request->texture = surface->get_texture().get();
+  request->displacement_texture = surface->get_displacement_texture().get();
+
+  m_requests.push_back(request);
+}
+
 void
 Canvas::draw_text(const FontPtr& font, const std::string& text,
                   const Vector& pos, FontAlignment alignment, int layer, const Color& color)
@@ -371,6 +435,44 @@ Canvas::get_pixel(const Vector& position, const std::shared_ptr<Color>& color_ou
   m_requests.push_back(request);
 }
 
+void
+Canvas::merge_requests()
+{
+  if (m_requests.empty())
+    return;
+
+  // Requests of the same layer are drawn in submission order, so
+  // appending the rectangles of a request to the one right before it
+  // draws exactly the same, just with a single draw call
+  size_t last = 0;
+  for (size_t i = 1; i < m_requests.size(); ++i)
+  {
+    DrawingRequest* request = m_requests[i];
+    DrawingRequest* previous = m_requests[last];
+
+    if (request->type == TEXTURE && previous->type == TEXTURE &&
+        can_merge(static_cast<const TextureRequest&>(*previous),
+                  static_cast<const TextureRequest&>(*request)))
+    {
+      auto& dst = static_cast<TextureRequest&>(*previous);
+      const auto& src = static_cast<const TextureRequest&>(*request);
+
+      dst.srcrects.insert(dst.srcrects.end(), src.srcrects.begin(), src.srcrects.end());
+      dst.dstrects.insert(dst.dstrects.end(), src.dstrects.begin(), src.dstrects.end());
+      dst.angles.insert(dst.angles.end(), src.angles.begin(), src.angles.end());
+
+      // the memory itself belongs to the obstack
+      request->~DrawingRequest();
+    }
+    else
+    {
+      last += 1;
+      m_requests[last] = request;
+    }
+  }
+  m_requests.resize(last + 1);
+}
+
 Vector
 Canvas::apply_translate(const Vector& pos) const
 {
@@ -56,17 +56,28 @@ public:
                          int layer, const PaintStyle& style = PaintStyle());
   void draw_surface_scaled(const SurfacePtr& surface, const Rectf& dstrect,
                            int layer, const PaintStyle& style = PaintStyle());
+  /** Unlike with draw_surface_part(), the srcrects are in texture
+      coordinates, see Surface::get_region(). The arrays are taken
+      over by the request. */
   void draw_surface_batch(const SurfacePtr& surface,
-                          std::vector<Rectf> srcrects,
-                          std::vector<Rectf> dstrects,
+                          std::vector<Rectf>&& srcrects,
+                          std::vector<Rectf>&& dstrects,
                           const Color& color,
                           int layer);
   void draw_surface_batch(const SurfacePtr& surface,
-                          std::vector<Rectf> srcrects,
-                          std::vector<Rectf> dstrects,
-                          std::vector<float> angles,
+                          std::vector<Rectf>&& srcrects,
+                          std::vector<Rectf>&& dstrects,
+                          std::vector<float>&& angles,
                           const Color& color,
                           int layer);
+  /** Like draw_surface_batch(), but the request only refers to the
+      arrays, for callers that keep them between frames. They must
+      stay alive and unchanged until the canvas was rendered. */
+  void draw_surface_batch_ref(const SurfacePtr& surface,
+                              const std::vector<Rectf>& srcrects,
+                              const std::vector<Rectf>& dstrects,
+                              const Color& color,
+                              int layer);
   void draw_text(const FontPtr& font, const std::string& text,
                  const Vector& position, FontAlignment alignment, int layer, const Color& color = Color(1.0,1.0,1.0));
   /** Draw text to the center of the screen */
@@ -90,14 +101,32 @@ public:
 
   DrawingContext& get_context() { return m_context; }
 
+  /** Number of requests submitted before the first render() since
+      the last clear() */
+  size_t get_request_count() const { return m_request_count; }
+
+  /** Number of requests left after merging, i.e. the number of draw
+      calls the requests turn into */
+  size_t get_draw_count() const { return m_draw_count; }
+
 private:
   Vector apply_translate(const Vector& pos) const;
 
+  /** Joins adjacent texture requests that only differ in their
+      rectangles into a single request, m_requests must be sorted */
+  void merge_requests();
+
 private:
   DrawingContext& m_context;
   obstack& m_obst;
   std::vector<DrawingRequest*> m_requests;
 
+  /** true once the requests were merged, render() is called more
+      than once per frame */
+  bool m_merged;
+  size_t m_request_count;
+  size_t m_draw_count;
+
 private:
   Canvas(const Canvas&) = delete;
   Canvas& operator=(const Canvas&) = delete;
@@ -28,7 +28,9 @@ bool Compositor::s_render_lighting = true;
 Compositor::Compositor(VideoSystem& video_system) :
   m_video_system(video_system),
   m_obst(),
-  m_drawing_contexts()
+  m_drawing_contexts(),
+  m_request_count(0),
+  m_draw_count(0)
 {
   obstack_init(&m_obst);
 }
@@ -49,6 +51,11 @@ Compositor::make_context(bool overlay)
 void
 Compositor::render()
 {
+  for (auto& ctx : m_drawing_contexts)
+  {
+    ctx->run_prerender_jobs();
+  }
+
   auto& lightmap = m_video_system.get_lightmap();
 
   bool use_lightmap = std::any_of(m_drawing_contexts.begin(), m_drawing_contexts.end(),
@@ -147,8 +154,12 @@ Compositor::render()
   }
 
   // cleanup
+  m_request_count = 0;
+  m_draw_count = 0;
   for (auto& ctx : m_drawing_contexts)
   {
+    m_request_count += ctx->color().get_request_count() + ctx->light().get_request_count();
+    m_draw_count += ctx->color().get_draw_count() + ctx->light().get_draw_count();
     ctx->clear();
   }
   m_video_system.flip();
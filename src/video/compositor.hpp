@@ -17,8 +17,9 @@
 #ifndef HEADER_SUPERTUX_VIDEO_COMPOSITOR_HPP
 #define HEADER_SUPERTUX_VIDEO_COMPOSITOR_HPP
 
-#include <vector>
 #include <memory>
+#include <stddef.h>
+#include <vector>
 
 #include "util/obstackpp.hpp"
 
@@ -44,6 +45,12 @@ public:
       otherwise their lighting would get messed up. */
   DrawingContext& make_context(bool overlay = false);
 
+  /** Number of drawing requests submitted in the last frame */
+  size_t get_request_count() const { return m_request_count; }
+
+  /** Number of draw calls the requests of the last frame were merged into */
+  size_t get_draw_count() const { return m_draw_count; }
+
 private:
   VideoSystem& m_video_system;
 
@@ -52,6 +59,9 @@ private:
 
   std::vector<std::unique_ptr<DrawingContext> > m_drawing_contexts;
 
+  size_t m_request_count;
+  size_t m_draw_count;
+
 private:
   Compositor(const Compositor&) = delete;
   Compositor& operator=(const Compositor&) = delete;
@@ -36,7 +36,8 @@ DrawingContext::DrawingContext(VideoSystem& video_system_, obstack& obst, bool o
   m_ambient_color(Color::WHITE),
   m_transform_stack(1),
   m_colormap_canvas(*this, m_obst),
-  m_lightmap_canvas(*this, m_obst)
+  m_lightmap_canvas(*this, m_obst),
+  m_prerender_jobs()
 {
 }
 
@@ -111,4 +112,14 @@ DrawingContext::pop_transform()
   assert(!m_transform_stack.empty());
 }
 
+void
+DrawingContext::run_prerender_jobs()
+{
+  for (const auto& job : m_prerender_jobs)
+  {
+    job();
+  }
+  m_prerender_jobs.clear();
+}
+
 /* EOF */
@@ -17,6 +17,7 @@
 #ifndef HEADER_SUPERTUX_VIDEO_DRAWING_CONTEXT_HPP
 #define HEADER_SUPERTUX_VIDEO_DRAWING_CONTEXT_HPP
 
+#include <functional>
 #include <string>
 #include <vector>
 #include <obstack.h>
@@ -83,10 +84,21 @@ public:
   void set_alpha(float alpha);
   float get_alpha() const;
 
+  /** Adds a job that Compositor::render() runs before the canvases
+      are rendered, for offscreen rendering that must not happen while
+      the requests are generated */
+  void add_prerender_job(std::function<void ()> job)
+  {
+    m_prerender_jobs.push_back(std::move(job));
+  }
+
+  void run_prerender_jobs();
+
   void clear()
   {
     m_lightmap_canvas.clear();
     m_colormap_canvas.clear();
+    m_prerender_jobs.clear();
   }
 
   void set_viewport(const Rect& viewport)
@@ -126,6 +138,8 @@ private:
   Canvas m_colormap_canvas;
   Canvas m_lightmap_canvas;
 
+  std::vector<std::function<void ()> > m_prerender_jobs;
+
 private:
   DrawingContext(const DrawingContext&) = delete;
   DrawingContext& operator=(const DrawingContext&) = delete;
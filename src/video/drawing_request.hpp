@@ -63,9 +63,16 @@ struct TextureRequest : public DrawingRequest
     srcrects(),
     dstrects(),
     angles(),
-    color(1.0f, 1.0f, 1.0f)
+    color(1.0f, 1.0f, 1.0f),
+    ref_srcrects(),
+    ref_dstrects(),
+    ref_offset()
   {}
 
+  const std::vector<Rectf>& get_srcrects() const { return ref_srcrects ? *ref_srcrects : srcrects; }
+  const std::vector<Rectf>& get_dstrects() const { return ref_dstrects ? *ref_dstrects : dstrects; }
+  float get_angle(size_t i) const { return ref_srcrects ? 0.0f : angles[i]; }
+
   const Texture* texture;
   const Texture* displacement_texture;
   std::vector<Rectf> srcrects;
@@ -73,6 +80,13 @@ struct TextureRequest : public DrawingRequest
   std::vector<float> angles;
   Color color;
 
+  /** Set by Canvas::draw_surface_batch_ref(), the rectangles then
+      belong to the caller instead of srcrects and dstrects. They are
+      drawn unrotated and moved by ref_offset. */
+  const std::vector<Rectf>* ref_srcrects;
+  const std::vector<Rectf>* ref_dstrects;
+  Vector ref_offset;
+
 private:
   TextureRequest(const TextureRequest&) = delete;
   TextureRequest& operator=(const TextureRequest&) = delete;
@@ -239,6 +239,7 @@ GL33CoreContext::draw_arrays(GLenum type, GLint first, GLsizei count)
 {
   assert_gl();
 
+  m_vertex_arrays->upload();
   glDrawArrays(type, first, count);
 
   assert_gl();
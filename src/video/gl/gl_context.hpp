@@ -40,6 +40,8 @@ public:
 
   virtual void blend_func(GLenum src, GLenum dst) = 0;
 
+  /** The arrays passed to set_positions(), set_texcoords() and
+      set_colors() must stay valid until the following draw_arrays() */
   virtual void set_positions(const float* data, size_t size) = 0;
 
   virtual void set_texcoords(const float* data, size_t size) = 0;
@@ -61,7 +61,9 @@ inline GLenum dfactor(Blend blend)
 
 GLPainter::GLPainter(GLVideoSystem& video_system, GLRenderer& renderer) :
   m_video_system(video_system),
-  m_renderer(renderer)
+  m_renderer(renderer),
+  m_vertices(),
+  m_uvs()
 {
 }
 
@@ -72,22 +74,31 @@ GLPainter::draw_texture(const TextureRequest& request)
 
   const auto& texture = static_cast<const GLTexture&>(*request.texture);
 
-  assert(request.srcrects.size() == request.dstrects.size());
-  assert(request.srcrects.size() == request.angles.size());
+  const std::vector<Rectf>& srcrects = request.get_srcrects();
+  const std::vector<Rectf>& dstrects = request.get_dstrects();
+  const Vector& offset = request.ref_offset;
 
-  std::vector<float> vertices;
-  std::vector<float> uvs;
-  for (size_t i = 0; i < request.srcrects.size(); ++i)
+  assert(srcrects.size() == dstrects.size());
+  assert(request.ref_srcrects || srcrects.size() == request.angles.size());
+
+  std::vector<float>& vertices = m_vertices;
+  std::vector<float>& uvs = m_uvs;
+  vertices.clear();
+  uvs.clear();
+  vertices.reserve(srcrects.size() * 12);
+  uvs.reserve(srcrects.size() * 12);
+
+  for (size_t i = 0; i < srcrects.size(); ++i)
   {
-    const float left = request.dstrects[i].get_left();
-    const float top = request.dstrects[i].get_top();
-    const float right  = request.dstrects[i].get_right();
-    const float bottom = request.dstrects[i].get_bottom();
+    const float left = dstrects[i].get_left() + offset.x;
+    const float top = dstrects[i].get_top() + offset.y;
+    const float right  = dstrects[i].get_right() + offset.x;
+    const float bottom = dstrects[i].get_bottom() + offset.y;
 
-    float uv_left = request.srcrects[i].get_left() / static_cast<float>(texture.get_texture_width());
-    float uv_top = request.srcrects[i].get_top() / static_cast<float>(texture.get_texture_height());
-    float uv_right = request.srcrects[i].get_right() / static_cast<float>(texture.get_texture_width());
-    float uv_bottom = request.srcrects[i].get_bottom() / static_cast<float>(texture.get_texture_height());
+    float uv_left = srcrects[i].get_left() / static_cast<float>(texture.get_texture_width());
+    float uv_top = srcrects[i].get_top() / static_cast<float>(texture.get_texture_height());
+    float uv_right = srcrects[i].get_right() / static_cast<float>(texture.get_texture_width());
+    float uv_bottom = srcrects[i].get_bottom() / static_cast<float>(texture.get_texture_height());
 
     if (request.flip & HORIZONTAL_FLIP)
       std::swap(uv_left, uv_right);
@@ -95,7 +106,8 @@ GLPainter::draw_texture(const TextureRequest& request)
     if (request.flip & VERTICAL_FLIP)
       std::swap(uv_top, uv_bottom);
 
-    if (request.angles[i] == 0.0f)
+    const float angle = request.get_angle(i);
+    if (angle == 0.0f)
     {
       auto vertices_lst = {
         left, top,
@@ -125,8 +137,8 @@ GLPainter::draw_texture(const TextureRequest& request)
       const float center_x = (left + right) / 2;
       const float center_y = (top + bottom) / 2;
 
-      const float sa = sinf(math::radians(request.angles[i]));
-      const float ca = cosf(math::radians(request.angles[i]));
+      const float sa = sinf(math::radians(angle));
+      const float ca = cosf(math::radians(angle));
 
       const float new_left = left - center_x;
       const float new_right = right - center_x;
@@ -169,7 +181,7 @@ GLPainter::draw_texture(const TextureRequest& request)
                           request.color.blue,
                           request.color.alpha * request.alpha));
 
-  context.draw_arrays(GL_TRIANGLES, 0, static_cast<GLsizei>(request.srcrects.size() * 2 * 3));
+  context.draw_arrays(GL_TRIANGLES, 0, static_cast<GLsizei>(srcrects.size() * 2 * 3));
 
   assert_gl();
 }
@@ -198,26 +210,18 @@ GLPainter::draw_gradient(const GradientRequest& request)
   context.set_positions(vertices, sizeof(vertices));
   context.set_texcoord(0.0f, 0.0f);
 
-  if (direction == VERTICAL || direction == VERTICAL_SECTOR)
-  {
-    const float colors[] = {
-      top.red, top.green, top.blue, top.alpha,
-      top.red, top.green, top.blue, top.alpha,
-      bottom.red, bottom.green, bottom.blue, bottom.alpha,
-      bottom.red, bottom.green, bottom.blue, bottom.alpha,
-    };
-    context.set_colors(colors, sizeof(colors));
-  }
-  else
-  {
-    const float colors[] = {
-      top.red, top.green, top.blue, top.alpha,
-      bottom.red, bottom.green, bottom.blue, bottom.alpha,
-      bottom.red, bottom.green, bottom.blue, bottom.alpha,
-      top.red, top.green, top.blue, top.alpha,
-    };
-    context.set_colors(colors, sizeof(colors));
-  }
+  // colors has to outlive draw_arrays(), set_colors() only keeps
+  // the pointer until the arrays are uploaded
+  const bool vertical = (direction == VERTICAL || direction == VERTICAL_SECTOR);
+  const Color& second = vertical ? top : bottom;
+  const Color& fourth = vertical ? bottom : top;
+  const float colors[] = {
+    top.red, top.green, top.blue, top.alpha,
+    second.red, second.green, second.blue, second.alpha,
+    bottom.red, bottom.green, bottom.blue, bottom.alpha,
+    fourth.red, fourth.green, fourth.blue, fourth.alpha,
+  };
+  context.set_colors(colors, sizeof(colors));
 
   context.draw_arrays(GL_TRIANGLE_FAN, 0, 4);
 
@@ -253,7 +257,8 @@ GLPainter::draw_filled_rect(const FillRectRequest& request)
 
     const int n = 8;
     size_t p = 0;
-    std::vector<float> vertices((n+1) * 4 * 2);
+    std::vector<float>& vertices = m_vertices;
+    vertices.resize((n+1) * 4 * 2);
 
     for (int i = 0; i <= n; ++i)
     {
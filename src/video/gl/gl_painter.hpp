@@ -19,6 +19,8 @@
 
 #include "video/painter.hpp"
 
+#include <vector>
+
 #include "video/flip.hpp"
 
 enum class Blend;
@@ -47,6 +49,11 @@ private:
   GLVideoSystem& m_video_system;
   GLRenderer& m_renderer;
 
+  /** Scratch arrays for the vertex data, reused between requests to
+      avoid allocating for every draw call */
+  std::vector<float> m_vertices;
+  std::vector<float> m_uvs;
+
 private:
   GLPainter(const GLPainter&) = delete;
   GLPainter& operator=(const GLPainter&) = delete;
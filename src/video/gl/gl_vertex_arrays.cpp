@@ -16,34 +16,51 @@
 
 #include "video/gl/gl_vertex_arrays.hpp"
 
+#include <algorithm>
+#include <string.h>
+
 #include "video/color.hpp"
 #include "video/gl/gl33core_context.hpp"
 #include "video/gl/gl_program.hpp"
 #include "video/gl/gl_video_system.hpp"
 #include "video/glutil.hpp"
 
+namespace {
+
+/** Initial size of the stream buffer, it grows when the arrays of a
+    single draw call don't fit */
+const size_t STREAM_BUFFER_SIZE = 4 * 1024 * 1024;
+
+/** Arrays start on a 16 byte boundary within the stream buffer */
+size_t align_size(size_t size)
+{
+  return (size + 15) & ~static_cast<size_t>(15);
+}
+
+} // namespace
+
 GLVertexArrays::GLVertexArrays(GL33CoreContext& context) :
   m_context(context),
   m_vao(),
-  m_positions_buffer(),
-  m_texcoords_buffer(),
-  m_color_buffer()
+  m_stream_buffer(),
+  m_stream_size(STREAM_BUFFER_SIZE),
+  m_stream_offset(0),
+  m_pending()
 {
   assert_gl();
 
   glGenVertexArrays(1, &m_vao);
-  glGenBuffers(1, &m_positions_buffer);
-  glGenBuffers(1, &m_texcoords_buffer);
-  glGenBuffers(1, &m_color_buffer);
+  glGenBuffers(1, &m_stream_buffer);
+
+  glBindBuffer(GL_ARRAY_BUFFER, m_stream_buffer);
+  glBufferData(GL_ARRAY_BUFFER, m_stream_size, nullptr, GL_STREAM_DRAW);
 
   assert_gl();
 }
 
 GLVertexArrays::~GLVertexArrays()
 {
-  glDeleteBuffers(1, &m_positions_buffer);
-  glDeleteBuffers(1, &m_texcoords_buffer);
-  glDeleteBuffers(1, &m_color_buffer);
+  glDeleteBuffers(1, &m_stream_buffer);
   glDeleteVertexArrays(1, &m_vao);
 }
 
@@ -60,31 +77,13 @@ GLVertexArrays::bind()
 void
 GLVertexArrays::set_positions(const float* data, size_t size)
 {
-  assert_gl();
-
-  glBindBuffer(GL_ARRAY_BUFFER, m_positions_buffer);
-  glBufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW);
-
-  int loc = m_context.get_program().get_attrib_location("position");
-  glVertexAttribPointer(loc, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
-  glEnableVertexAttribArray(loc);
-
-  assert_gl();
+  set_attribute("position", 2, data, size);
 }
 
 void
 GLVertexArrays::set_texcoords(const float* data, size_t size)
 {
-  assert_gl();
-
-  glBindBuffer(GL_ARRAY_BUFFER, m_texcoords_buffer);
-  glBufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW);
-
-  int loc = m_context.get_program().get_attrib_location("texcoord");
-  glVertexAttribPointer(loc, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
-  glEnableVertexAttribArray(loc);
-
-  assert_gl();
+  set_attribute("texcoord", 2, data, size);
 }
 
 void
@@ -92,6 +91,8 @@ GLVertexArrays::set_texcoord(float u, float v)
 {
   assert_gl();
 
+  remove_attribute("texcoord");
+
   int loc = m_context.get_program().get_attrib_location("texcoord");
   glVertexAttrib2f(loc, u, v);
   glDisableVertexAttribArray(loc);
@@ -101,29 +102,107 @@ GLVertexArrays::set_texcoord(float u, float v)
 
 void
 GLVertexArrays::set_colors(const float* data, size_t size)
+{
+  set_attribute("diffuse", 4, data, size);
+}
+
+void
+GLVertexArrays::set_color(const Color& color)
 {
   assert_gl();
 
-  glBindBuffer(GL_ARRAY_BUFFER, m_texcoords_buffer);
-  glBufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW);
+  remove_attribute("diffuse");
 
   int loc = m_context.get_program().get_attrib_location("diffuse");
-  glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
-  glEnableVertexAttribArray(loc);
+  glVertexAttrib4f(loc, color.red, color.green, color.blue, color.alpha);
+  glDisableVertexAttribArray(loc);
 
   assert_gl();
 }
 
 void
-GLVertexArrays::set_color(const Color& color)
+GLVertexArrays::upload()
 {
+  if (m_pending.empty())
+    return;
+
   assert_gl();
 
-  int loc = m_context.get_program().get_attrib_location("diffuse");
-  glVertexAttrib4f(loc, color.red, color.green, color.blue, color.alpha);
-  glDisableVertexAttribArray(loc);
+  size_t total_size = 0;
+  for (const auto& attribute : m_pending) {
+    total_size += align_size(attribute.size);
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, m_stream_buffer);
+
+  if (m_stream_offset + total_size > m_stream_size)
+  {
+    // Orphan the old storage instead of waiting for the draw calls
+    // still reading from it, the driver frees it once they are done.
+    // All arrays of a draw call are uploaded together, so none of
+    // them is left behind in the orphaned storage.
+    m_stream_size = std::max(m_stream_size, total_size);
+    glBufferData(GL_ARRAY_BUFFER, m_stream_size, nullptr, GL_STREAM_DRAW);
+    m_stream_offset = 0;
+  }
+
+#ifndef USE_OPENGLES2
+  // The range wasn't written since the buffer was last orphaned, so
+  // no pending draw call reads from it and no sync is needed
+  auto dst = static_cast<char*>(glMapBufferRange(GL_ARRAY_BUFFER, m_stream_offset, total_size,
+                                                 GL_MAP_WRITE_BIT |
+                                                 GL_MAP_INVALIDATE_RANGE_BIT |
+                                                 GL_MAP_UNSYNCHRONIZED_BIT));
+#endif
+
+  size_t offset = 0;
+  for (const auto& attribute : m_pending)
+  {
+#ifndef USE_OPENGLES2
+    if (dst) {
+      memcpy(dst + offset, attribute.data, attribute.size);
+    } else {
+      glBufferSubData(GL_ARRAY_BUFFER, m_stream_offset + offset, attribute.size, attribute.data);
+    }
+#else
+    glBufferSubData(GL_ARRAY_BUFFER, m_stream_offset + offset, attribute.size, attribute.data);
+#endif
+
+    int loc = m_context.get_program().get_attrib_location(attribute.name);
+    glVertexAttribPointer(loc, attribute.components, GL_FLOAT, GL_FALSE, 0,
+                          reinterpret_cast<const void*>(m_stream_offset + offset));
+    glEnableVertexAttribArray(loc);
+
+    offset += align_size(attribute.size);
+  }
+
+#ifndef USE_OPENGLES2
+  if (dst) {
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+  }
+#endif
+
+  m_stream_offset += total_size;
+  m_pending.clear();
 
   assert_gl();
 }
 
+void
+GLVertexArrays::set_attribute(const char* name, GLint components, const float* data, size_t size)
+{
+  remove_attribute(name);
+  m_pending.push_back(Attribute{name, components, data, size});
+}
+
+void
+GLVertexArrays::remove_attribute(const char* name)
+{
+  m_pending.erase(std::remove_if(m_pending.begin(), m_pending.end(),
+                                 [name](const Attribute& attribute) {
+                                   return strcmp(attribute.name, name) == 0;
+                                 }),
+                  m_pending.end());
+}
+
 /* EOF */
@@ -18,12 +18,18 @@
 #define HEADER_SUPERTUX_VIDEO_GL_GL_VERTEX_ARRAYS_HPP
 
 #include <stddef.h>
+#include <vector>
 
 #include "video/gl.hpp"
 
 class Color;
 class GL33CoreContext;
 
+/** Owns the vertex array object of the GL33CoreContext. All vertex
+    data is streamed into a single buffer: the arrays of a draw call
+    are appended behind the previous ones and the buffer is orphaned
+    once it is full, so a whole frame is suballocated from one
+    allocation without respecifying the buffer for every draw call. */
 class GLVertexArrays final
 {
 public:
@@ -32,6 +38,8 @@ public:
 
   void bind();
 
+  /** The set_*s() functions only remember the data, it has to stay
+      valid until upload() copies it into the stream buffer */
   void set_positions(const float* data, size_t size);
 
   /** size is in bytes */
@@ -41,12 +49,35 @@ public:
   void set_colors(const float* data, size_t size);
   void set_color(const Color& color);
 
+  /** Copies the arrays given since the last upload() into the stream
+      buffer and points the attributes at them, call before drawing */
+  void upload();
+
+private:
+  struct Attribute
+  {
+    const char* name;
+    GLint components;
+    const float* data;
+    size_t size;
+  };
+
+private:
+  void set_attribute(const char* name, GLint components, const float* data, size_t size);
+  void remove_attribute(const char* name);
+
 private:
   GL33CoreContext& m_context;
   GLuint m_vao;
-  GLuint m_positions_buffer;
-  GLuint m_texcoords_buffer;
-  GLuint m_color_buffer;
+  GLuint m_stream_buffer;
+
+  /** size of the stream buffer storage in bytes */
+  size_t m_stream_size;
+
+  /** byte offset of the next upload into the stream buffer */
+  size_t m_stream_offset;
+
+  std::vector<Attribute> m_pending;
 
 private:
   GLVertexArrays(const GLVertexArrays&) = delete;
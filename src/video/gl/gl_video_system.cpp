@@ -286,6 +286,12 @@ GLVideoSystem::new_texture(const SDL_Surface& image, const Sampler& sampler)
   return TexturePtr(new GLTexture(image, sampler));
 }
 
+std::unique_ptr<Renderer>
+GLVideoSystem::new_texture_renderer(const Size& size, int downscale)
+{
+  return std::make_unique<GLTextureRenderer>(*this, size, downscale);
+}
+
 void
 GLVideoSystem::flip()
 {
@@ -62,6 +62,12 @@ NullVideoSystem::new_texture(const SDL_Surface& image, const Sampler& sampler)
   return TexturePtr(new NullTexture(Size(image.w, image.h)));
 }
 
+std::unique_ptr<Renderer>
+NullVideoSystem::new_texture_renderer(const Size& /*size*/, int /*downscale*/)
+{
+  return std::make_unique<NullRenderer>();
+}
+
 const Viewport&
 NullVideoSystem::get_viewport() const
 {
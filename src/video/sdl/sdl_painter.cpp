@@ -226,13 +226,16 @@ SDLPainter::draw_texture(const TextureRequest& request)
 {
   const auto& texture = static_cast<const SDLTexture&>(*request.texture);
 
-  assert(request.srcrects.size() == request.dstrects.size());
-  assert(request.srcrects.size() == request.angles.size());
+  const std::vector<Rectf>& srcrects = request.get_srcrects();
+  const std::vector<Rectf>& dstrects = request.get_dstrects();
 
-  for (size_t i = 0; i < request.srcrects.size(); ++i)
+  assert(srcrects.size() == dstrects.size());
+  assert(request.ref_srcrects || srcrects.size() == request.angles.size());
+
+  for (size_t i = 0; i < srcrects.size(); ++i)
   {
-    const SDL_Rect& src_rect = to_sdl_rect(request.srcrects[i]);
-    const SDL_Rect& dst_rect = to_sdl_rect(request.dstrects[i]);
+    const SDL_Rect& src_rect = to_sdl_rect(srcrects[i]);
+    const SDL_Rect& dst_rect = to_sdl_rect(dstrects[i].moved(request.ref_offset));
 
     Uint8 r = static_cast<Uint8>(request.color.red * 255);
     Uint8 g = static_cast<Uint8>(request.color.green * 255);
@@ -256,7 +259,7 @@ SDLPainter::draw_texture(const TextureRequest& request)
 
     RenderCopyEx(m_sdl_renderer, texture.get_texture(),
                  &src_rect, &dst_rect,
-                 static_cast<double>(request.angles[i]), nullptr, flip,
+                 static_cast<double>(request.get_angle(i)), nullptr, flip,
                  texture.get_sampler());
   }
 }
@@ -19,7 +19,9 @@
 #include <SDL.h>
 #include <sstream>
 
+#include "util/log.hpp"
 #include "video/sdl/sdl_screen_renderer.hpp"
+#include "video/sdl_surface_ptr.hpp"
 #include "video/video_system.hpp"
 
 SDLTexture::SDLTexture(SDL_Texture* texture, int width, int height, const Sampler& sampler) :
@@ -54,4 +56,24 @@ SDLTexture::~SDLTexture()
   SDL_DestroyTexture(m_texture);
 }
 
+void
+SDLTexture::update(const SDL_Surface& image, int x, int y)
+{
+  Uint32 format;
+  SDL_QueryTexture(m_texture, &format, nullptr, nullptr, nullptr);
+
+  SDLSurfacePtr convert(SDL_ConvertSurfaceFormat(const_cast<SDL_Surface*>(&image), format, 0));
+  if (!convert)
+  {
+    log_warning << "couldn't convert surface: " << SDL_GetError() << std::endl;
+    return;
+  }
+
+  const SDL_Rect dstrect{x, y, convert->w, convert->h};
+  if (SDL_UpdateTexture(m_texture, &dstrect, convert->pixels, convert->pitch) != 0)
+  {
+    log_warning << "couldn't update texture: " << SDL_GetError() << std::endl;
+  }
+}
+
 /* EOF */
@@ -38,6 +38,8 @@ public:
   virtual int get_image_width() const override { return m_width; }
   virtual int get_image_height() const override { return m_height; }
 
+  virtual void update(const SDL_Surface& image, int x, int y) override;
+
   SDL_Texture *get_texture() const { return m_texture; }
   const Sampler& get_sampler() const { return m_sampler; }
 
@@ -113,6 +113,12 @@ SDLVideoSystem::new_texture(const SDL_Surface& image, const Sampler& sampler)
   return TexturePtr(new SDLTexture(image, sampler));
 }
 
+std::unique_ptr<Renderer>
+SDLVideoSystem::new_texture_renderer(const Size& size, int downscale)
+{
+  return std::make_unique<SDLTextureRenderer>(*this, m_sdl_renderer.get(), size, downscale);
+}
+
 void
 SDLVideoSystem::set_vsync(int mode)
 {
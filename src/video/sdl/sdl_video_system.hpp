@@ -41,6 +41,7 @@ public:
   virtual Renderer& get_lightmap() const override;
 
   virtual TexturePtr new_texture(const SDL_Surface& image, const Sampler& sampler) override;
+  virtual std::unique_ptr<Renderer> new_texture_renderer(const Size& size, int downscale) override;
 
   virtual const Viewport& get_viewport() const override { return m_viewport; }
   virtual void apply_config() override;
@@ -21,6 +21,7 @@
 #include "util/reader_document.hpp"
 #include "util/reader_mapping.hpp"
 #include "util/string_util.hpp"
+#include "video/sampler.hpp"
 #include "video/texture.hpp"
 #include "video/texture_manager.hpp"
 #include "video/video_system.hpp"
@@ -73,16 +74,9 @@ Surface::from_file(const std::string& filename, const boost::optional<Rect>& rec
   }
   else
   {
-    if (rect)
-    {
-      TexturePtr texture = TextureManager::current()->get(filename, *rect);
-      return SurfacePtr(new Surface(texture, TexturePtr(), NO_FLIP));
-    }
-    else
-    {
-      TexturePtr texture = TextureManager::current()->get(filename);
-      return SurfacePtr(new Surface(texture, TexturePtr(), NO_FLIP));
-    }
+    Rect region;
+    TexturePtr texture = TextureManager::current()->get_packed(filename, rect, Sampler(), region);
+    return SurfacePtr(new Surface(texture, TexturePtr(), region, NO_FLIP));
   }
 }
 
@@ -132,7 +126,9 @@ Surface::region(const Rect& rect) const
 {
   SurfacePtr surface(new Surface(m_diffuse_texture,
                                  m_displacement_texture,
-                                 rect,
+                                 Rect(m_region.left + rect.left,
+                                      m_region.top + rect.top,
+                                      rect.get_size()),
                                  m_flip));
   return surface;
 }
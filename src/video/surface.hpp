@@ -46,6 +46,8 @@ private:
 public:
   ~Surface();
 
+  /** Returns a surface showing the part rect of this surface, rect is
+      relative to the top left corner of this surface */
   SurfacePtr region(const Rect& rect) const;
   SurfacePtr clone(Flip flip = NO_FLIP) const;
 
@@ -30,9 +30,7 @@ SurfaceBatch::SurfaceBatch(const SurfacePtr& surface) :
 void
 SurfaceBatch::draw(const Vector& pos, float angle)
 {
-  m_srcrects.emplace_back(Rectf(0, 0,
-                                static_cast<float>(m_surface->get_width()),
-                                static_cast<float>(m_surface->get_height())));
+  m_srcrects.emplace_back(Rectf(m_surface->get_region()));
   m_dstrects.emplace_back(Rectf(pos,
                                 Sizef(static_cast<float>(m_surface->get_width()),
                                       static_cast<float>(m_surface->get_height()))));
@@ -42,9 +40,7 @@ SurfaceBatch::draw(const Vector& pos, float angle)
 void
 SurfaceBatch::draw(const Rectf& dstrect, float angle)
 {
-  m_srcrects.emplace_back(Rectf(0, 0,
-                                static_cast<float>(m_surface->get_width()),
-                                static_cast<float>(m_surface->get_height())));
+  m_srcrects.emplace_back(Rectf(m_surface->get_region()));
   m_dstrects.emplace_back(dstrect);
   m_angles.emplace_back(angle);
 }
@@ -52,7 +48,9 @@ SurfaceBatch::draw(const Rectf& dstrect, float angle)
 void
 SurfaceBatch::draw(const Rectf& srcrect, const Rectf& dstrect, float angle)
 {
-  m_srcrects.emplace_back(srcrect);
+  const Rect& region = m_surface->get_region();
+  m_srcrects.emplace_back(srcrect.moved(Vector(static_cast<float>(region.left),
+                                               static_cast<float>(region.top))));
   m_dstrects.emplace_back(dstrect);
   m_angles.emplace_back(angle);
 }
@@ -0,0 +1,199 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "video/texture_atlas.hpp"
+
+#include <SDL.h>
+#include <algorithm>
+
+#include "video/sampler.hpp"
+#include "video/sdl_surface.hpp"
+#include "video/texture.hpp"
+#include "video/video_system.hpp"
+
+namespace {
+
+void blit(const SDL_Surface& src, int src_x, int src_y, int width, int height,
+          SDL_Surface& dst, int dst_x, int dst_y)
+{
+  SDL_Rect srcrect{src_x, src_y, width, height};
+  SDL_Rect dstrect{dst_x, dst_y, width, height};
+  SDL_BlitSurface(const_cast<SDL_Surface*>(&src), &srcrect, &dst, &dstrect);
+}
+
+} // namespace
+
+TextureAtlas::TextureAtlas(int page_size, int max_image_size) :
+  m_page_size(page_size),
+  m_max_image_size(std::min(max_image_size, page_size - 2)),
+  m_pages()
+{
+}
+
+bool
+TextureAtlas::supports(const Sampler& sampler)
+{
+  return (sampler.get_filter() == GL_LINEAR &&
+          sampler.get_wrap_s() == GL_CLAMP_TO_EDGE &&
+          sampler.get_wrap_t() == GL_CLAMP_TO_EDGE &&
+          sampler.get_animate().x == 0.0f &&
+          sampler.get_animate().y == 0.0f);
+}
+
+TexturePtr
+TextureAtlas::add(const SDL_Surface& image, const Rect& rect, Rect& region)
+{
+  const int width = rect.get_width();
+  const int height = rect.get_height();
+
+  if (width <= 0 || height <= 0 ||
+      width > m_max_image_size || height > m_max_image_size ||
+      rect.left < 0 || rect.top < 0 || rect.right > image.w || rect.bottom > image.h)
+  {
+    return TexturePtr();
+  }
+
+  // one pixel of padding on every side
+  const int padded_width = width + 2;
+  const int padded_height = height + 2;
+
+  Page* page = nullptr;
+  TexturePtr texture;
+  int x = 0;
+  int y = 0;
+  for (auto& candidate : m_pages)
+  {
+    texture = candidate.texture.lock();
+    if (texture && allocate(candidate, padded_width, padded_height, x, y))
+    {
+      page = &candidate;
+      break;
+    }
+  }
+
+  if (!page)
+  {
+    SDLSurfacePtr blank = SDLSurface::create_rgba(m_page_size, m_page_size);
+    texture = VideoSystem::current()->new_texture(*blank);
+    m_pages.push_back(Page{texture, {}, 0, 0, 0});
+    page = &m_pages.back();
+
+    if (!allocate(*page, padded_width, padded_height, x, y))
+      return TexturePtr();
+  }
+
+  // Copy the image and repeat its outermost pixels into the padding
+  SDLSurfacePtr padded = SDLSurface::create_rgba(padded_width, padded_height);
+  SDL_SetSurfaceBlendMode(const_cast<SDL_Surface*>(&image), SDL_BLENDMODE_NONE);
+
+  const int left = rect.left;
+  const int top = rect.top;
+  const int right = rect.right - 1;
+  const int bottom = rect.bottom - 1;
+
+  blit(image, left, top, width, height, *padded, 1, 1);
+
+  blit(image, left, top, width, 1, *padded, 1, 0);
+  blit(image, left, bottom, width, 1, *padded, 1, height + 1);
+  blit(image, left, top, 1, height, *padded, 0, 1);
+  blit(image, right, top, 1, height, *padded, width + 1, 1);
+
+  blit(image, left, top, 1, 1, *padded, 0, 0);
+  blit(image, right, top, 1, 1, *padded, width + 1, 0);
+  blit(image, left, bottom, 1, 1, *padded, 0, height + 1);
+  blit(image, right, bottom, 1, 1, *padded, width + 1, height + 1);
+
+  texture->update(*padded, x, y);
+  page->used_pixels += width * height;
+  page->image_count += 1;
+
+  region = Rect(x + 1, y + 1, Size(width, height));
+  return texture;
+}
+
+size_t
+TextureAtlas::release_unused_pages()
+{
+  const size_t count = m_pages.size();
+  m_pages.erase(std::remove_if(m_pages.begin(), m_pages.end(),
+                               [](const Page& page) {
+                                 return page.texture.expired();
+                               }),
+                m_pages.end());
+  return count - m_pages.size();
+}
+
+bool
+TextureAtlas::allocate(Page& page, int width, int height, int& x, int& y) const
+{
+  // pick the lowest shelf the image fits on
+  Shelf* best = nullptr;
+  for (auto& shelf : page.shelves)
+  {
+    if (shelf.height >= height && shelf.right + width <= m_page_size &&
+        (!best || shelf.height < best->height))
+    {
+      best = &shelf;
+    }
+  }
+
+  // don't waste a tall shelf on a small image while a new shelf fits
+  if ((!best || best->height > height * 2) && page.bottom + height <= m_page_size)
+  {
+    page.shelves.push_back(Shelf{page.bottom, height, 0});
+    page.bottom += height;
+    best = &page.shelves.back();
+  }
+
+  if (!best)
+    return false;
+
+  x = best->right;
+  y = best->top;
+  best->right += width;
+  return true;
+}
+
+void
+TextureAtlas::debug_print(std::ostream& out) const
+{
+  const size_t page_pixels = static_cast<size_t>(m_page_size) * static_cast<size_t>(m_page_size);
+
+  size_t total_used_pixels = 0;
+  size_t total_image_count = 0;
+  out << "atlas:begin" << std::endl;
+  for (size_t i = 0; i < m_pages.size(); ++i)
+  {
+    const auto& page = m_pages[i];
+    total_used_pixels += page.used_pixels;
+    total_image_count += page.image_count;
+
+    out << "  page " << i
+        << " size:" << m_page_size << "x" << m_page_size
+        << " shelves:" << page.shelves.size()
+        << " used:" << (100 * page.used_pixels / page_pixels) << "%" << std::endl;
+  }
+  out << "atlas:end" << std::endl;
+
+  out << "total atlas images:" << total_image_count << std::endl;
+  out << "total atlas pages:" << m_pages.size() << std::endl;
+  if (!m_pages.empty())
+  {
+    out << "total atlas efficiency:" << (100 * total_used_pixels / (page_pixels * m_pages.size())) << "%" << std::endl;
+  }
+}
+
+/* EOF */
@@ -0,0 +1,99 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADER_SUPERTUX_VIDEO_TEXTURE_ATLAS_HPP
+#define HEADER_SUPERTUX_VIDEO_TEXTURE_ATLAS_HPP
+
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "math/rect.hpp"
+#include "video/texture_ptr.hpp"
+
+class Sampler;
+struct SDL_Surface;
+
+/** Packs small images into a few large textures, so that surfaces
+    from different image files can be drawn in a single batch. Images
+    are placed on horizontal shelves, each surrounded by a one pixel
+    border repeating its edge so that linear filtering doesn't bleed
+    neighbouring images into it. Pages are owned by the surfaces
+    drawn from them and are released once none of those is left. */
+class TextureAtlas final
+{
+public:
+  /** page_size is the width and height of the page textures, images
+      larger than max_image_size in either direction are rejected */
+  TextureAtlas(int page_size, int max_image_size);
+
+  /** Returns whether images drawn with sampler may be packed. Pages
+      use linear filtering with clamped edges and the padding only
+      covers the filter, images that repeat, scroll or want another
+      filter would show their neighbours. */
+  static bool supports(const Sampler& sampler);
+
+  /** Copies the part rect of image into one of the pages. Returns
+      the page and sets region to the position of the image on it,
+      returns nullptr if the image is too large to be packed. */
+  TexturePtr add(const SDL_Surface& image, const Rect& rect, Rect& region);
+
+  /** Forgets the pages whose texture is no longer in use, so their
+      space can be filled again. Returns the number of pages released. */
+  size_t release_unused_pages();
+
+  void debug_print(std::ostream& out) const;
+
+private:
+  struct Shelf
+  {
+    int top;
+    int height;
+
+    /** x position of the next image on this shelf */
+    int right;
+  };
+
+  struct Page
+  {
+    std::weak_ptr<Texture> texture;
+    std::vector<Shelf> shelves;
+
+    /** y position of the next shelf */
+    int bottom;
+
+    /** Pixels covered by images, without their padding */
+    size_t used_pixels;
+
+    size_t image_count;
+  };
+
+private:
+  bool allocate(Page& page, int width, int height, int& x, int& y) const;
+
+private:
+  int m_page_size;
+  int m_max_image_size;
+  std::vector<Page> m_pages;
+
+private:
+  TextureAtlas(const TextureAtlas&) = delete;
+  TextureAtlas& operator=(const TextureAtlas&) = delete;
+};
+
+#endif
+
+/* EOF */
@@ -17,24 +17,35 @@
 #include "video/texture_manager.hpp"
 
 #include <SDL_image.h>
+#include <algorithm>
 #include <assert.h>
+#include <chrono>
 #include <sstream>
 
 #include "math/rect.hpp"
 #include "physfs/physfs_sdl.hpp"
+#include "supertux/gameconfig.hpp"
+#include "supertux/globals.hpp"
 #include "util/file_system.hpp"
 #include "util/log.hpp"
 #include "util/reader_document.hpp"
 #include "util/reader_mapping.hpp"
+#include "util/worker_pool.hpp"
 #include "video/color.hpp"
 #include "video/gl.hpp"
 #include "video/sampler.hpp"
 #include "video/sdl_surface.hpp"
 #include "video/texture.hpp"
+#include "video/texture_atlas.hpp"
 #include "video/video_system.hpp"
 
 namespace {
 
+/** Shared tileset images are a few hundred pixels on a side, so
+    images up to this fraction of a page are still packed, which
+    leaves room for at least four of them on one page */
+const int PACKED_IMAGES_PER_PAGE_SIDE = 2;
+
 GLenum string2wrap(const std::string& text)
 {
   if (text == "clamp-to-edge")
@@ -77,12 +88,30 @@ GLenum string2filter(const std::string& text)
 
 TextureManager::TextureManager() :
   m_image_textures(),
-  m_surfaces()
+  m_surfaces(),
+  m_atlas(),
+  m_packed_textures(),
+  m_preloading(),
+  m_decoded(),
+  m_decoded_mutex(),
+  m_preloaded(),
+  m_unclaimed(),
+  m_preload_hits(0),
+  m_preload_misses(0),
+  m_workers(new WorkerPool(WorkerPool::get_default_thread_count()))
 {
+  if (g_config->use_texture_atlas)
+  {
+    m_atlas.reset(new TextureAtlas(g_config->texture_atlas_size,
+                                   g_config->texture_atlas_size / PACKED_IMAGES_PER_PAGE_SIDE));
+  }
 }
 
 TextureManager::~TextureManager()
 {
+  m_workers.reset();
+  m_preloaded.clear();
+
   for (const auto& texture : m_image_textures)
   {
     if (!texture.second.expired())
@@ -92,6 +121,8 @@ TextureManager::~TextureManager()
   }
   m_image_textures.clear();
   m_surfaces.clear();
+  m_packed_textures.clear();
+  m_atlas.reset();
 }
 
 TexturePtr
@@ -191,7 +222,9 @@ TextureManager::get(const std::string& _filename)
   if (i != m_image_textures.end())
     texture = i->second.lock();
 
-  if (!texture) {
+  if (texture) {
+    claim_preload(key);
+  } else {
     texture = create_image_texture(filename, Sampler());
     texture->m_cache_key = key;
     m_image_textures[key] = texture;
@@ -222,7 +255,9 @@ TextureManager::get(const std::string& _filename,
   if (i != m_image_textures.end())
     texture = i->second.lock();
 
-  if (!texture) {
+  if (texture) {
+    claim_preload(key);
+  } else {
     if (rect)
     {
       texture = create_image_texture(filename, *rect, sampler);
@@ -238,6 +273,240 @@ TextureManager::get(const std::string& _filename,
   return texture;
 }
 
+TexturePtr
+TextureManager::get_packed(const std::string& _filename,
+                           const boost::optional<Rect>& rect,
+                           const Sampler& sampler,
+                           Rect& region)
+{
+  if (m_atlas && TextureAtlas::supports(sampler))
+  {
+    std::string filename = FileSystem::normalize(_filename);
+    Texture::Key key(filename, rect ? *rect : Rect());
+
+    auto i = m_packed_textures.find(key);
+    if (i != m_packed_textures.end())
+    {
+      if (TexturePtr page = i->second.page.lock())
+      {
+        claim_preload(key);
+        region = i->second.region;
+        return page;
+      }
+      m_packed_textures.erase(i);
+    }
+
+    reap_packed_textures();
+
+    try
+    {
+      TexturePtr page;
+      if (rect)
+      {
+        page = m_atlas->add(get_surface(filename), *rect, region);
+      }
+      else
+      {
+        SDLSurfacePtr image = load_image(filename);
+        if (image)
+        {
+          page = m_atlas->add(*image, Rect(0, 0, image->w, image->h), region);
+        }
+      }
+
+      if (page)
+      {
+        m_packed_textures[key] = PackedTexture{page, region};
+        return page;
+      }
+    }
+    catch(const std::exception& err)
+    {
+      log_warning << "Couldn't pack '" << filename << "' into the texture atlas: " << err.what() << std::endl;
+    }
+  }
+
+  TexturePtr texture = get(_filename, rect, sampler);
+  region = Rect(0, 0, texture->get_image_width(), texture->get_image_height());
+  return texture;
+}
+
+void
+TextureManager::preload(const std::vector<std::string>& filenames)
+{
+  for (const auto& name : filenames)
+  {
+    std::string filename = FileSystem::normalize(name);
+    const Texture::Key key(filename, Rect());
+    if (m_preloading.count(filename) || m_packed_textures.count(key))
+      continue;
+
+    auto i = m_image_textures.find(key);
+    if (i != m_image_textures.end() && !i->second.expired())
+      continue;
+
+    m_preloading.insert(filename);
+    m_workers->add([this, filename]{
+        SDLSurfacePtr image;
+        try {
+          image = SDLSurface::from_file(filename);
+        } catch(const std::exception& e) {
+          // load_image() reports the error if the image is ever used
+        }
+        std::lock_guard<std::mutex> lock(m_decoded_mutex);
+        m_decoded[filename] = std::move(image);
+      });
+  }
+}
+
+void
+TextureManager::process_preloads(float budget)
+{
+  {
+    // late results of images that load_image() didn't wait for still
+    // have to be picked up, so m_preloading may already be empty
+    std::lock_guard<std::mutex> lock(m_decoded_mutex);
+    if (m_decoded.empty())
+      return;
+  }
+
+  // textures that are in use elsewhere don't need to be kept alive
+  m_preloaded.erase(std::remove_if(m_preloaded.begin(), m_preloaded.end(),
+                                   [](const TexturePtr& texture) {
+                                     return texture.use_count() > 1;
+                                   }),
+                    m_preloaded.end());
+
+  const auto start = std::chrono::steady_clock::now();
+  while (true)
+  {
+    std::string filename;
+    SDLSurfacePtr image;
+    {
+      std::lock_guard<std::mutex> lock(m_decoded_mutex);
+      if (m_decoded.empty())
+        return;
+
+      auto i = m_decoded.begin();
+      filename = i->first;
+      image = std::move(i->second);
+      m_decoded.erase(i);
+    }
+
+    // images that load_image() didn't wait for were already loaded
+    if (!m_preloading.count(filename))
+      continue;
+
+    upload_preloaded(filename, std::move(image));
+
+    const std::chrono::duration<float> elapsed = std::chrono::steady_clock::now() - start;
+    if (elapsed.count() >= budget)
+      return;
+  }
+}
+
+void
+TextureManager::release_preloads()
+{
+  m_preloaded.clear();
+}
+
+SDLSurfacePtr
+TextureManager::load_image(const std::string& filename)
+{
+  if (m_preloading.count(filename))
+  {
+    std::lock_guard<std::mutex> lock(m_decoded_mutex);
+    auto i = m_decoded.find(filename);
+    if (i != m_decoded.end())
+    {
+      SDLSurfacePtr image = std::move(i->second);
+      m_decoded.erase(i);
+      m_preloading.erase(filename);
+      if (image)
+      {
+        m_preload_hits += 1;
+        return image;
+      }
+    }
+    // still being decoded, doing it here is faster than waiting for
+    // the jobs queued before it, process_preloads() drops the late
+    // result as the image is no longer listed in m_preloading
+    m_preloading.erase(filename);
+  }
+
+  m_preload_misses += 1;
+  return SDLSurface::from_file(filename);
+}
+
+void
+TextureManager::upload_preloaded(const std::string& filename, SDLSurfacePtr image)
+{
+  m_preloading.erase(filename);
+
+  // errors are reported when the image is actually requested
+  if (!image)
+    return;
+
+  const Texture::Key key(filename, Rect());
+  if (m_atlas)
+  {
+    auto i = m_packed_textures.find(key);
+    if (i != m_packed_textures.end() && !i->second.page.expired())
+      return;
+
+    reap_packed_textures();
+
+    Rect region;
+    TexturePtr page = m_atlas->add(*image, Rect(0, 0, image->w, image->h), region);
+    if (page)
+    {
+      m_packed_textures[key] = PackedTexture{page, region};
+      m_preloaded.push_back(page);
+      m_unclaimed.insert(key);
+      return;
+    }
+  }
+
+  auto i = m_image_textures.find(key);
+  if (i != m_image_textures.end() && !i->second.expired())
+    return;
+
+  TexturePtr texture = VideoSystem::current()->new_texture(*image, Sampler());
+  texture->m_cache_key = key;
+  m_image_textures[key] = texture;
+  m_preloaded.push_back(texture);
+  m_unclaimed.insert(key);
+}
+
+void
+TextureManager::claim_preload(const Texture::Key& key)
+{
+  if (m_unclaimed.erase(key))
+  {
+    m_preload_hits += 1;
+  }
+}
+
+void
+TextureManager::reap_packed_textures()
+{
+  if (m_atlas->release_unused_pages() == 0)
+    return;
+
+  for (auto i = m_packed_textures.begin(); i != m_packed_textures.end();)
+  {
+    if (i->second.page.expired())
+    {
+      i = m_packed_textures.erase(i);
+    }
+    else
+    {
+      ++i;
+    }
+  }
+}
+
 void
 TextureManager::reap_cache_entry(const Texture::Key& key)
 {
@@ -277,7 +546,7 @@ TextureManager::get_surface(const std::string& filename)
   }
   else
   {
-    SDLSurfacePtr image = SDLSurface::from_file(filename);
+    SDLSurfacePtr image = load_image(filename);
     if (!image)
     {
       std::ostringstream msg;
@@ -341,7 +610,7 @@ TextureManager::create_image_texture(const std::string& filename, const Sampler&
 TexturePtr
 TextureManager::create_image_texture_raw(const std::string& filename, const Sampler& sampler)
 {
-  SDLSurfacePtr image = SDLSurface::from_file(filename);
+  SDLSurfacePtr image = load_image(filename);
   if (!image)
   {
     std::ostringstream msg;
@@ -421,6 +690,14 @@ TextureManager::debug_print(std::ostream& out) const
 
   out << "total surface count:" << m_surfaces.size() << std::endl;
   out << "total surface pixels:" << total_surface_pixels << std::endl;
+
+  out << "preload hits:" << m_preload_hits << std::endl;
+  out << "preload misses:" << m_preload_misses << std::endl;
+
+  if (m_atlas)
+  {
+    m_atlas->debug_print(out);
+  }
 }
 
 /* EOF */
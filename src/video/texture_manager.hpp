@@ -20,6 +20,7 @@
 #include <config.h>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <ostream>
 #include <set>
 #include <string>
@@ -35,6 +36,8 @@
 
 class GLTexture;
 class ReaderMapping;
+class TextureAtlas;
+class WorkerPool;
 struct SDL_Surface;
 
 class TextureManager final : public Currenton<TextureManager>
@@ -52,12 +55,53 @@ public:
                  const boost::optional<Rect>& rect,
                  const Sampler& sampler = Sampler());
 
+  /** Like get(), but when the texture atlas is enabled small images
+      are packed into a shared atlas page, unless the sampler isn't
+      supported by the atlas, see TextureAtlas::supports(). region is
+      set to the area of the image on the returned texture. */
+  TexturePtr get_packed(const std::string& filename,
+                        const boost::optional<Rect>& rect,
+                        const Sampler& sampler,
+                        Rect& region);
+
+  /** Decodes the given images on background threads, the textures
+      are created by later calls to process_preloads() */
+  void preload(const std::vector<std::string>& filenames);
+
+  /** Turns decoded images into textures until budget seconds have
+      passed, call this once per frame */
+  void process_preloads(float budget);
+
+  /** Drops the references to preloaded textures that nothing has
+      picked up yet */
+  void release_preloads();
+
+  /** Number of image requests that were served by preload() */
+  int get_preload_hits() const { return m_preload_hits; }
+
+  /** Number of images that had to be decoded on the main thread */
+  int get_preload_misses() const { return m_preload_misses; }
+
   void debug_print(std::ostream& out) const;
 
 private:
   const SDL_Surface& get_surface(const std::string& filename);
+
+  /** Returns the image decoded by preload() or decodes it now */
+  SDLSurfacePtr load_image(const std::string& filename);
+
+  void upload_preloaded(const std::string& filename, SDLSurfacePtr image);
+
+  /** Counts a hit if key was created by the preloader and not
+      requested before */
+  void claim_preload(const Texture::Key& key);
+
   void reap_cache_entry(const Texture::Key& key);
 
+  /** Drops the atlas entries of images whose page is no longer used
+      by any surface */
+  void reap_packed_textures();
+
   TexturePtr create_image_texture(const std::string& filename, const Rect& rect, const Sampler& sampler);
 
   /** on failure a dummy texture is returned and no exception is thrown */
@@ -69,10 +113,42 @@ private:
 
   TexturePtr create_dummy_texture();
 
+private:
+  struct PackedTexture
+  {
+    /** the page is owned by the surfaces using it */
+    std::weak_ptr<Texture> page;
+    Rect region;
+  };
+
 private:
   std::map<Texture::Key, std::weak_ptr<Texture> > m_image_textures;
   std::map<std::string, SDLSurfacePtr> m_surfaces;
 
+  /** nullptr when the texture atlas is disabled */
+  std::unique_ptr<TextureAtlas> m_atlas;
+  std::map<Texture::Key, PackedTexture> m_packed_textures;
+
+  /** images that were handed to the worker threads and haven't been
+      uploaded or loaded by load_image() yet */
+  std::set<std::string> m_preloading;
+
+  /** images decoded by the worker threads, nullptr on failure */
+  std::map<std::string, SDLSurfacePtr> m_decoded;
+  std::mutex m_decoded_mutex;
+
+  /** keeps preloaded textures alive until they are used */
+  std::vector<TexturePtr> m_preloaded;
+
+  /** preloaded textures that haven't been requested yet */
+  std::set<Texture::Key> m_unclaimed;
+
+  int m_preload_hits;
+  int m_preload_misses;
+
+  /** destroyed first, so that no job outlives the members above */
+  std::unique_ptr<WorkerPool> m_workers;
+
 private:
   TextureManager(const TextureManager&) = delete;
   TextureManager& operator=(const TextureManager&) = delete;
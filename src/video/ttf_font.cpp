@@ -17,12 +17,16 @@
 
 #include "video/ttf_font.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <numeric>
 #include <sstream>
 
 #include "util/line_iterator.hpp"
+#include "util/utf8_iterator.hpp"
 #include "physfs/physfs_sdl.hpp"
+#include "supertux/gameconfig.hpp"
+#include "supertux/globals.hpp"
 #include "video/canvas.hpp"
 #include "video/surface.hpp"
 #include "video/ttf_surface_manager.hpp"
@@ -33,7 +37,8 @@ TTFFont::TTFFont(const std::string& filename, int font_size, float line_spacing,
   m_font_size(font_size),
   m_line_spacing(line_spacing),
   m_shadow_size(shadow_size),
-  m_border(border)
+  m_border(border),
+  m_glyph_batches()
 {
   m_font = TTF_OpenFontRW(get_physfs_SDLRWops(m_filename), 1, font_size);
   if (!m_font)
@@ -46,6 +51,11 @@ TTFFont::TTFFont(const std::string& filename, int font_size, float line_spacing,
 
 TTFFont::~TTFFont()
 {
+  if (TTFSurfaceManager::current())
+  {
+    TTFSurfaceManager::current()->forget_font(*this);
+  }
+
   TTF_CloseFont(m_font);
 }
 
@@ -108,7 +118,8 @@ TTFFont::draw_text(Canvas& canvas, const std::string& text,
   {
     const std::string& line = iter.get();
 
-    if (!line.empty())
+    if (!line.empty() &&
+        !(g_config->use_glyph_atlas && draw_glyphs(canvas, line, Vector(pos.x, last_y), alignment, layer, color)))
     {
       TTFSurfacePtr ttf_surface = TTFSurfaceManager::current()->create_surface(*this, line);
 
@@ -131,6 +142,93 @@ TTFFont::draw_text(Canvas& canvas, const std::string& text,
   }
 }
 
+bool
+TTFFont::draw_glyphs(Canvas& canvas, const std::string& line,
+                     const Vector& pos, FontAlignment alignment, int layer, const Color& color)
+{
+  TTFSurfaceManager& manager = *TTFSurfaceManager::current();
+
+  // check all glyphs before drawing, so that a line is never drawn
+  // half from the atlas and half as a TTFSurface
+  float width = 0.0f;
+  for (UTF8Iterator it(line); !it.done(); ++it)
+  {
+    const auto& glyph = manager.get_glyph(*this, *it);
+    if (!glyph.valid)
+      return false;
+    width += glyph.advance;
+  }
+
+  // same size as the TTFSurface of the line, including shadow and border
+  width += static_cast<float>(std::max(m_border * 2, m_shadow_size * 2));
+
+  Vector pen = pos;
+  if (alignment == ALIGN_CENTER)
+  {
+    pen.x -= width / 2.0f;
+  }
+  else if (alignment == ALIGN_RIGHT)
+  {
+    pen.x -= width;
+  }
+  pen = pen.floor();
+
+  for (UTF8Iterator it(line); !it.done(); ++it)
+  {
+    const auto& glyph = manager.get_glyph(*this, *it);
+    if (glyph.page)
+    {
+      auto batch = std::find_if(m_glyph_batches.begin(), m_glyph_batches.end(),
+                                [&glyph](const GlyphBatch& b) {
+                                  return b.page == glyph.page || !b.page;
+                                });
+      if (batch == m_glyph_batches.end())
+      {
+        m_glyph_batches.emplace_back();
+        batch = m_glyph_batches.end() - 1;
+      }
+      batch->page = glyph.page;
+
+      batch->decoration_srcrects.push_back(glyph.decoration_rect);
+      batch->decoration_dstrects.emplace_back(pen, glyph.decoration_rect.get_size());
+      batch->core_srcrects.push_back(glyph.core_rect);
+      batch->core_dstrects.emplace_back(pen, glyph.core_rect.get_size());
+    }
+    pen.x += glyph.advance;
+  }
+
+  // all shadows and outlines go below all cores, as in TTFSurface
+  for (auto& batch : m_glyph_batches)
+  {
+    if (!batch.page)
+      break;
+
+    canvas.draw_surface_batch(batch.page,
+                              std::move(batch.decoration_srcrects),
+                              std::move(batch.decoration_dstrects),
+                              color, layer);
+  }
+
+  for (auto& batch : m_glyph_batches)
+  {
+    if (!batch.page)
+      break;
+
+    canvas.draw_surface_batch(batch.page,
+                              std::move(batch.core_srcrects),
+                              std::move(batch.core_dstrects),
+                              color, layer);
+
+    batch.page.reset();
+    batch.decoration_srcrects.clear();
+    batch.decoration_dstrects.clear();
+    batch.core_srcrects.clear();
+    batch.core_dstrects.clear();
+  }
+
+  return true;
+}
+
 std::string
 TTFFont::wrap_to_width(const std::string& text, float width, std::string* overflow)
 {
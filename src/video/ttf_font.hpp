@@ -19,9 +19,12 @@
 #define HEADER_SUPERTUX_VIDEO_TTF_FONT_HPP
 
 #include <SDL_ttf.h>
+#include <vector>
 
+#include "math/rectf.hpp"
 #include "video/color.hpp"
 #include "video/font.hpp"
+#include "video/surface_ptr.hpp"
 
 class Canvas;
 class Painter;
@@ -54,6 +57,22 @@ public:
 
   TTF_Font* get_ttf_font() const { return m_font; }
 
+private:
+  /** Draws a single line with quads from the glyph atlas, returns
+      false without drawing anything if a glyph isn't in the atlas */
+  bool draw_glyphs(Canvas& canvas, const std::string& line,
+                   const Vector& pos, FontAlignment alignment, int layer, const Color& color);
+
+private:
+  struct GlyphBatch
+  {
+    SurfacePtr page;
+    std::vector<Rectf> decoration_srcrects;
+    std::vector<Rectf> decoration_dstrects;
+    std::vector<Rectf> core_srcrects;
+    std::vector<Rectf> core_dstrects;
+  };
+
 private:
   TTF_Font* m_font;
   std::string m_filename;
@@ -62,6 +81,9 @@ private:
   int m_shadow_size;
   int m_border;
 
+  /** Reused between draw_glyphs() calls, one per atlas page */
+  std::vector<GlyphBatch> m_glyph_batches;
+
 private:
   TTFFont(const TTFFont&) = delete;
   TTFFont& operator=(const TTFFont&) = delete;
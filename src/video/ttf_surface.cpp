@@ -39,10 +39,19 @@ TTFSurface::create(const TTFFont& font, const std::string& text)
     return std::make_shared<TTFSurface>(SurfacePtr(), Vector());
   }
 
+  SDLSurfacePtr target = render(font, *text_surface, true, true);
+
+  SurfacePtr result = Surface::from_texture(VideoSystem::current()->new_texture(*target));
+  return std::make_shared<TTFSurface>(result, Vector(0, 0));
+}
+
+SDLSurfacePtr
+TTFSurface::render(const TTFFont& font, SDL_Surface& text_surface, bool decoration, bool core)
+{
   // FIXME: handle shadow offset
   int grow = std::max(font.get_border() * 2, font.get_shadow_size() * 2);
 
-  SDLSurfacePtr target = SDLSurface::create_rgba(text_surface->w + grow, text_surface->h + grow);
+  SDLSurfacePtr target = SDLSurface::create_rgba(text_surface.w + grow, text_surface.h + grow);
 
 #if !SDL_VERSION_ATLEAST(2,0,5)
   // Perform blitting in ARGB8888, instead of RGBA8888, to avoid bug in older SDL2.
@@ -50,10 +59,11 @@ TTFSurface::create(const TTFFont& font, const std::string& text)
   target.reset(SDL_ConvertSurfaceFormat(target.get(), SDL_PIXELFORMAT_ARGB8888, 0));
 #endif
 
+  if (decoration)
   { // shadow
-    SDL_SetSurfaceAlphaMod(text_surface.get(), 192);
-    SDL_SetSurfaceColorMod(text_surface.get(), 0, 0, 0);
-    SDL_SetSurfaceBlendMode(text_surface.get(), SDL_BLENDMODE_BLEND);
+    SDL_SetSurfaceAlphaMod(&text_surface, 192);
+    SDL_SetSurfaceColorMod(&text_surface, 0, 0, 0);
+    SDL_SetSurfaceBlendMode(&text_surface, SDL_BLENDMODE_BLEND);
 
     using P = std::tuple<int, int>;
     const std::initializer_list<std::tuple<int, int> > positions[] = {
@@ -67,16 +77,17 @@ TTFSurface::create(const TTFFont& font, const std::string& text)
     int shadow_size = std::min(2, font.get_shadow_size());
     for (const auto& p : positions[shadow_size])
     {
-      SDL_Rect dstrect{std::get<0>(p) + 2, std::get<1>(p) + 2, text_surface->w, text_surface->h};
-      SDL_BlitSurface(text_surface.get(), nullptr,
+      SDL_Rect dstrect{std::get<0>(p) + 2, std::get<1>(p) + 2, text_surface.w, text_surface.h};
+      SDL_BlitSurface(&text_surface, nullptr,
                       target.get(), &dstrect);
     }
   }
 
+  if (decoration)
   { // outline
-    SDL_SetSurfaceAlphaMod(text_surface.get(), 255);
-    SDL_SetSurfaceColorMod(text_surface.get(), 0, 0, 0);
-    SDL_SetSurfaceBlendMode(text_surface.get(), SDL_BLENDMODE_BLEND);
+    SDL_SetSurfaceAlphaMod(&text_surface, 255);
+    SDL_SetSurfaceColorMod(&text_surface, 0, 0, 0);
+    SDL_SetSurfaceBlendMode(&text_surface, SDL_BLENDMODE_BLEND);
 
     using P = std::tuple<int, int>;
     const std::initializer_list<std::tuple<int, int> > positions[] = {
@@ -89,28 +100,28 @@ TTFSurface::create(const TTFFont& font, const std::string& text)
     int border = std::min(2, font.get_border());
     for (const auto& p : positions[border])
     {
-      SDL_Rect dstrect{std::get<0>(p), std::get<1>(p), text_surface->w, text_surface->h};
-      SDL_BlitSurface(text_surface.get(), nullptr,
+      SDL_Rect dstrect{std::get<0>(p), std::get<1>(p), text_surface.w, text_surface.h};
+      SDL_BlitSurface(&text_surface, nullptr,
                       target.get(), &dstrect);
     }
   }
 
+  if (core)
   { // white core
-    SDL_SetSurfaceAlphaMod(text_surface.get(), 255);
-    SDL_SetSurfaceColorMod(text_surface.get(), 255, 255, 255);
-    SDL_SetSurfaceBlendMode(text_surface.get(), SDL_BLENDMODE_BLEND);
+    SDL_SetSurfaceAlphaMod(&text_surface, 255);
+    SDL_SetSurfaceColorMod(&text_surface, 255, 255, 255);
+    SDL_SetSurfaceBlendMode(&text_surface, SDL_BLENDMODE_BLEND);
 
-    SDL_Rect dstrect{0, 0, text_surface->w, text_surface->h};
+    SDL_Rect dstrect{0, 0, text_surface.w, text_surface.h};
 
-    SDL_BlitSurface(text_surface.get(), nullptr, target.get(), &dstrect);
+    SDL_BlitSurface(&text_surface, nullptr, target.get(), &dstrect);
   }
 
 #if !SDL_VERSION_ATLEAST(2,0,5)
   target.reset(SDL_ConvertSurfaceFormat(target.get(), SDL_PIXELFORMAT_RGBA8888, 0));
 #endif
 
-  SurfacePtr result = Surface::from_texture(VideoSystem::current()->new_texture(*target));
-  return std::make_shared<TTFSurface>(result, Vector(0, 0));
+  return target;
 }
 
 TTFSurface::TTFSurface(const SurfacePtr& surface, const Vector& offset) :
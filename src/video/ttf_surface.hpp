@@ -21,6 +21,7 @@
 #include <string>
 
 #include "math/vector.hpp"
+#include "video/sdl_surface_ptr.hpp"
 #include "video/surface_ptr.hpp"
 
 class TTFFont;
@@ -34,6 +35,11 @@ class TTFSurface final
 public:
   static TTFSurfacePtr create(const TTFFont& font, const std::string& text);
 
+  /** Returns text_surface grown by the font's shadow and border, with
+      the shadow and outline if decoration is set and the white text
+      itself if core is set */
+  static SDLSurfacePtr render(const TTFFont& font, SDL_Surface& text_surface, bool decoration, bool core);
+
 public:
   TTFSurface(const SurfacePtr& surface, const Vector& offset);
 
@@ -21,9 +21,12 @@
 #include <sstream>
 #include <iostream>
 
+#include "math/rect.hpp"
 #include "supertux/globals.hpp"
+#include "util/log.hpp"
 #include "video/sdl_surface_ptr.hpp"
 #include "video/surface.hpp"
+#include "video/texture_atlas.hpp"
 #include "video/ttf_font.hpp"
 #include "video/ttf_surface.hpp"
 #include "video/video_system.hpp"
@@ -34,9 +37,24 @@ TTFSurfaceManager::CacheEntry::CacheEntry(const TTFSurfacePtr& s) :
 {
 }
 
+namespace {
+
+/** Glyphs are small, so a single page holds a few thousand of them */
+const int GLYPH_ATLAS_PAGE_SIZE = 1024;
+const int GLYPH_ATLAS_MAX_GLYPH_SIZE = 128;
+
+} // namespace
+
 TTFSurfaceManager::TTFSurfaceManager() :
   m_cache(),
-  m_cache_iter(m_cache.end())
+  m_cache_iter(m_cache.end()),
+  m_glyph_atlas(),
+  m_glyphs(),
+  m_glyph_pages()
+{
+}
+
+TTFSurfaceManager::~TTFSurfaceManager()
 {
 }
 
@@ -83,6 +101,94 @@ TTFSurfaceManager::get_cached_surface_width(const TTFFont& font,
   return entry.ttf_surface->get_width();
 }
 
+const TTFSurfaceManager::Glyph&
+TTFSurfaceManager::get_glyph(const TTFFont& font, uint32_t codepoint)
+{
+  auto key = std::make_tuple(static_cast<void*>(font.get_ttf_font()), codepoint);
+  auto it = m_glyphs.find(key);
+  if (it != m_glyphs.end())
+    return it->second;
+
+  Glyph& glyph = m_glyphs[key];
+  glyph.valid = false;
+  glyph.advance = 0.0f;
+
+  // SDL_ttf only renders glyphs from the basic multilingual plane
+  if (codepoint > 0xffff)
+    return glyph;
+
+  const Uint16 ch = static_cast<Uint16>(codepoint);
+  int minx, maxx, miny, maxy, advance;
+  if (TTF_GlyphMetrics(font.get_ttf_font(), ch, &minx, &maxx, &miny, &maxy, &advance) < 0)
+    return glyph;
+
+  glyph.advance = static_cast<float>(advance);
+
+  SDLSurfacePtr text_surface(TTF_RenderGlyph_Blended(font.get_ttf_font(), ch, SDL_Color{255, 255, 255, 255}));
+  if (!text_surface)
+  {
+    // nothing to draw, e.g. a zero width space
+    glyph.valid = true;
+    return glyph;
+  }
+
+  if (!m_glyph_atlas)
+  {
+    m_glyph_atlas.reset(new TextureAtlas(GLYPH_ATLAS_PAGE_SIZE, GLYPH_ATLAS_MAX_GLYPH_SIZE));
+  }
+
+  SDLSurfacePtr decoration = TTFSurface::render(font, *text_surface, true, false);
+  SDLSurfacePtr core = TTFSurface::render(font, *text_surface, false, true);
+  const Rect rect(0, 0, decoration->w, decoration->h);
+
+  Rect decoration_region;
+  Rect core_region;
+  TexturePtr decoration_page = m_glyph_atlas->add(*decoration, rect, decoration_region);
+  TexturePtr core_page = m_glyph_atlas->add(*core, rect, core_region);
+  if (!decoration_page || decoration_page != core_page)
+  {
+    // Very large glyphs, or a pair split over two pages, are left to
+    // the TTFSurface path
+    log_debug << "Couldn't pack glyph " << codepoint << " into the glyph atlas" << std::endl;
+    return glyph;
+  }
+
+  auto& page = m_glyph_pages[decoration_page.get()];
+  if (!page)
+  {
+    page = Surface::from_texture(decoration_page);
+  }
+
+  glyph.valid = true;
+  glyph.page = page;
+  glyph.decoration_rect = Rectf(decoration_region);
+  glyph.core_rect = Rectf(core_region);
+  return glyph;
+}
+
+void
+TTFSurfaceManager::forget_font(const TTFFont& font)
+{
+  void* ttf_font = font.get_ttf_font();
+
+  for (auto it = m_glyphs.begin(); it != m_glyphs.end();)
+  {
+    if (std::get<0>(it->first) == ttf_font)
+      it = m_glyphs.erase(it);
+    else
+      ++it;
+  }
+
+  for (auto it = m_cache.begin(); it != m_cache.end();)
+  {
+    if (std::get<0>(it->first) == ttf_font)
+      it = m_cache.erase(it);
+    else
+      ++it;
+  }
+  m_cache_iter = m_cache.end();
+}
+
 void
 TTFSurfaceManager::cache_cleanup_step()
 {
@@ -113,6 +219,11 @@ TTFSurfaceManager::print_debug_info(std::ostream& out)
     return accumulator + entry.second.ttf_surface->get_width() * entry.second.ttf_surface->get_height() * 4;
   });
   out << "TTFSurfaceManager.cache_size: " << m_cache.size() << "  " << cache_bytes / 1000 << "KB" << std::endl;
+  out << "TTFSurfaceManager.glyphs: " << m_glyphs.size() << std::endl;
+  if (m_glyph_atlas)
+  {
+    m_glyph_atlas->debug_print(out);
+  }
 }
 
 /* EOF */
@@ -19,26 +19,60 @@
 
 #include <tuple>
 #include <map>
+#include <memory>
+#include <stdint.h>
 #include <string>
 #include <iosfwd>
 
+#include "math/rectf.hpp"
 #include "util/currenton.hpp"
 #include "video/color.hpp"
 #include "video/surface_ptr.hpp"
 #include "video/ttf_surface.hpp"
 
+class Texture;
+class TextureAtlas;
 class TTFFont;
 
 class TTFSurfaceManager final : public Currenton<TTFSurfaceManager>
 {
+public:
+  /** A single character in the glyph atlas, the shadow and outline
+      are kept apart from the core so that whole strings can be drawn
+      with all shadows below all cores, like a TTFSurface */
+  struct Glyph
+  {
+    /** false if the glyph isn't available, strings containing it
+        have to be drawn as a TTFSurface */
+    bool valid;
+
+    /** the atlas page, nullptr for glyphs without pixels like spaces */
+    SurfacePtr page;
+
+    /** texture coordinates on page, both have the same size */
+    Rectf decoration_rect;
+    Rectf core_rect;
+
+    /** distance to the next glyph on the line */
+    float advance;
+  };
+
 public:
   TTFSurfaceManager();
+  ~TTFSurfaceManager();
 
   TTFSurfacePtr create_surface(const TTFFont& font, const std::string& text);
 
   // Returns -1 if there is no cached text surface
   int get_cached_surface_width(const TTFFont& font, const std::string& text);
 
+  /** Returns the glyph for codepoint, rendering it into the shared
+      glyph atlas on first use */
+  const Glyph& get_glyph(const TTFFont& font, uint32_t codepoint);
+
+  /** Drops all cached surfaces and glyphs of font */
+  void forget_font(const TTFFont& font);
+
   void print_debug_info(std::ostream& out);
 
 private:
@@ -60,6 +94,12 @@ private:
 
   std::map<Key, CacheEntry>::iterator m_cache_iter;
 
+  std::unique_ptr<TextureAtlas> m_glyph_atlas;
+  std::map<std::tuple<void*, uint32_t>, Glyph> m_glyphs;
+
+  /** Surfaces covering the whole atlas pages */
+  std::map<const Texture*, SurfacePtr> m_glyph_pages;
+
 private:
   TTFSurfaceManager(const TTFSurfaceManager&) = delete;
   TTFSurfaceManager& operator=(const TTFSurfaceManager&) = delete;
@@ -17,6 +17,7 @@
 #ifndef HEADER_SUPERTUX_VIDEO_VIDEO_SYSTEM_HPP
 #define HEADER_SUPERTUX_VIDEO_VIDEO_SYSTEM_HPP
 
+#include <memory>
 #include <string>
 #include <SDL.h>
 
@@ -62,6 +63,10 @@ public:
 
   virtual TexturePtr new_texture(const SDL_Surface& image, const Sampler& sampler = Sampler()) = 0;
 
+  /** Creates an offscreen renderer with a logical size of size that
+      renders into a texture scaled down by downscale */
+  virtual std::unique_ptr<Renderer> new_texture_renderer(const Size& size, int downscale) = 0;
+
   virtual const Viewport& get_viewport() const = 0;
   virtual void apply_config() = 0;
   virtual void flip() = 0;
@@ -1,6 +1,5 @@
 //  SuperTux
-//  Copyright (C) 2006 Matthias Braun <matze@braunis.de>
-//                2018 Ingo Ruhnke <grumbel@gmail.com>
+//  Copyright (C) 2020 SuperTux Devel Team
 //
 //  This program is free software: you can redistribute it and/or modify
 //  it under the terms of the GNU General Public License as published by
@@ -15,31 +14,31 @@
 //  You should have received a copy of the GNU General Public License
 //  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
-#include "util/timelog.hpp"
 
-#include <iostream>
+#include <gtest/gtest.h>
 
-#include "util/log.hpp"
+#include "sprite/action_id.hpp"
 
-Timelog::Timelog() :
-  m_last_ticks(0),
-  m_last_component(nullptr)
+TEST(ActionIdTest, intern)
 {
-}
+  const ActionId walk_left("walk-left");
+  const ActionId walk_right("walk-right");
 
-void
-Timelog::log(const char* component)
-{
-  Uint32 current_ticks = SDL_GetTicks();
+  ASSERT_TRUE(walk_left.is_valid());
+  ASSERT_NE(walk_left, walk_right);
+  ASSERT_EQ(walk_left, ActionId("walk-left"));
+  ASSERT_EQ(walk_left.get_index(), ActionId(std::string("walk") + "-left").get_index());
 
-  if (m_last_component != nullptr) {
-    log_info << "Component '" << m_last_component <<  "' finished after "
-             << (current_ticks - m_last_ticks) / 1000.0 << " seconds"
-             << std::endl;
-  }
+  ASSERT_EQ("walk-left", walk_left.get_name());
+  ASSERT_EQ("walk-right", walk_right.get_name());
+}
 
-  m_last_ticks = current_ticks;
-  m_last_component = component;
+TEST(ActionIdTest, invalid)
+{
+  const ActionId id;
+  ASSERT_FALSE(id.is_valid());
+  ASSERT_EQ("", id.get_name());
+  ASSERT_NE(id, ActionId("normal"));
 }
 
 /* EOF */
@@ -0,0 +1,93 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+
+#include "supertux/benchmark.hpp"
+
+TEST(BenchmarkTest, percentile)
+{
+  Benchmark benchmark;
+  for (int i = 100; i >= 1; --i) {
+    benchmark.add_time(Benchmark::STEP, static_cast<float>(i));
+    benchmark.end_step();
+  }
+
+  ASSERT_EQ(100, benchmark.get_step_count());
+  ASSERT_EQ(1.0f, benchmark.get_percentile(Benchmark::STEP, 0.0f));
+  ASSERT_EQ(50.0f, benchmark.get_percentile(Benchmark::STEP, 50.0f));
+  ASSERT_EQ(90.0f, benchmark.get_percentile(Benchmark::STEP, 90.0f));
+  ASSERT_EQ(100.0f, benchmark.get_percentile(Benchmark::STEP, 100.0f));
+  ASSERT_EQ(50.5f, benchmark.get_mean(Benchmark::STEP));
+  ASSERT_EQ(0.0f, benchmark.get_percentile(Benchmark::DRAW, 99.0f));
+}
+
+TEST(BenchmarkTest, accumulate_step)
+{
+  Benchmark benchmark;
+  benchmark.add_time(Benchmark::SCRIPTING, 1.0f);
+  benchmark.add_time(Benchmark::SCRIPTING, 2.0f);
+  benchmark.end_step();
+  benchmark.end_step();
+
+  ASSERT_EQ(2, benchmark.get_step_count());
+  ASSERT_EQ(3.0f, benchmark.get_percentile(Benchmark::SCRIPTING, 100.0f));
+  ASSERT_EQ(0.0f, benchmark.get_percentile(Benchmark::SCRIPTING, 50.0f));
+}
+
+TEST(BenchmarkTest, add_frame)
+{
+  Profiler::Frame frame;
+  frame.start = 0;
+  frame.end = 10000000;
+  frame.events = {
+    Profiler::Event{"Sector::update", 0, 1000000, 6000000},
+    Profiler::Event{"CollisionSystem::update", 1, 2000000, 3000000},
+    Profiler::Event{"CollisionSystem::update", 1, 4000000, 5000000},
+    Profiler::Event{"unrelated", 0, 6000000, 9000000}
+  };
+
+  Benchmark benchmark;
+  benchmark.add_frame(frame);
+
+  ASSERT_EQ(1, benchmark.get_step_count());
+  ASSERT_EQ(10.0f, benchmark.get_mean(Benchmark::STEP));
+  ASSERT_EQ(5.0f, benchmark.get_mean(Benchmark::SECTOR_UPDATE));
+  ASSERT_EQ(2.0f, benchmark.get_mean(Benchmark::COLLISION));
+  ASSERT_EQ(0.0f, benchmark.get_mean(Benchmark::DRAW));
+}
+
+TEST(BenchmarkTest, add_frame_scripting)
+{
+  Profiler::Frame frame;
+  frame.start = 0;
+  frame.end = 10000000;
+  frame.events = {
+    Profiler::Event{"SquirrelVirtualMachine::update", 0, 0, 1000000},
+    Profiler::Event{"Sector::update", 0, 1000000, 6000000},
+    Profiler::Event{"SquirrelEnvironment::update", 1, 2000000, 4000000},
+    Profiler::Event{"SquirrelEnvironment::run_script", 2, 2500000, 3000000},
+    Profiler::Event{"SquirrelThreadQueue::wakeup", 0, 7000000, 8000000}
+  };
+
+  Benchmark benchmark;
+  benchmark.add_frame(frame);
+
+  ASSERT_EQ(5.0f, benchmark.get_mean(Benchmark::SECTOR_UPDATE));
+  ASSERT_EQ(4.0f, benchmark.get_mean(Benchmark::SCRIPTING));
+}
+
+/* EOF */
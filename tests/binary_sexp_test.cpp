@@ -0,0 +1,66 @@
+//  SuperTux
+//  Copyright (C) 2015 Ingo Ruhnke <grumbel@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+
+#include <sexp/parser.hpp>
+#include <sstream>
+#include <stdexcept>
+
+#include "util/binary_sexp.hpp"
+
+namespace {
+
+sexp::Value roundtrip(const sexp::Value& sx)
+{
+  std::ostringstream out;
+  binary_sexp::write(out, sx);
+  const std::string data = out.str();
+  return binary_sexp::read(data.data(), data.size());
+}
+
+} // namespace
+
+TEST(BinarySexpTest, roundtrip)
+{
+  const std::string text =
+    "(supertux-level\n"
+    "  (version 3)\n"
+    "  (name (_ \"Hello World\"))\n"
+    "  (sector\n"
+    "    (gravity 10.5)\n"
+    "    (tilemap (solid #t) (width 5) (height 2)\n"
+    "      (tiles 0 1 2 3 -4 5 6 7 8 2147483647))\n"
+    "    (spawnpoint (name \"main\") (x 32) (y 64))\n"
+    "    (short 1 2 3)))\n";
+
+  const sexp::Value sx = sexp::Parser::from_string(text, sexp::Parser::USE_ARRAYS);
+  ASSERT_EQ(sx.str(), roundtrip(sx).str());
+}
+
+TEST(BinarySexpTest, malformed)
+{
+  const sexp::Value sx = sexp::Parser::from_string("(tiles 1 2 3 4 5 6)", sexp::Parser::USE_ARRAYS);
+  std::ostringstream out;
+  binary_sexp::write(out, sx);
+  const std::string data = out.str();
+
+  ASSERT_THROW(binary_sexp::read(data.data(), data.size() - 1), std::runtime_error);
+  ASSERT_THROW(binary_sexp::read(data.data(), 0), std::runtime_error);
+  ASSERT_THROW(binary_sexp::read((data + "x").data(), data.size() + 1), std::runtime_error);
+}
+
+/* EOF */
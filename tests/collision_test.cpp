@@ -17,6 +17,7 @@
 #include <gtest/gtest.h>
 
 #include "collision/collision.hpp"
+#include "math/aatriangle.hpp"
 #include "math/rectf.hpp"
 
 TEST(collisionTest, intersects_test)
@@ -47,4 +48,39 @@ TEST(collisionTest, intersects_test)
     ASSERT_EQ(true, collision::intersects(r9, r10));
 }
 
+TEST(collisionTest, clip_line_test)
+{
+    Rectf rect(0.0, 0.0, 10.0, 10.0);
+
+    Vector start(-5.0, 5.0);
+    Vector end(15.0, 5.0);
+    ASSERT_EQ(true, collision::clip_line(rect, start, end));
+    ASSERT_EQ(Vector(0.0, 5.0), start);
+    ASSERT_EQ(Vector(10.0, 5.0), end);
+
+    Vector start2(-5.0, -5.0);
+    Vector end2(-1.0, 20.0);
+    ASSERT_EQ(false, collision::clip_line(rect, start2, end2));
+}
+
+TEST(collisionTest, intersects_line_aatriangle_test)
+{
+    // solid in the lower left half
+    AATriangle triangle(Rectf(0.0, 0.0, 32.0, 32.0), AATriangle::SOUTHWEST);
+
+    // passes through the empty upper right half
+    ASSERT_EQ(false, collision::intersects_line(triangle, Vector(10.0, -5.0), Vector(37.0, 22.0)));
+
+    // passes through the solid lower left half
+    ASSERT_EQ(true, collision::intersects_line(triangle, Vector(-5.0, 10.0), Vector(22.0, 37.0)));
+
+    // misses the bbox completely
+    ASSERT_EQ(false, collision::intersects_line(triangle, Vector(-5.0, -5.0), Vector(-5.0, 50.0)));
+
+    // solid in the upper right half
+    AATriangle triangle2(Rectf(0.0, 0.0, 32.0, 32.0), AATriangle::NORTHEAST);
+    ASSERT_EQ(true, collision::intersects_line(triangle2, Vector(10.0, -5.0), Vector(37.0, 22.0)));
+    ASSERT_EQ(false, collision::intersects_line(triangle2, Vector(-5.0, 10.0), Vector(22.0, 37.0)));
+}
+
 /* EOF */
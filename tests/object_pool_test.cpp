@@ -0,0 +1,69 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+
+#include "util/object_pool.hpp"
+
+namespace {
+
+class PooledObject final : public Pooled<PooledObject>
+{
+public:
+  PooledObject() : m_data() {}
+
+private:
+  double m_data[4];
+};
+
+} // namespace
+
+TEST(ObjectPoolTest, recycle)
+{
+  const ObjectPoolStats& stats = PooledObject::get_pool_stats();
+  ASSERT_EQ(0, stats.allocations);
+
+  auto a = std::make_unique<PooledObject>();
+  auto b = std::make_unique<PooledObject>();
+  ASSERT_EQ(2, stats.allocations);
+  ASSERT_EQ(2, stats.live);
+  ASSERT_EQ(0, stats.reuses);
+
+  PooledObject* const old_a = a.get();
+  a.reset();
+  ASSERT_EQ(1, stats.live);
+  ASSERT_EQ(1, stats.free);
+
+  a = std::make_unique<PooledObject>();
+  ASSERT_EQ(old_a, a.get());
+  ASSERT_EQ(1, stats.reuses);
+  ASSERT_EQ(0, stats.free);
+  ASSERT_EQ(2, stats.live);
+}
+
+TEST(ObjectPoolTest, registry)
+{
+  const ObjectPoolStats& stats = PooledObject::get_pool_stats();
+  const auto& all = ObjectPoolStats::get_all();
+  ASSERT_NE(all.end(), std::find(all.begin(), all.end(), &stats));
+  ASSERT_NE(std::string::npos, stats.get_name().find("PooledObject"));
+}
+
+/* EOF */
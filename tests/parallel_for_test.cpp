@@ -0,0 +1,85 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+#include "util/command_queue.hpp"
+#include "util/parallel_for.hpp"
+
+TEST(ParallelForTest, every_index_once)
+{
+  ParallelFor parallel_for(3);
+  ASSERT_EQ(4, parallel_for.get_thread_count());
+
+  std::vector<std::atomic<int> > calls(1000);
+  for (auto& call : calls) {
+    call = 0;
+  }
+
+  parallel_for.run(calls.size(), [&calls](size_t i) {
+      // make some iterations expensive, so that threads steal
+      if (i % 97 == 0) {
+        volatile int sink = 0;
+        for (int j = 0; j < 100000; ++j) sink = sink + j;
+      }
+      calls[i] += 1;
+    });
+
+  for (const auto& call : calls) {
+    ASSERT_EQ(1, call.load());
+  }
+
+  parallel_for.run(0, [](size_t) { FAIL(); });
+}
+
+TEST(ParallelForTest, commands_in_index_order)
+{
+  ParallelFor parallel_for(3);
+  ASSERT_EQ(nullptr, CommandQueue::current());
+
+  std::vector<size_t> order;
+  parallel_for.run(500, [&order](size_t i) {
+      ASSERT_NE(nullptr, CommandQueue::current());
+      if (i % 3 == 0) {
+        CommandQueue::current()->push([&order, i]{ order.push_back(i); });
+        CommandQueue::current()->push([&order, i]{ order.push_back(i + 1); });
+      }
+    });
+
+  ASSERT_EQ(nullptr, CommandQueue::current());
+
+  std::vector<size_t> expected;
+  for (size_t i = 0; i < 500; i += 3) {
+    expected.push_back(i);
+    expected.push_back(i + 1);
+  }
+  ASSERT_EQ(expected, order);
+}
+
+TEST(ParallelForTest, no_threads)
+{
+  ParallelFor parallel_for(0);
+
+  std::vector<size_t> order;
+  parallel_for.run(10, [&order](size_t i) { order.push_back(i); });
+  ASSERT_EQ(std::vector<size_t>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), order);
+}
+
+/* EOF */
@@ -0,0 +1,111 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <thread>
+
+#include "util/profiler.hpp"
+
+TEST(ProfilerTest, zone_stats)
+{
+  Profiler profiler;
+
+  for (int frame = 0; frame < 4; ++frame)
+  {
+    profiler.begin_frame();
+    const int update = profiler.begin_zone("update");
+    for (int i = 0; i < 2; ++i)
+    {
+      profiler.end_zone(profiler.begin_zone("collision"));
+    }
+    profiler.end_zone(update);
+    profiler.end_zone(profiler.begin_zone("draw"));
+    profiler.end_frame();
+  }
+
+  ASSERT_EQ(4, profiler.get_frame_count());
+
+  const auto stats = profiler.get_zone_stats();
+  ASSERT_EQ(3u, stats.size());
+  ASSERT_STREQ("update", stats[0].name);
+  ASSERT_EQ(0, stats[0].depth);
+  ASSERT_EQ(1.0f, stats[0].calls);
+  ASSERT_STREQ("collision", stats[1].name);
+  ASSERT_EQ(1, stats[1].depth);
+  ASSERT_EQ(2.0f, stats[1].calls);
+  ASSERT_STREQ("draw", stats[2].name);
+  ASSERT_EQ(0, stats[2].depth);
+  ASSERT_LE(stats[1].avg_msec, stats[0].avg_msec);
+}
+
+TEST(ProfilerTest, frame_history)
+{
+  Profiler profiler;
+
+  for (int frame = 0; frame < Profiler::FRAME_HISTORY + 10; ++frame)
+  {
+    profiler.begin_frame();
+    profiler.end_zone(profiler.begin_zone("zone"));
+    profiler.end_frame();
+  }
+
+  ASSERT_EQ(Profiler::FRAME_HISTORY, profiler.get_frame_count());
+  ASSERT_EQ(1.0f, profiler.get_zone_stats()[0].calls);
+}
+
+TEST(ProfilerTest, chrome_trace)
+{
+  Profiler profiler;
+  profiler.begin_frame();
+  profiler.end_zone(profiler.begin_zone("zone \"quoted\""));
+  profiler.end_frame();
+
+  std::ostringstream out;
+  profiler.write_chrome_trace(out);
+  const std::string trace = out.str();
+
+  ASSERT_EQ(0u, trace.find("{\"traceEvents\":["));
+  ASSERT_NE(std::string::npos, trace.find("\"name\":\"Frame\""));
+  ASSERT_NE(std::string::npos, trace.find("\"name\":\"zone \\\"quoted\\\"\""));
+  ASSERT_NE(std::string::npos, trace.find("\"ph\":\"X\""));
+}
+
+TEST(ProfilerTest, other_threads)
+{
+  Profiler profiler;
+
+  // zones of a thread that touches the profiler before the frames
+  // start are not recorded
+  std::thread([&profiler]{
+      ASSERT_EQ(-1, profiler.begin_zone("worker"));
+    }).join();
+
+  profiler.begin_frame();
+  std::thread([&profiler]{
+      ASSERT_EQ(-1, profiler.begin_zone("worker"));
+    }).join();
+  profiler.end_zone(profiler.begin_zone("main"));
+  profiler.end_frame();
+
+  const auto stats = profiler.get_zone_stats();
+  ASSERT_EQ(1u, stats.size());
+  ASSERT_STREQ("main", stats[0].name);
+  ASSERT_EQ(profiler.get_last_frame()->events.size(), 1u);
+}
+
+/* EOF */
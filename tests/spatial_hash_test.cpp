@@ -0,0 +1,113 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "collision/collision.hpp"
+#include "collision/spatial_hash.hpp"
+#include "math/random.hpp"
+#include "math/rectf.hpp"
+
+TEST(SpatialHashTest, query)
+{
+  SpatialHash<int> grid(32.0f);
+  grid.insert(1, Rectf(0, 0, 16, 16));
+  grid.insert(2, Rectf(-100, -100, 100, 100));
+  grid.insert(3, Rectf(500, 500, 520, 520));
+
+  std::vector<int> result;
+  grid.query(Rectf(8, 8, 40, 40), result);
+  std::sort(result.begin(), result.end());
+  ASSERT_EQ(std::vector<int>({1, 2}), result);
+
+  result.clear();
+  grid.clear();
+  grid.query(Rectf(8, 8, 40, 40), result);
+  ASSERT_TRUE(result.empty());
+}
+
+TEST(SpatialHashTest, add_remove_update)
+{
+  SpatialHash<int> grid(32.0f);
+  grid.add(1, Rectf(0, 0, 16, 16));
+  grid.add(2, Rectf(40, 0, 60, 16));
+
+  std::vector<int> result;
+  grid.query(Rectf(0, 0, 10, 10), result);
+  ASSERT_EQ(std::vector<int>({1}), result);
+
+  grid.update(1, Rectf(200, 200, 216, 216));
+  result.clear();
+  grid.query(Rectf(0, 0, 10, 10), result);
+  ASSERT_TRUE(result.empty());
+
+  result.clear();
+  grid.query(Rectf(190, 190, 300, 300), result);
+  ASSERT_EQ(std::vector<int>({1}), result);
+
+  grid.remove(1);
+  result.clear();
+  grid.query(Rectf(190, 190, 300, 300), result);
+  ASSERT_TRUE(result.empty());
+
+  grid.add(1, Rectf(0, 0, 100, 100));
+  result.clear();
+  grid.query(Rectf(0, 0, 100, 100), result);
+  std::sort(result.begin(), result.end());
+  ASSERT_EQ(std::vector<int>({1, 2}), result);
+}
+
+TEST(SpatialHashTest, pairs_match_bruteforce)
+{
+  Random rng;
+  rng.seed(12345);
+
+  std::vector<Rectf> rects;
+  for (int i = 0; i < 300; ++i) {
+    const float x = rng.randf(-1000.0f, 1000.0f);
+    const float y = rng.randf(-1000.0f, 1000.0f);
+    rects.push_back(Rectf(x, y, x + rng.randf(1.0f, 200.0f), y + rng.randf(1.0f, 200.0f)));
+  }
+
+  SpatialHash<size_t> grid(64.0f);
+  for (size_t i = 0; i < rects.size(); ++i) {
+    grid.insert(i, rects[i]);
+  }
+
+  std::vector<std::pair<size_t, size_t> > candidates;
+  grid.for_each_pair([&candidates](size_t a, size_t b) {
+      candidates.push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+    });
+  std::sort(candidates.begin(), candidates.end());
+
+  // every pair is reported only once
+  ASSERT_TRUE(std::adjacent_find(candidates.begin(), candidates.end()) == candidates.end());
+
+  // every intersecting pair is among the candidates
+  for (size_t i = 0; i < rects.size(); ++i) {
+    for (size_t j = i + 1; j < rects.size(); ++j) {
+      if (collision::intersects(rects[i], rects[j])) {
+        ASSERT_TRUE(std::binary_search(candidates.begin(), candidates.end(), std::make_pair(i, j)));
+      }
+    }
+  }
+}
+
+/* EOF */
@@ -0,0 +1,77 @@
+//  SuperTux
+//  Copyright (C) 2015 Ingo Ruhnke <grumbel@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "util/spsc_ring.hpp"
+
+TEST(SPSCRingTest, single_thread)
+{
+  SPSCRing<int> ring(std::vector<int>(3));
+  ASSERT_EQ(nullptr, ring.read_slot());
+
+  for (int i = 0; i < 3; ++i) {
+    int* slot = ring.write_slot();
+    ASSERT_NE(nullptr, slot);
+    *slot = i;
+    ring.commit_write();
+  }
+  ASSERT_EQ(nullptr, ring.write_slot());
+
+  ASSERT_EQ(0, *ring.read_slot());
+  ring.commit_read();
+  ASSERT_NE(nullptr, ring.write_slot());
+
+  ring.clear();
+  ASSERT_EQ(nullptr, ring.read_slot());
+}
+
+TEST(SPSCRingTest, two_threads)
+{
+  const int count = 100000;
+  SPSCRing<int> ring(std::vector<int>(8));
+
+  std::thread producer([&ring, count]{
+      for (int i = 0; i < count; ++i) {
+        int* slot;
+        while (!(slot = ring.write_slot())) {
+          std::this_thread::yield();
+        }
+        *slot = i;
+        ring.commit_write();
+      }
+    });
+
+  std::vector<int> result;
+  while (static_cast<int>(result.size()) < count) {
+    if (int* slot = ring.read_slot()) {
+      result.push_back(*slot);
+      ring.commit_read();
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+
+  for (int i = 0; i < count; ++i) {
+    ASSERT_EQ(i, result[i]);
+  }
+}
+
+/* EOF */
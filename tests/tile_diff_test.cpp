@@ -0,0 +1,91 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <gtest/gtest.h>
+
+#include "editor/tile_diff.hpp"
+
+namespace {
+
+/** 3x2 tilemap */
+std::vector<uint32_t> make_tiles()
+{
+  return { 1, 2, 3,
+           4, 5, 6 };
+}
+
+/** writes tile into tiles the way the editor does */
+void write(TileDiff& diff, std::vector<uint32_t>& tiles, int x, int y, uint32_t tile)
+{
+  diff.record(x, y, tiles[y * 3 + x]);
+  tiles[y * 3 + x] = tile;
+}
+
+} // namespace
+
+TEST(TileDiffTest, revert_and_reapply)
+{
+  const std::vector<uint32_t> before = make_tiles();
+  std::vector<uint32_t> tiles = before;
+
+  TileDiff diff(3);
+  write(diff, tiles, 0, 0, 7);
+  write(diff, tiles, 2, 1, 8);
+  diff.finish(tiles);
+  const std::vector<uint32_t> after = tiles;
+
+  ASSERT_EQ(2u, diff.get_cells().size());
+
+  diff.apply(tiles, false);
+  ASSERT_EQ(before, tiles);
+
+  diff.apply(tiles, true);
+  ASSERT_EQ(after, tiles);
+}
+
+TEST(TileDiffTest, first_write_keeps_old_tile)
+{
+  const std::vector<uint32_t> before = make_tiles();
+  std::vector<uint32_t> tiles = before;
+
+  TileDiff diff(3);
+  write(diff, tiles, 1, 0, 7);
+  write(diff, tiles, 1, 0, 8);
+  diff.finish(tiles);
+
+  ASSERT_EQ(std::vector<uint32_t>{1}, diff.get_cells());
+  ASSERT_EQ(std::vector<uint32_t>{2}, diff.get_tiles(false));
+  ASSERT_EQ(std::vector<uint32_t>{8}, diff.get_tiles(true));
+
+  diff.apply(tiles, false);
+  ASSERT_EQ(before, tiles);
+}
+
+TEST(TileDiffTest, unchanged_cells_are_dropped)
+{
+  std::vector<uint32_t> tiles = make_tiles();
+
+  TileDiff diff(3);
+  write(diff, tiles, 0, 1, 9);
+  write(diff, tiles, 0, 1, 4);
+  write(diff, tiles, 1, 1, 5);
+  diff.finish(tiles);
+
+  ASSERT_TRUE(diff.empty());
+}
+
+/* EOF */
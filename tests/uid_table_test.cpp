@@ -0,0 +1,87 @@
+//  SuperTux
+//  Copyright (C) 2020 SuperTux Devel Team
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <gtest/gtest.h>
+
+#include "util/uid_table.hpp"
+
+TEST(UIDTableTest, insert_get_erase)
+{
+  UIDTable<int> table;
+  const UID a = table.insert(1);
+  const UID b = table.insert(2);
+
+  ASSERT_TRUE(a);
+  ASSERT_NE(a, b);
+  ASSERT_EQ(1, table.get(a));
+  ASSERT_EQ(2, table.get(b));
+  ASSERT_EQ(2u, table.size());
+
+  table.erase(a);
+  ASSERT_EQ(0, table.get(a));
+  ASSERT_EQ(2, table.get(b));
+  ASSERT_EQ(1u, table.size());
+
+  // erasing twice is harmless
+  table.erase(a);
+  ASSERT_EQ(1u, table.size());
+}
+
+TEST(UIDTableTest, stale)
+{
+  UIDTable<int> table;
+  const UID a = table.insert(1);
+  table.erase(a);
+
+  // the slot is reused, but the old UID must not find the new value
+  const UID c = table.insert(3);
+  ASSERT_NE(a, c);
+  ASSERT_EQ(0, table.get(a));
+  ASSERT_EQ(3, table.get(c));
+}
+
+TEST(UIDTableTest, retire)
+{
+  UIDTable<int> table;
+  UID first = table.insert(1);
+  std::vector<UID> uids = { first };
+  for (uint32_t i = 0; i < UIDTable<int>::GENERATION_MASK + 4; ++i) {
+    table.erase(uids.back());
+    uids.push_back(table.insert(static_cast<int>(i) + 2));
+  }
+
+  // every UID ever handed out is unique and only the last one is live
+  for (size_t i = 0; i < uids.size(); ++i) {
+    for (size_t j = i + 1; j < uids.size(); ++j) {
+      ASSERT_NE(uids[i], uids[j]);
+    }
+    ASSERT_EQ(i + 1 == uids.size() ? static_cast<int>(i) + 1 : 0, table.get(uids[i]));
+  }
+}
+
+TEST(UIDTableTest, other_table)
+{
+  UIDTable<int> table1;
+  UIDTable<int> table2;
+  const UID a = table1.insert(1);
+  table2.insert(2);
+
+  ASSERT_EQ(0, table2.get(a));
+  ASSERT_EQ(0, table1.get(UID()));
+}
+
+/* EOF */
@@ -0,0 +1,54 @@
+//  SuperTux
+//  Copyright (C) 2015 Ingo Ruhnke <grumbel@gmail.com>
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+#include "util/worker_pool.hpp"
+
+TEST(WorkerPoolTest, wait)
+{
+  std::atomic<int> count(0);
+
+  WorkerPool pool(3);
+  for (int i = 0; i < 100; ++i) {
+    pool.add([&count]{ count += 1; });
+  }
+  pool.wait();
+  ASSERT_EQ(100, count.load());
+
+  pool.add([&count]{ count += 1; });
+  pool.wait();
+  ASSERT_EQ(101, count.load());
+}
+
+TEST(WorkerPoolTest, destroy)
+{
+  std::atomic<int> count(0);
+  {
+    WorkerPool pool(2);
+    for (int i = 0; i < 10; ++i) {
+      pool.add([&count]{ count += 1; });
+    }
+  }
+  ASSERT_LE(count.load(), 10);
+
+  // a pool without jobs shuts down as well
+  WorkerPool idle(WorkerPool::get_default_thread_count());
+}
+
+/* EOF */